@@ -62,6 +62,7 @@ void    gpio_func_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number, uint8_t pi
 void    gpio_type_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number, uint8_t pin_type);
 void    gpio_speed_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number, uint8_t pin_speed);
 void    gpio_pupd_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number, uint8_t pin_pupd);
+void    gpio_af_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number, uint8_t pin_af);
 void    gpio_set(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number);
 void    gpio_clear(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number);
 void    gpio_gen_output_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number);
@@ -34,14 +34,42 @@
 #define BUTTON_MANUAL GPIOC,3
 #define BUTTON_LED GPIOC,2
 
+#ifndef BUTTONS_SCAN
+#define BUTTONS_SCAN 0 //Build with -DBUTTONS_SCAN=1 to debounce by scanning GPIOC instead of one EXTI line per button
+#endif
+
+#define BUTTONS_PORT GPIOC       //Every button must be on this port
+#define BUTTONS_SCAN_HZ 1000UL   //IDR sample rate, timer 6. A press or release settles in 4 samples
+#define BUTTONS_PIN_OF(port, pin) (pin)
+#define BUTTONS_PIN(button) BUTTONS_PIN_OF(button) //Pin number of a BUTTON_x port,pin pair
+
 #include <stdint.h>
 #include "stm32f4xx.h"
 #include "stm32f410rx.h"
 #include "base_gpio_drivers.h"
+#include "debounce.h"
 
 ////////////////////////////////////////////////////////remove
 #include "led.h"
 #include "uart.h"
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+//Buttons on an EXTI line, each one has its own debouncer
+typedef enum e_button_tag
+{
+   button_mode,
+   button_auto,
+   button_led,
+   button_manual,  //Drives the magnet straight from its edges while in manual, see states_manual_edge
+   max_button
+
+} e_button;
+
+
 /*
 ****************************************************
 ******* Public Functions Defined in buttons.c **********
@@ -51,17 +79,15 @@ void button_manual_init(void);
 uint8_t button_manual_status(void);
 
 void button_mode_init(void);
-uint8_t button_mode_status(void);
-void button_mode_reset(void);
-
 void button_auto_init(void);
-uint8_t button_auto_status(void);
-void button_auto_reset(void);
+void button_led_init(void);
 
+void button_set_debounce_us(uint32_t tmp_window_us);
+const s_debounce * button_get_debounce(e_button tmp_button);
+void button_reset_debounce_counts(void);
 
-void button_led_init(void);
-uint8_t button_led_status(void);
-void button_led_reset(void);
+void button_scan_init(void);
+void TIM6_DAC_IRQHandler(void);
 
 
 
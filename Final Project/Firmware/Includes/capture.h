@@ -0,0 +1,80 @@
+/** @file capture.h
+*
+* @brief  This file contains the timer 5 input capture service, period and duty of an external signal
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef CAPTURE_H
+#define CAPTURE_H
+
+#define CAPTURE_RING_SIZE 128U          //Edges per ring, must be a power of two
+#define CAPTURE_POLL_MS 5UL             //Rings are drained this often, so edges up to ~25kHz
+#define CAPTURE_AVG_SHIFT 4U            //Rolling averages move 1/16 of the way per period
+#define CAPTURE_FILTER 3UL              //IC1F/IC2F, 8 timer clocks of a stable level per edge
+#define CAPTURE_AF_TIM5 2U              //TIM5 CH1 on PA0 is alternate function 2
+#define CAPTURE_PIN GPIOA, 0
+#define CAPTURE_DMA_CHSEL_TIM5 (6ul << 25) //DMA1 stream 2 is TIM5 CH1 and stream 4 is TIM5 CH2, both channel 6
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "stm32f410rx.h"
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+//Periods in timer 5 counts, 10ns each while it runs unprescaled
+typedef struct s_capture_stats_tag
+{
+   uint32_t periods;          //Rising to rising periods measured since the last reset
+   uint32_t last_period;
+   uint32_t min_period;
+   uint32_t max_period;
+   uint32_t avg_period;       //Rolling average
+   uint16_t last_duty;        //High time, permille of the period
+   uint16_t avg_duty;
+   uint32_t overruns;         //Polls that found a ring lapped, edges were lost
+
+} s_capture_stats;
+
+
+/*
+****************************************************
+****** Public Functions Defined in capture.c ******
+****************************************************
+*/
+void capture_init(void);
+void capture_start(void);
+void capture_stop(void);
+uint8_t capture_is_running(void);
+void capture_reset(void);
+void capture_get_stats(s_capture_stats * p_stats);
+uint32_t capture_get_mhz(void);
+
+
+#endif /* CAPTURE_H */
+
+/* end of file */
@@ -6,7 +6,6 @@
 #define CONSOLE_H
 
 #include <stdint.h>
-#include "base_gpio_drivers.h"
 
 // User configuration
 #define CONSOLE_PROMPT			("> ")
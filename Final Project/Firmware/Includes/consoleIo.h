@@ -4,7 +4,12 @@
 #define CONSOLE_IO_H
 
 #include <stdint.h>
+
+// Define CONSOLE_IO_HOST to build the console against the stdin/stdout backend
+// in consoleIoHost.c instead of USART1. Everything above this layer is portable.
+#ifndef CONSOLE_IO_HOST
 #include "uart.h"
+#endif // CONSOLE_IO_HOST
 
 typedef enum {CONSOLE_SUCCESS = 0u, CONSOLE_ERROR = 1u } eConsoleError;
 
@@ -0,0 +1,95 @@
+/** @file debounce.h
+*
+* @brief  This file contains a timestamp based edge debouncer.
+*         It only does arithmetic on the values it is handed, so edge trains can be fed to it off target.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#define DEBOUNCE_WINDOW_US 20000UL   //Default quiet time a line needs before an edge counts
+#define DEBOUNCE_MAX_WINDOW_US 1000000UL
+
+#include <stdint.h>
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef enum e_debounce_edge_tag
+{
+   debounce_none,    //Bounce, or a glitch that left the level where it was
+   debounce_press,
+   debounce_release,
+   max_debounce_edge
+
+} e_debounce_edge;
+
+
+//One per input. Must start out zeroed (static storage already is) or go through debounce_init.
+typedef struct s_debounce_tag
+{
+   uint32_t window_us;
+   uint32_t last_edge_us;   //Every edge moves this, accepted or not, so a bounce burst keeps the line locked
+   uint32_t accepted;
+   uint32_t rejected;
+   uint8_t level;           //Debounced level, 1 is pressed
+   uint8_t has_edge;        //0 until the first edge, so the first one is never held against last_edge_us
+
+} s_debounce;
+
+
+//Bit-sliced debouncer for up to 16 inputs sampled together, e.g. a whole GPIO IDR. Every input has a
+//2-bit counter, spread across count0/count1, and changes state after 4 samples in a row disagree with it.
+typedef struct s_debounce_vertical_tag
+{
+   uint16_t state;   //Debounced levels, one bit per input
+   uint16_t count0;  //Low bit of every input's counter
+   uint16_t count1;  //High bit of every input's counter
+
+} s_debounce_vertical;
+
+
+/*
+****************************************************
+****** Public Functions Defined in debounce.c ******
+****************************************************
+*/
+void debounce_init(s_debounce * p_debounce, uint32_t tmp_window_us, uint8_t tmp_level);
+e_debounce_edge debounce_edge(s_debounce * p_debounce, uint32_t tmp_now_us, uint8_t tmp_level);
+e_debounce_edge debounce_settle(s_debounce * p_debounce, uint8_t tmp_level);
+void debounce_set_window(s_debounce * p_debounce, uint32_t tmp_window_us);
+void debounce_reset_counts(s_debounce * p_debounce);
+
+void debounce_vertical_init(s_debounce_vertical * p_vertical, uint16_t tmp_sample);
+void debounce_vertical_scan(s_debounce_vertical * p_vertical, uint16_t tmp_sample,
+                            uint16_t * p_pressed, uint16_t * p_released);
+
+
+#endif /* DEBOUNCE_H */
+
+/* end of file */
@@ -0,0 +1,67 @@
+/** @file delay.h
+*
+* @brief  This file contains calibrated blocking delays based on the DWT cycle counter
+*         and an asynchronous microsecond callback service on timer 9.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef DELAY_H
+#define DELAY_H
+
+#define DELAY_CALLBACK_SLOTS 8U         //Callbacks that can be pending at once, buttons.c can hold one per button
+#define DELAY_CALLBACK_MAX_US 60000UL   //Longest async delay, use a soft timer beyond this
+#define DELAY_TIM9_PSC ((TIMERS_APB2_CLOCK_HZ / 1000000UL) - 1UL) //1 count per microsecond
+#define DELAY_IRQ_PRIORITY 3U           //Callbacks run at this NVIC priority
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "stm32f410rx.h"
+#include "timers.h"
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef void (*delay_callback)(void * p_context);
+
+
+/*
+****************************************************
+******* Public Functions Defined in delay.c *********
+****************************************************
+*/
+void delay_init(void);
+void delay_us(uint32_t tmp_us);
+void delay_ms(uint32_t tmp_ms);
+uint8_t delay_call_in_us(uint32_t tmp_us, delay_callback p_callback, void * p_context);
+void delay_cancel(delay_callback p_callback, void * p_context);
+
+void TIM1_BRK_TIM9_IRQHandler(void);
+
+
+#endif /* DELAY_H */
+
+/* end of file */
@@ -0,0 +1,81 @@
+/** @file event_queue.h
+*
+* @brief  This file contains a lock-free single-producer/single-consumer queue
+*         that carries typed, timestamped events from ISRs to the state machine.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef EVENT_QUEUE_H
+#define EVENT_QUEUE_H
+
+#define EVENT_QUEUE_SIZE 32U //Must be a power of two
+#define EVENT_QUEUE_IRQ_PRIORITY 2U //Every producer ISR must use this NVIC priority, see event_queue.c
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "stm32f410rx.h"
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef enum e_event_type_tag
+{
+   event_type_button_mode,  //data: e_debounce_edge, a press or a release
+   event_type_button_auto,
+   event_type_button_led,
+   event_type_tim5,
+   event_type_button_manual, //Not queued, goes straight to states_manual_edge like the timer 5 tick
+   max_event_type
+
+} e_event_type;
+
+
+typedef struct s_event_tag
+{
+   uint32_t timestamp; //input_replay_get_time_us() when the event was raised
+   uint8_t type;       //e_event_type
+   uint8_t data;       //Event specific payload
+
+} s_event;
+
+
+/*
+****************************************************
+***** Public Functions Defined in event_queue.c *****
+****************************************************
+*/
+uint8_t event_queue_push(e_event_type tmp_type, uint8_t tmp_data);
+uint8_t event_queue_inject(e_event_type tmp_type, uint8_t tmp_data, uint32_t tmp_timestamp);
+uint8_t event_queue_pop(s_event * p_event);
+uint8_t event_queue_is_empty(void);
+uint32_t event_queue_get_dropped(void);
+uint8_t event_queue_get_high_water(void);
+
+
+#endif /* EVENT_QUEUE_H */
+
+/* end of file */
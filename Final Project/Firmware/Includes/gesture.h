@@ -0,0 +1,89 @@
+/** @file gesture.h
+*
+* @brief  This file contains a button gesture recognizer: click, double-click, long-press and hold-repeat.
+*         Like debounce.c it only works on the edges and timestamps it is handed, so it runs off target as is.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef GESTURE_H
+#define GESTURE_H
+
+#define GESTURE_OFF 0U //Any s_gesture_config time left at this turns that gesture off
+
+#include <stdint.h>
+#include "debounce.h"
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef enum e_gesture_tag
+{
+   gesture_none,
+   gesture_click,         //On press if the button has no long-press or double-click, else once those are ruled out
+   gesture_double_click,  //On the second release
+   gesture_long_press,    //Once, long_press_ms into a hold. The release after it is swallowed
+   gesture_repeat,        //repeat_delay_ms into a hold, then every repeat_ms until released
+   max_gesture
+
+} e_gesture;
+
+
+//One per button, const so the whole table sits in flash. A button either repeats or long-presses,
+//repeat wins if both are set.
+typedef struct s_gesture_config_tag
+{
+   uint16_t long_press_ms;
+   uint16_t double_click_ms;  //Longest wait from the first release for the second press
+   uint16_t repeat_delay_ms;
+   uint16_t repeat_ms;
+
+} s_gesture_config;
+
+
+typedef struct s_gesture_tag
+{
+   const s_gesture_config * p_config;
+   uint32_t deadline_us;  //When gesture_poll has something to do, valid while phase needs a deadline
+   uint8_t phase;         //Private, see gesture.c
+
+} s_gesture;
+
+
+/*
+****************************************************
+****** Public Functions Defined in gesture.c *******
+****************************************************
+*/
+void gesture_init(s_gesture * p_gesture, const s_gesture_config * p_config);
+e_gesture gesture_edge(s_gesture * p_gesture, e_debounce_edge tmp_edge, uint32_t tmp_now_us);
+e_gesture gesture_poll(s_gesture * p_gesture, uint32_t tmp_now_us);
+uint8_t gesture_get_deadline(const s_gesture * p_gesture, uint32_t * p_deadline_us);
+
+
+#endif /* GESTURE_H */
+
+/* end of file */
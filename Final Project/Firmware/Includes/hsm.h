@@ -0,0 +1,105 @@
+/** @file hsm.h
+*
+* @brief  This file contains a generic table-driven hierarchical state machine engine.
+*         States and transitions are described by const tables, so they live in flash.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef HSM_H
+#define HSM_H
+
+#define HSM_NO_STATE 0xFFU //Parent of a top-level state, or initial child of a leaf state
+#define HSM_MAX_DEPTH 4U //Deepest nesting of states supported
+#define HSM_FLAG_HISTORY 0x01U //Re-entering this state resumes its last active child instead of the initial one
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef void (*hsm_action)(void);
+typedef uint8_t (*hsm_guard)(void);
+
+typedef enum e_hsm_kind_tag
+{
+   hsm_unhandled = 0, //Zero so table entries left out of an initializer pass the event to the parent
+   hsm_external,      //Exit up to the common ancestor, run the action, enter down to the target
+   hsm_internal       //Run the action only, no exit or entry
+
+} e_hsm_kind;
+
+
+typedef struct s_hsm_state_tag
+{
+   uint8_t parent;      //HSM_NO_STATE for a top-level state
+   uint8_t initial;     //Child entered when this state is a transition target, HSM_NO_STATE for a leaf
+   uint8_t flags;       //HSM_FLAG_x
+   hsm_action p_entry;  //Any of the actions can be NULL
+   hsm_action p_exit;
+   hsm_action p_do;     //Run on every hsm_run pass while the state is active
+
+} s_hsm_state;
+
+
+typedef struct s_hsm_transition_tag
+{
+   uint8_t kind;        //e_hsm_kind
+   uint8_t target;      //Only used by hsm_external
+   hsm_guard p_guard;   //NULL always passes. A failed guard passes the event to the parent
+   hsm_action p_action;
+
+} s_hsm_transition;
+
+
+typedef struct s_hsm_tag
+{
+   const s_hsm_state * p_states;     //num_states entries
+   const s_hsm_transition * p_table; //num_states x num_events, row per state
+   uint8_t * p_history;              //num_states entries of RAM, or NULL if no state uses HSM_FLAG_HISTORY
+   uint8_t num_states;
+   uint8_t num_events;
+   uint8_t current;                  //Active leaf state
+
+} s_hsm;
+
+
+/*
+****************************************************
+********* Public Functions Defined in hsm.c *********
+****************************************************
+*/
+void hsm_init(s_hsm * p_hsm, uint8_t tmp_initial);
+uint8_t hsm_dispatch(s_hsm * p_hsm, uint8_t tmp_event);
+void hsm_run(s_hsm * p_hsm);
+uint8_t hsm_get_state(const s_hsm * p_hsm);
+uint8_t hsm_is_in(const s_hsm * p_hsm, uint8_t tmp_state);
+
+
+#endif /* HSM_H */
+
+/* end of file */
@@ -0,0 +1,81 @@
+/** @file input_replay.h
+*
+* @brief  This file contains a recorder for the external inputs the firmware sees,
+*         button and timer events plus console bytes, and a player that feeds a
+*         recording back in place of the live inputs.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef INPUT_REPLAY_H
+#define INPUT_REPLAY_H
+
+#define INPUT_REPLAY_BUFFER_SIZE 256U //Recorded inputs, 8 bytes each
+#define INPUT_REPLAY_TICK_MS 1UL      //How often the player checks for due inputs, also the most a fast tick runs for
+
+#include <stdint.h>
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef enum e_input_replay_source_tag
+{
+   input_replay_source_event,  //data: e_event_type raised by an ISR
+   input_replay_source_uart,   //data: byte received on USART1
+   max_input_replay_source
+
+} e_input_replay_source;
+
+
+typedef enum e_input_replay_mode_tag
+{
+   input_replay_mode_off,
+   input_replay_mode_recording,
+   input_replay_mode_playing,       //Inputs are fed at their recorded times
+   input_replay_mode_playing_fast,  //Each input is fed as soon as the previous one is consumed
+   max_input_replay_mode
+
+} e_input_replay_mode;
+
+
+/*
+****************************************************
+**** Public Functions Defined in input_replay.c *****
+****************************************************
+*/
+uint8_t input_replay_capture(e_input_replay_source tmp_source, uint8_t tmp_data, uint8_t tmp_payload);
+void input_replay_record(void);
+void input_replay_play(uint8_t tmp_fast);
+void input_replay_stop(void);
+e_input_replay_mode input_replay_get_mode(void);
+uint32_t input_replay_get_count(void);
+uint32_t input_replay_get_position(void);
+uint32_t input_replay_get_time_us(void);
+
+
+#endif /* INPUT_REPLAY_H */
+
+/* end of file */
@@ -0,0 +1,66 @@
+/** @file io_stats.h
+*
+* @brief  This file contains counters of peripheral register writes made by the
+*         output drivers, with a once-per-second rate for each.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef IO_STATS_H
+#define IO_STATS_H
+
+#define IO_STATS_PERIOD_MS 1000UL //Rates are latched once per period
+
+#include <stdint.h>
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef enum e_io_stats_periph_tag
+{
+   io_stats_dac,   //Electromagnet DAC data register
+   io_stats_pwm,   //LED PWM compare register
+   max_io_stats_periph
+
+} e_io_stats_periph;
+
+
+/*
+****************************************************
+****** Public Functions Defined in io_stats.c ******
+****************************************************
+*/
+void io_stats_init(void);
+void io_stats_count(e_io_stats_periph tmp_periph);
+uint32_t io_stats_get_total(e_io_stats_periph tmp_periph);
+uint32_t io_stats_get_rate(e_io_stats_periph tmp_periph);
+const char * io_stats_get_name(e_io_stats_periph tmp_periph);
+void io_stats_reset(void);
+
+
+#endif /* IO_STATS_H */
+
+/* end of file */
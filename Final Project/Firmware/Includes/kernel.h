@@ -0,0 +1,89 @@
+/** @file kernel.h
+*
+* @brief  This file contains a minimal preemptive kernel: fixed-priority threads on
+*         static stacks, switched by PendSV, with semaphores to wake them from ISRs.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#define KERNEL_NO_THREAD 0xFFU
+#define KERNEL_SEM_MAX 255UL          //A semaphore stops counting here, further gives are lost
+#define KERNEL_STACK_FILL 0xDEADBEEFUL //Unused stack is filled with this so its high water mark can be found
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "stm32f410rx.h"
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+//Threads in order of priority, highest first. Must match the thread table in kernel.c.
+//The last thread must never block, it is what runs when every other thread is waiting.
+typedef enum e_kernel_thread_tag
+{
+   kernel_thread_magnet,  //Electromagnet sequencing, released by timer 5
+   kernel_thread_tasks,   //Cooperative task scheduler, including the console
+   max_kernel_thread
+
+} e_kernel_thread;
+
+
+typedef struct s_kernel_sem_tag
+{
+   volatile uint32_t count;
+   volatile uint8_t waiter;        //Thread blocked on this semaphore, KERNEL_NO_THREAD if none
+   volatile uint32_t give_cycles;  //Cycle count of the last give, for wake latency
+
+} s_kernel_sem;
+
+
+/*
+****************************************************
+******* Public Functions Defined in kernel.c *******
+****************************************************
+*/
+void kernel_init(void);
+void kernel_start(void);
+void kernel_sem_init(s_kernel_sem * p_sem, uint32_t tmp_count);
+void kernel_sem_wait(s_kernel_sem * p_sem);
+void kernel_sem_give(s_kernel_sem * p_sem);
+
+uint32_t kernel_get_switch_count(void);
+void kernel_get_switch_cycles(uint32_t * p_min, uint32_t * p_max);
+const char * kernel_get_name(e_kernel_thread tmp_thread);
+void kernel_get_wake_latency(e_kernel_thread tmp_thread, uint32_t * p_min, uint32_t * p_max);
+uint32_t kernel_get_stack_free(e_kernel_thread tmp_thread);
+void kernel_reset_stats(void);
+
+void PendSV_Handler(void);
+
+
+#endif /* KERNEL_H */
+
+/* end of file */
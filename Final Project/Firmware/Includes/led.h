@@ -29,21 +29,78 @@
 #ifndef LED_H
 #define LED_H
 
-#define LED_MAG_OFF 1
-#define LED_MAG_LOW TIMERS_TIMER5_DUTY_25
-#define LED_MAG_MED TIMERS_TIMER5_DUTY_50
-#define LED_MAG_HIGH TIM11_ARR
+#define LED_MAG_OFF 0
+#define LED_MAG_HIGH TIMERS_LED_PWM_COUNTS //Compare past ARR holds the output on
+#define LED_MAG_UNKNOWN 0xFFFFU //Nothing written yet, the timer starts at its init duty
+
+#define LED_ANIM_FRAME_HZ PWM_FRAME_HZ   //One duty value per timer 1 update
+#define LED_ANIM_MAX_FRAMES 512U        //Longest animation period, 5.12s at LED_ANIM_FRAME_HZ
+#define LED_ANIM_DEFAULT_PERIOD_MS 2000U
+#define LED_ANIM_DEFAULT_PEAK_PERCENT 100U
+#define LED_ANIM_DEFAULT_GAMMA_X10 LED_GAMMA_X10 //Same curve as the static levels
+#define LED_POD_MAX_FRAMES 256U         //Longest pod animation period, 2.56s at LED_ANIM_FRAME_HZ
+#define LED_ANIM_IRQ_PRIORITY 6U        //End of a one-shot LED fade, and pod animation frames
+#define LED_DMA_CHSEL_TIM1_UP (6ul << 25) //DMA2 stream 5 channel 6 is timer 1 update
+
+
+/*Perceptually even levels from led_gamma.h, 0 is off and LED_LEVEL_HIGH fully on */
+#define LED_LEVEL_OFF 0U
+#define LED_LEVEL_MED (LED_GAMMA_LEVELS / 2U)
+#define LED_LEVEL_HIGH (LED_GAMMA_LEVELS - 1U)
 
 
 #include <stdint.h>
 #include "timers.h"
+#include "pwm.h"
+#include "led_gamma.h"
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef enum e_led_anim_tag
+{
+   led_anim_none = 0,
+   led_anim_breathe,  //Gamma ramp up then down, loops
+   led_anim_fade_in,  //Gamma ramp up once, holds the peak
+   led_anim_fade_out, //Gamma ramp down once, holds off
+   led_anim_blink,    //Peak for half the period then off, loops
+   max_led_anim
+
+} e_led_anim;
+
+typedef struct s_led_anim_params_tag
+{
+   uint16_t period_ms;       //Clamped to what LED_ANIM_MAX_FRAMES holds
+   uint8_t peak_percent;     //Brightest point of the animation
+   uint8_t gamma_x10;        //Curve exponent, 10 is linear
+
+} s_led_anim_params;
+
 
 /*
 ****************************************************
 ******* Public Functions Defined in led.c *******
 ****************************************************
 */
+void led_init(void);
 void led_set_mag(uint16_t tmp_mag);
+void led_set_level(uint8_t tmp_level);
+void led_anim_start(e_led_anim tmp_anim, const s_led_anim_params * p_params);
+void led_anim_stop(void);
+e_led_anim led_anim_get(void);
+const s_led_anim_params * led_anim_get_params(void);
+const char * led_anim_get_name(e_led_anim tmp_anim);
+uint16_t led_gamma_curve(uint32_t tmp_step, uint32_t tmp_last_step, uint16_t tmp_peak, uint8_t tmp_gamma_x10);
+void led_pod_set_level(uint8_t tmp_pod, uint8_t tmp_level);
+void led_pod_set_levels(const uint8_t p_levels[PWM_PODS]);
+void led_pod_anim_start(uint8_t tmp_pod, e_led_anim tmp_anim, const s_led_anim_params * p_params);
+void led_pod_anim_stop(uint8_t tmp_pod);
+e_led_anim led_pod_anim_get(uint8_t tmp_pod);
+void DMA2_Stream5_IRQHandler(void);
+void TIM1_UP_TIM10_IRQHandler(void);
 
 
 
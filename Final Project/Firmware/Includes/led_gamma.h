@@ -0,0 +1,45 @@
+/** @file led_gamma.h
+*
+* @brief  Perceptually even LED levels as PWM compare values.
+*         Generated by Tools/gamma_lut.py, do not edit by hand
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef LED_GAMMA_H
+#define LED_GAMMA_H
+
+//gamma_lut.py --gamma 2.2 --bits 14 --levels 8
+#define LED_GAMMA_X10 22U
+#define LED_GAMMA_BITS 14U
+#define LED_GAMMA_LEVELS 8U
+
+//Initializer for a const uint16_t[LED_GAMMA_LEVELS], so the table lands in flash
+#define LED_GAMMA_TABLE \
+{ \
+       0,   227,  1041,  2540,  4783,  7815, 11672, 16384 \
+}
+
+#endif /* LED_GAMMA_H */
+
+/* end of file */
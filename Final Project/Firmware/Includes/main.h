@@ -39,9 +39,20 @@
 #include "console.h"
 #include "timers.h"
 #include "led.h"
+#include "pwm.h"
 #include "electromagnet.h"
 #include "buttons.h"
 #include "states.h"
+#include "scheduler.h"
+#include "soft_timers.h"
+#include "io_stats.h"
+#include "profiler.h"
+#include "trace.h"
+#include "input_replay.h"
+#include "kernel.h"
+#include "watchdog.h"
+#include "delay.h"
+#include "capture.h"
 
 
 
@@ -0,0 +1,83 @@
+/** @file profiler.h
+*
+* @brief  This file contains cycle-accurate profiling of the main loop stages.
+*         Each stage keeps min/avg/max and a log2 histogram of its run time in RAM.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#define PROFILER_BUCKETS 24U //Bucket n counts runs of 2^n to 2^(n+1)-1 cycles, the last one also counts anything longer
+
+#include <stdint.h>
+#include "system_clock.h"
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef enum e_profiler_stage_tag
+{
+   profiler_stage_main_event,  //states_update_main_event, includes the LED stage below
+   profiler_stage_main_state,  //states_update_main_state
+   profiler_stage_led,         //states_update_led
+   profiler_stage_timers,      //soft_timers_process, includes timer callbacks
+   profiler_stage_console,     //ConsoleProcess
+   max_profiler_stage
+
+} e_profiler_stage;
+
+
+/*
+****************************************************
+******************* Public Macros ******************
+****************************************************
+*/
+
+//Start stamp for profiler_end
+#define profiler_begin() system_clock_get_cycles()
+
+
+/*
+****************************************************
+****** Public Functions Defined in profiler.c ******
+****************************************************
+*/
+void profiler_end(e_profiler_stage tmp_stage, uint32_t tmp_start);
+void profiler_reset(void);
+
+const char * profiler_get_name(e_profiler_stage tmp_stage);
+uint32_t profiler_get_count(e_profiler_stage tmp_stage);
+uint32_t profiler_get_min(e_profiler_stage tmp_stage);
+uint32_t profiler_get_avg(e_profiler_stage tmp_stage);
+uint32_t profiler_get_max(e_profiler_stage tmp_stage);
+uint32_t profiler_get_bucket(e_profiler_stage tmp_stage, uint8_t tmp_bucket);
+
+
+#endif /* PROFILER_H */
+
+/* end of file */
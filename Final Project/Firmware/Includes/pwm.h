@@ -0,0 +1,85 @@
+/** @file pwm.h
+*
+* @brief  This file contains the multi-channel PWM driver for the LED and the jelly pod LEDs
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef PWM_H
+#define PWM_H
+
+#define PWM_AF_TIM1 1U                  //TIM1 pins are on alternate function 1
+#define PWM_AF_TIM11 3U                 //TIM11 CH1 on PC12 is alternate function 3
+#define PWM_FRAME_HZ 100UL              //Timer 1 update rate, it still PWMs at TIMERS_LED_PWM_HZ
+#define PWM_PODS 4U                     //pwm_pod_1 to pwm_pod_4
+
+#include <stdint.h>
+#include "timers.h"
+#include "base_gpio_drivers.h"
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef enum e_pwm_channel_tag
+{
+   pwm_led = 0,  //Onboard LED
+   pwm_pod_1,    //Jelly pod LEDs, all on timer 1 so they share period boundaries
+   pwm_pod_2,
+   pwm_pod_3,
+   pwm_pod_4,
+   max_pwm_channel
+
+} e_pwm_channel;
+
+typedef struct s_pwm_channel_tag
+{
+   e_timers_id timer;
+   uint8_t channel;         //1 to 4
+   uint8_t complementary;   //1 to drive the CHxN pin instead of CHx
+   GPIO_TypeDef * p_port;
+   uint8_t pin;
+   uint8_t af;
+
+} s_pwm_channel;
+
+
+/*
+****************************************************
+******* Public Functions Defined in pwm.c *********
+****************************************************
+*/
+void pwm_init(void);
+void pwm_set(e_pwm_channel tmp_channel, uint16_t tmp_duty);
+void pwm_batch_begin(void);
+void pwm_batch_end(void);
+volatile uint32_t * pwm_get_ccr(e_pwm_channel tmp_channel);
+void pwm_output_enable(e_pwm_channel tmp_channel);
+void pwm_output_disable(e_pwm_channel tmp_channel);
+
+
+#endif /* PWM_H */
+
+/* end of file */
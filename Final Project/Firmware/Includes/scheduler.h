@@ -0,0 +1,77 @@
+/** @file scheduler.h
+*
+* @brief  This file contains a small run-to-completion task scheduler. Tasks run
+*         when their period is due or when an ISR signals them, highest priority first.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#define SCHEDULER_EVENT_DRIVEN 0UL //Task period for tasks that only run when signalled
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "stm32f410rx.h"
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+//Tasks in order of priority, highest first. Must match the task table in scheduler.c
+typedef enum e_scheduler_task_tag
+{
+   scheduler_task_states,
+   scheduler_task_timers,
+   scheduler_task_console,
+   max_scheduler_task
+
+} e_scheduler_task;
+
+
+/*
+****************************************************
+****** Public Functions Defined in scheduler.c ******
+****************************************************
+*/
+void scheduler_init(void);
+uint8_t scheduler_run(void);
+void scheduler_thread(void * p_context);
+void scheduler_signal(e_scheduler_task tmp_task);
+void scheduler_idle(void);
+
+uint32_t scheduler_get_sleep_permille(void);
+void scheduler_get_wake_latency(uint32_t * p_last, uint32_t * p_max);
+void scheduler_reset_stats(void);
+
+const char * scheduler_get_name(e_scheduler_task tmp_task);
+uint32_t scheduler_get_run_count(e_scheduler_task tmp_task);
+uint32_t scheduler_get_wcet(e_scheduler_task tmp_task);
+
+
+#endif /* SCHEDULER_H */
+
+/* end of file */
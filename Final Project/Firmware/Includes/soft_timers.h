@@ -0,0 +1,78 @@
+/** @file soft_timers.h
+*
+* @brief  This file contains a hierarchical timer wheel that runs many one-shot
+*         and periodic software timers off the single millisecond system tick.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef SOFT_TIMERS_H
+#define SOFT_TIMERS_H
+
+#define SOFT_TIMERS_SLOT_BITS 6U //64 slots per wheel level
+#define SOFT_TIMERS_SLOTS (1UL << SOFT_TIMERS_SLOT_BITS)
+#define SOFT_TIMERS_LEVELS 3U //1ms, 64ms and 4.096s slots, covers ~262s before a timer is re-cascaded
+#define SOFT_TIMERS_ONE_SHOT 0UL
+
+#include <stdint.h>
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef void (*soft_timer_callback)(void * p_context);
+
+//Owned by the caller and linked into the wheel while running, so there is no allocation and no fixed limit.
+//Must start out zeroed, which static storage already is.
+typedef struct s_soft_timer_tag
+{
+   struct s_soft_timer_tag * p_next;
+   struct s_soft_timer_tag ** pp_prev; //Whatever points at this timer, a slot head or the previous p_next
+   uint32_t expiry_ms;
+   uint32_t period_ms;             //SOFT_TIMERS_ONE_SHOT or the reload period
+   soft_timer_callback p_callback;
+   void * p_context;
+   uint8_t active;
+
+} s_soft_timer;
+
+
+/*
+****************************************************
+***** Public Functions Defined in soft_timers.c *****
+****************************************************
+*/
+void soft_timers_init(void);
+void soft_timers_process(void);
+void soft_timer_start(s_soft_timer * p_timer, uint32_t tmp_delay_ms, uint32_t tmp_period_ms,
+                      soft_timer_callback p_callback, void * p_context);
+void soft_timer_stop(s_soft_timer * p_timer);
+uint8_t soft_timer_is_active(const s_soft_timer * p_timer);
+uint32_t soft_timers_get_active_count(void);
+
+
+#endif /* SOFT_TIMERS_H */
+
+/* end of file */
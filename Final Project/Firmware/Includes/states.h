@@ -33,6 +33,13 @@
 #define STATES_MAGNETALGO_MAX 3 //Total number of different algorithms to choose from.
 #define STATES_MAGNETALGO_STOP 4094 //Termination character for electromagnet algorithm lookup table
 
+/*Button gestures, see the gesture table in states.c */
+#define STATES_LONG_PRESS_MS 1000U   //Holding mode this long saves the settings
+#define STATES_DOUBLE_CLICK_MS 300U  //Double-clicking auto reverses the ramp, so single clicks wait this long
+#define STATES_REPEAT_DELAY_MS 500U  //Holding the LED button this long keeps stepping the brightness
+#define STATES_REPEAT_MS 250U
+#define STATES_SETTINGS_MAGIC 0x53455454UL //"SETT", marks the saved settings as valid after a reset
+
 #include "buttons.h"
 #include "led.h"
 #include "electromagnet.h"
@@ -44,9 +51,12 @@
 ******* Public Function Defined in states.c ********
 ****************************************************
 */
+void states_init(void);
 void states_update_main_event(void);
 void states_update_main_state(void);
-void states_update_led(void);
 void states_print_state(void);
+void states_mag_tick(void);
+void states_manual_edge(uint8_t tmp_pressed);
+void states_mag_thread(void * p_context);
 
 #endif /* STATES_H */
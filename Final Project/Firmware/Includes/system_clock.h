@@ -31,17 +31,41 @@
 #define SYSTEM_CLOCK_FREQUENCY 100000000UL //100MHz
 #define PWR_CR_VOS_SCALE1 0X0000C000U;
 #define RCC_CR_HSI_TRIMM_Msk (0X1F << 3UL)
+#define SYSTEM_CLOCK_TICK_HZ 1000UL //SysTick rate, one tick per millisecond
+#define SYSTEM_CLOCK_CYCLES_PER_TICK (SYSTEM_CLOCK_FREQUENCY / SYSTEM_CLOCK_TICK_HZ)
+#define SYSTEM_CLOCK_CYCLES_PER_US (SYSTEM_CLOCK_FREQUENCY / 1000000UL)
 
 #include <stdint.h>
 #include "stm32f4xx.h"
 #include "stm32f410rx.h"
 
+/*
+****************************************************
+************* Time Base Helper Macros **************
+****************************************************
+*/
+
+//Raw CPU cycle count, 10ns resolution at 100MHz. Wraps about every 42.9 seconds
+#define system_clock_get_cycles() (DWT->CYCCNT)
+
+//Wrap-safe comparisons for any of the free-running uint32_t time values (ms, us or cycles).
+//Correct as long as the two values are less than half the counter range apart.
+#define system_clock_elapsed(tmp_start, tmp_now) ((uint32_t)((tmp_now) - (tmp_start)))
+#define system_clock_is_before(tmp_a, tmp_b) (0 > (int32_t)((uint32_t)(tmp_a) - (uint32_t)(tmp_b)))
+#define system_clock_is_after(tmp_a, tmp_b) (0 < (int32_t)((uint32_t)(tmp_a) - (uint32_t)(tmp_b)))
+#define system_clock_has_reached(tmp_now, tmp_deadline) (0 <= (int32_t)((uint32_t)(tmp_now) - (uint32_t)(tmp_deadline)))
+
+#define system_clock_cycles_to_us(tmp_cycles) ((tmp_cycles) / SYSTEM_CLOCK_CYCLES_PER_US)
+
 /*
 ****************************************************
 ***** Public Function Defined in sysem_clock.c *****
 ****************************************************
 */
 void system_clock_init(void);
+uint32_t system_clock_get_ms(void);
+uint32_t system_clock_get_us(void);
+void SysTick_Handler(void);
 
 
 #endif /* SYSTEM_CLOCK_H */
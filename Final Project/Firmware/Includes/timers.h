@@ -34,42 +34,109 @@
 #include "stm32f410rx.h"
 #include "base_gpio_drivers.h"
 
-/*Timer Register Configuration Definitions */
-#define GPIO_AF3 3ul
-#define GPIO_AFRH_PIN12_AF3 (GPIO_AF3 << 16)
-#define TIMER11_CHANNEL1 GPIOC, 12
+/*Timer kernel clocks. APB1 runs at HCLK/2, so its timers get the x2 and both buses end up at 100MHz */
+#define TIMERS_APB1_CLOCK_HZ 100000000UL
+#define TIMERS_APB2_CLOCK_HZ 100000000UL
+
+#define TIMERS_MAX_PSC 0xFFFFUL
+#define TIMERS_MAX_ARR_16 0xFFFFUL
+#define TIMERS_MAX_ARR_32 0xFFFFFFFFUL
+#define TIMERS_COUNTS_ANY 0UL           //Let the solver pick the largest counts per period
+#define TIMERS_MAX_ERROR_PPM 1000L      //Worst frequency error the fixed configurations accept
+
+/*Application rates */
+#define TIMERS_MAGNET_STEP_HZ 10UL      //Magnet algorithm step rate, timer 5. Fixed, capture.c times against its wrap
+#define TIMERS_LED_PWM_BITS 14UL        //LED duty resolution, must match LED_GAMMA_BITS
+#define TIMERS_LED_PWM_COUNTS (1UL << TIMERS_LED_PWM_BITS) //Duty steps per LED PWM period
+#define TIMERS_LED_PWM_HZ (TIMERS_APB2_CLOCK_HZ / TIMERS_LED_PWM_COUNTS) //Fastest rate at this depth, ~6.1kHz. Used by pwm.c
+
+/*
+* PSC/ARR solver. Every macro only does integer maths, so with constant arguments the result is a
+* constant expression and can be checked with TIMERS_CONFIG_OK in a _Static_assert. timers_solve()
+* runs the same macros for rates only known at run time.
+*  - TIMERS_PSC_FOR/TIMERS_ARR_FOR: smallest prescaler that fits the period, i.e. the finest resolution
+*  - TIMERS_PSC_FOR_COUNTS: fixed counts per period (PWM duty resolution), ARR is then counts - 1
+*/
+#define TIMERS_TICKS_FOR(clk, hz) (((uint64_t)(clk) + ((uint64_t)(hz) / 2U)) / (uint64_t)(hz))
+#define TIMERS_PSC_FOR(clk, hz, max_arr) \
+   ((TIMERS_TICKS_FOR(clk, hz) + (uint64_t)(max_arr)) / ((uint64_t)(max_arr) + 1U) - 1U)
+#define TIMERS_ARR_FOR(clk, hz, max_arr) \
+   ((TIMERS_TICKS_FOR(clk, hz) + ((TIMERS_PSC_FOR(clk, hz, max_arr) + 1U) / 2U)) / \
+    (TIMERS_PSC_FOR(clk, hz, max_arr) + 1U) - 1U)
+#define TIMERS_PSC_FOR_COUNTS(clk, hz, counts) \
+   (((uint64_t)(clk) + ((uint64_t)(hz) * (counts) / 2U)) / ((uint64_t)(hz) * (counts)) - 1U)
+
+/*Achieved rate in millihertz and its error against the request in parts per million */
+#define TIMERS_MHZ_FOR(clk, psc, arr) \
+   ((1000ULL * (clk)) / (((uint64_t)(psc) + 1U) * ((uint64_t)(arr) + 1U)))
+#define TIMERS_ERROR_PPM(clk, hz, psc, arr) \
+   (((int64_t)((1000000ULL * (clk)) / (((uint64_t)(psc) + 1U) * ((uint64_t)(arr) + 1U))) - \
+     (int64_t)(1000000ULL * (hz))) / (int64_t)(hz))
+#define TIMERS_CONFIG_OK(clk, hz, psc, arr, max_arr) \
+   (((uint64_t)(psc) <= TIMERS_MAX_PSC) && ((uint64_t)(arr) <= (uint64_t)(max_arr)) && \
+    (TIMERS_ERROR_PPM(clk, hz, psc, arr) <= TIMERS_MAX_ERROR_PPM) && \
+    (TIMERS_ERROR_PPM(clk, hz, psc, arr) >= -TIMERS_MAX_ERROR_PPM))
 
 #define timers_timer11_enable() TIM11->CR1 |= TIM_CR1_CEN
 #define timers_timer11_disable() TIM11->CR1 &= ~TIM_CR1_CEN
 
-#define TIMERS_TIMER5_DUTY_10 TIM11->ARR/10
-#define TIMERS_TIMER5_DUTY_25 TIM11->ARR/4
-#define TIMERS_TIMER5_DUTY_50 TIM11->ARR/2
+/*LED duty in compare counts. 0 holds the output low, TIMERS_LED_PWM_COUNTS holds it high */
+#define TIMERS_LED_DUTY_PERCENT(pct) ((uint16_t)((TIMERS_LED_PWM_COUNTS * (pct)) / 100UL))
+#define TIMERS_LED_DUTY_50 TIMERS_LED_DUTY_PERCENT(50)
 
-#define TIM11_ARR 100UL
 
 /*
 ****************************************************
-******* Public Function Defined in timers.c ********
+******** Public Types and Structure Definitions *****
 ****************************************************
 */
-void timers_gpio_rising_edge_pulse(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number); 
-void timers_gpio_falling_edge_pulse(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number);
-void timers_timer5_init(void);
-void timers_timer11_init(void);
-void timers_timer11_output_enable(void);
-void timers_timer11_output_disable(void);
-void TIM5_IRQHandler(void);
-void timers_timer11_reset_status(void);
-uint8_t timers_timer11_get_status(void);
 
-uint8_t timers_tim5_get_status(void);
-void timers_tim5_reset_flag(void);
+typedef enum e_timers_id_tag
+{
+   timers_tim1 = 0,
+   timers_tim5,
+   timers_tim6,
+   timers_tim9,
+   timers_tim11,
+   max_timers_id
+
+} e_timers_id;
+
+typedef struct s_timers_instance_tag
+{
+   TIM_TypeDef * p_tim;
+   volatile uint32_t * p_rcc_enr;  //Bus clock enable register
+   uint32_t rcc_en_bit;
+   uint32_t clock_hz;              //Timer kernel clock
+   uint32_t max_arr;               //TIMERS_MAX_ARR_16 or TIMERS_MAX_ARR_32
+   IRQn_Type update_irq;
 
-void timers_delay(uint32_t delay_time);
-void timers_delay_mini(uint32_t delay_time);
+} s_timers_instance;
 
-void timers_timer11_duty(uint16_t tmp_duty);
+typedef struct s_timers_config_tag
+{
+   uint32_t psc;
+   uint32_t arr;
+
+} s_timers_config;
+
+
+/*
+****************************************************
+******* Public Function Defined in timers.c ********
+****************************************************
+*/
+const s_timers_instance * timers_get_instance(e_timers_id tmp_id);
+uint8_t timers_solve(uint32_t tmp_clock_hz, uint32_t tmp_hz, uint32_t tmp_counts, uint32_t tmp_max_arr, s_timers_config * p_config);
+void timers_init(e_timers_id tmp_id, const s_timers_config * p_config);
+uint8_t timers_set_hz(e_timers_id tmp_id, uint32_t tmp_hz, uint32_t tmp_counts, int32_t * p_error_ppm);
+void timers_update_irq_enable(e_timers_id tmp_id, uint32_t tmp_priority);
+void timers_start(e_timers_id tmp_id);
+void timers_stop(e_timers_id tmp_id);
+uint32_t timers_get_mhz(e_timers_id tmp_id);
+
+void timers_timer5_init(void);
+void TIM5_IRQHandler(void);
 
 
 #endif /* TIMERS_H */
@@ -0,0 +1,112 @@
+/** @file trace.h
+*
+* @brief  This file contains a RAM flight recorder of cycle-stamped system events.
+*         The buffer can be dumped over USART1 and converted with Tools/trace2json.py.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifndef TRACE_ENABLE
+#define TRACE_ENABLE 1 //Build with -DTRACE_ENABLE=0 to compile every TRACE() away
+#endif
+
+#define TRACE_BUFFER_SIZE 256U //Records, must be a power of 2. 8 bytes each
+#define TRACE_MAGIC "TRC1" //Start of a dump, so the host tool can find it among console text
+
+#include <stdint.h>
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+//Record types. The numbers are part of the dump format, only add to the end
+typedef enum e_trace_id_tag
+{
+   trace_id_isr_enter,  //arg8: e_trace_isr
+   trace_id_isr_exit,   //arg8: e_trace_isr
+   trace_id_state,      //arg8: new leaf state of the main state machine
+   trace_id_command,    //arg8: index into the console command table
+   trace_id_dac,        //arg16: value written to the electromagnet DAC
+   max_trace_id
+
+} e_trace_id;
+
+
+typedef enum e_trace_isr_tag
+{
+   trace_isr_tim5,
+   trace_isr_exti0,
+   trace_isr_exti1,
+   trace_isr_exti2,
+   trace_isr_usart1,
+   trace_isr_exti3,
+   max_trace_isr
+
+} e_trace_isr;
+
+
+//One record as stored and as dumped, little endian
+typedef struct s_trace_record_tag
+{
+   uint32_t cycles;  //DWT cycle count, wraps every ~42s
+   uint8_t id;       //e_trace_id
+   uint8_t arg8;
+   uint16_t arg16;
+
+} s_trace_record;
+
+
+/*
+****************************************************
+******************* Public Macros ******************
+****************************************************
+*/
+#if TRACE_ENABLE
+#define TRACE(id, arg8, arg16) trace_record((id), (arg8), (arg16))
+#else
+#define TRACE(id, arg8, arg16) ((void)0)
+#endif
+
+
+/*
+****************************************************
+******* Public Functions Defined in trace.c ********
+****************************************************
+*/
+void trace_init(void);
+void trace_record(e_trace_id tmp_id, uint8_t tmp_arg8, uint16_t tmp_arg16);
+void trace_start(void);
+void trace_stop(void);
+void trace_dump(void);
+uint32_t trace_get_count(void);
+uint32_t trace_get_overwritten(void);
+
+
+#endif /* TRACE_H */
+
+/* end of file */
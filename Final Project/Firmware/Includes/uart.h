@@ -74,6 +74,9 @@
 #define BR_PRESCALER_921600_fraction 0x0C
 #define BR_PRESCALER_921600 ((BR_PRESCALER_921600_mantissa << 4) | BR_PRESCALER_921600_fraction)
 
+#define UART1_RX_BUFFER_SIZE 64U //Must be a power of two
+#define UART1_TX_TIMEOUT_US 2000UL //Two byte times at 9600 baud
+
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
@@ -92,6 +95,8 @@ void uart1_send_byte(char tmp_byte);
 void uart1_arduino_plotter(char temp_single_char);
 uint8_t uart1_is_readable(void);
 char uart1_receive_byte();
+void uart1_inject_byte(char tmp_char);
+void USART1_IRQHandler(void);
 
 
 #endif /* USART_H */
@@ -0,0 +1,93 @@
+/** @file watchdog.h
+*
+* @brief  This file contains the independent watchdog driver. Every client checks in
+*         regularly and the dog is only fed while all of them are alive.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef WATCHDOG_H
+#define WATCHDOG_H
+
+#define WATCHDOG_CHECK_MS 250UL //Every client must check in at least this often
+#define WATCHDOG_PRESCALER 3UL  //LSI / 32, ~1kHz counter
+#define WATCHDOG_RELOAD 1000UL  //~1s timeout, LSI varies from 17 to 47kHz so this is 0.7s to 1.9s
+#define WATCHDOG_KEY_RELOAD 0xAAAAUL
+#define WATCHDOG_KEY_ENABLE 0xCCCCUL
+#define WATCHDOG_KEY_ACCESS 0x5555UL
+#define WATCHDOG_BUSY_MAX_MS 5000UL //Longest a single watchdog_busy call can excuse the tasks thread
+#define WATCHDOG_NOINIT_MAGIC 0x57444F47UL //"WDOG", marks a valid stall record after a reset
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+#include "stm32f410rx.h"
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef enum e_watchdog_client_tag
+{
+   watchdog_client_states,   //Scheduler tasks, checked in each time they run
+   watchdog_client_timers,
+   watchdog_client_console,
+   watchdog_client_magnet,   //Magnet thread, checked in on every timer 5 tick
+   max_watchdog_client
+
+} e_watchdog_client;
+
+
+typedef enum e_watchdog_reset_tag
+{
+   watchdog_reset_unknown,
+   watchdog_reset_power_on,
+   watchdog_reset_brown_out,
+   watchdog_reset_pin,
+   watchdog_reset_software,
+   watchdog_reset_iwdg,
+   watchdog_reset_wwdg,
+   watchdog_reset_low_power,
+   max_watchdog_reset
+
+} e_watchdog_reset;
+
+
+/*
+****************************************************
+****** Public Functions Defined in watchdog.c ******
+****************************************************
+*/
+void watchdog_init(void);
+void watchdog_check_in(e_watchdog_client tmp_client);
+void watchdog_busy(uint32_t tmp_ms);
+void watchdog_tick(void);
+e_watchdog_reset watchdog_get_reset_cause(void);
+uint32_t watchdog_get_stalled(void);
+void watchdog_print_report(void);
+
+
+#endif /* WATCHDOG_H */
+
+/* end of file */
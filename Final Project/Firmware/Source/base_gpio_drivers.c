@@ -168,6 +168,23 @@ gpio_pupd_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number, uint8_t pin_pupd)
 
 }
 
+/*!
+* @brief Selects the alternate function a pin is connected to
+* @param[in] p_gpio_tmp Pointer to GPIO structure.
+* @param[in] pin_number Pin number of desired port.
+* @param[in] pin_af Alternate function number, 0 to 15. See the datasheet's alternate function map
+* @return NONE
+* @warning Assumes the appropriate peripheral clock has already been set.
+* @note Only routes the pin, it also needs GPIO_MODER_ALTERNATE_FUNCTION from gpio_func_init
+*/
+void
+gpio_af_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number, uint8_t pin_af)
+{
+   p_gpio_tmp->AFR[pin_number >> 3] &= ~(0x0Ful << (4 * (pin_number & 7U)));
+   p_gpio_tmp->AFR[pin_number >> 3] |= ((uint32_t)(pin_af & 0x0FU) << (4 * (pin_number & 7U)));
+}
+
+
 
 /*!
 * @brief Sets the desired pin to logic high, +3.3v.
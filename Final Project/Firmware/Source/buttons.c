@@ -27,21 +27,71 @@
 */
 
 #include "buttons.h"
+#include "scheduler.h"
+#include "trace.h"
+#include "event_queue.h"
+#include "system_clock.h"
+#include "timers.h"
+#include "delay.h"
+#include "input_replay.h"
+#include "states.h"
+#include <stdint.h>
+
 
 /*
 ****************************************************
-************* File-Static Variables ****************
+********** Compile-Time Configurations *************
 ****************************************************
 */
-static uint8_t buttons_mode_detection = 0;
-static uint8_t buttons_auto_detection = 0;
-static uint8_t buttons_led_detection = 0;
+
+#define BUTTONS_TIM6_PSC TIMERS_PSC_FOR(TIMERS_APB1_CLOCK_HZ, BUTTONS_SCAN_HZ, TIMERS_MAX_ARR_16)
+#define BUTTONS_TIM6_ARR TIMERS_ARR_FOR(TIMERS_APB1_CLOCK_HZ, BUTTONS_SCAN_HZ, TIMERS_MAX_ARR_16)
+
+_Static_assert(TIMERS_CONFIG_OK(TIMERS_APB1_CLOCK_HZ, BUTTONS_SCAN_HZ, BUTTONS_TIM6_PSC, BUTTONS_TIM6_ARR, TIMERS_MAX_ARR_16),
+               "BUTTONS_SCAN_HZ can't be reached by timer 6");
+
 
 /*
 ****************************************************
 ********** Private Function Prototypes *************
 ****************************************************
 */
+void button_edge(e_button tmp_button, uint8_t tmp_level);
+void button_deliver(e_button tmp_button, e_debounce_edge tmp_edge);
+void button_settle(void * p_context);
+void button_scan_edges(uint16_t tmp_pressed, uint16_t tmp_released);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+
+//Written by the EXTI handlers, only the window is written from task context
+static s_debounce buttons_debounce[max_button];
+
+#if BUTTONS_SCAN
+//Every pin of BUTTONS_PORT, debounced together by the timer 6 tick
+static s_debounce_vertical buttons_scan;
+#endif
+
+//Indexed by e_button
+static const uint8_t buttons_pins[max_button] =
+{
+   [button_mode]   = BUTTONS_PIN(BUTTON_MAIN_MODE),
+   [button_auto]   = BUTTONS_PIN(BUTTON_AUTO_MODE),
+   [button_led]    = BUTTONS_PIN(BUTTON_LED),
+   [button_manual] = BUTTONS_PIN(BUTTON_MANUAL),
+};
+
+static const e_event_type buttons_events[max_button] =
+{
+   [button_mode]   = event_type_button_mode,
+   [button_auto]   = event_type_button_auto,
+   [button_led]    = event_type_button_led,
+   [button_manual] = event_type_button_manual,
+};
 
 
 /*
@@ -68,14 +118,16 @@ button_mode_init(void)
 {
    //Initialize pin to input, no pull-up/down, low speed
    gpio_gen_input_init(BUTTON_MAIN_MODE);
+   debounce_init(&buttons_debounce[button_mode], DEBOUNCE_WINDOW_US, gpio_read_pin(BUTTON_MAIN_MODE));
 
    //Unmask interrupt for pin 0
    EXTI -> IMR |= EXTI_IMR_IM0;
 
    //Set pin as an interrupt
    SYSCFG -> EXTICR[0] |= SYSCFG_EXTICR1_EXTI0_PC; //Tie port C to interrupt line 0
-   EXTI->RTSR |= EXTI_RTSR_TR0; // Set trigger pin 0 to rising edge, it has an external pull down
-   NVIC_SetPriority(EXTI0_IRQn,2); // Set interrupt priority to 2
+   EXTI->RTSR |= EXTI_RTSR_TR0; // Trigger pin 0 on both edges, it has an external pull down
+   EXTI->FTSR |= EXTI_FTSR_TR0; // The debouncer needs releases too, or their bounces look like presses
+   NVIC_SetPriority(EXTI0_IRQn, EVENT_QUEUE_IRQ_PRIORITY); // Same priority as every other event producer
    NVIC_EnableIRQ(EXTI0_IRQn);
 }
 
@@ -91,14 +143,16 @@ button_auto_init(void)
 {
    //Initialize pin to input, no pull-up/down, low speed
    gpio_gen_input_init(BUTTON_AUTO_MODE);
+   debounce_init(&buttons_debounce[button_auto], DEBOUNCE_WINDOW_US, gpio_read_pin(BUTTON_AUTO_MODE));
 
    //Unmask interrupt for pin 1
    EXTI -> IMR |= EXTI_IMR_IM1;
 
    //Set pin as an interrupt
    SYSCFG -> EXTICR[0] |= SYSCFG_EXTICR1_EXTI1_PC; //Tie port C to interrupt line 1
-   EXTI->RTSR |= EXTI_RTSR_TR1; // Set trigger pin 1 to rising edge, it has an external pull down
-   NVIC_SetPriority(EXTI1_IRQn,2); // Set interrupt priority to 2
+   EXTI->RTSR |= EXTI_RTSR_TR1; // Trigger pin 1 on both edges, it has an external pull down
+   EXTI->FTSR |= EXTI_FTSR_TR1; // The debouncer needs releases too, or their bounces look like presses
+   NVIC_SetPriority(EXTI1_IRQn, EVENT_QUEUE_IRQ_PRIORITY); // Same priority as every other event producer
    NVIC_EnableIRQ(EXTI1_IRQn);
 }
 
@@ -114,167 +168,343 @@ button_led_init(void)
 {
    //Initialize pin to input, no pull-up/down, low speed
    gpio_gen_input_init(BUTTON_LED);
+   debounce_init(&buttons_debounce[button_led], DEBOUNCE_WINDOW_US, gpio_read_pin(BUTTON_LED));
 
    //Unmask interrupt for pin 2
    EXTI -> IMR |= EXTI_IMR_IM2;
 
    //Set pin as an interrupt
    SYSCFG -> EXTICR[0] |= SYSCFG_EXTICR1_EXTI2_PC; //Tie port C to interrupt line 2
-   EXTI->RTSR |= EXTI_RTSR_TR2; // Set trigger pin 2 to rising edge, it has an external pull down
-   NVIC_SetPriority(EXTI2_IRQn,2); // Set interrupt priority to 2
+   EXTI->RTSR |= EXTI_RTSR_TR2; // Trigger pin 2 on both edges, it has an external pull down
+   EXTI->FTSR |= EXTI_FTSR_TR2; // The debouncer needs releases too, or their bounces look like presses
+   NVIC_SetPriority(EXTI2_IRQn, EVENT_QUEUE_IRQ_PRIORITY); // Same priority as every other event producer
    NVIC_EnableIRQ(EXTI2_IRQn);
 }
 
 
 /**
-* @brief Initialize external button as input
-* @param[in] NONE
+* @brief Set the debounce window of every EXTI button
+* @param[in] tmp_window_us Quiet time needed before an edge counts
 * @return NONE
-*
 */
 void
-button_manual_init(void)
+button_set_debounce_us(uint32_t tmp_window_us)
 {
-   //Initialize pin to input, no pull-up/down, low speed
-   gpio_gen_input_init(BUTTON_MANUAL);
+   for(uint8_t button = 0; button < max_button; button++)
+   {
+      debounce_set_window(&buttons_debounce[button], tmp_window_us);
+   }
 }
 
+
 /**
-* @brief Check if manual button is currently being pressed
-* @param[in] NONE
-* @return NONE
-*
+* @brief Get the debouncer of a button, for its window and edge counters
+* @param[in] tmp_button Button to look at
+* @return Debouncer, read only
 */
-uint8_t
-button_manual_status(void)
+const s_debounce *
+button_get_debounce(e_button tmp_button)
 {
-   uint8_t button_press = gpio_read_pin(BUTTON_MANUAL);
-
-   return(button_press);
+   return(&buttons_debounce[tmp_button]);
 }
 
 
 /**
-* @brief Check if mode button has been pressed
+* @brief Clear the accepted and rejected edge counters of every EXTI button
 * @param[in] NONE
 * @return NONE
-*
 */
-uint8_t
-button_mode_status(void)
+void
+button_reset_debounce_counts(void)
 {
-   return(buttons_mode_detection);
+   uint32_t tmp_primask = __get_PRIMASK();
+
+   //The counters are read-modify-written by the EXTI handlers
+   __disable_irq();
+   for(uint8_t button = 0; button < max_button; button++)
+   {
+      debounce_reset_counts(&buttons_debounce[button]);
+   }
+   __set_PRIMASK(tmp_primask);
 }
 
 
 /**
-* @brief Reset the button flag so it can be used again
+* @brief Initialize external button as an interrupt pin
 * @param[in] NONE
 * @return NONE
 *
 */
 void
-button_mode_reset(void)
+button_manual_init(void)
 {
-	buttons_mode_detection = 0;
+   //Initialize pin to input, no pull-up/down, low speed
+   gpio_gen_input_init(BUTTON_MANUAL);
+   debounce_init(&buttons_debounce[button_manual], DEBOUNCE_WINDOW_US, gpio_read_pin(BUTTON_MANUAL));
+
+   //Unmask interrupt for pin 3
+   EXTI -> IMR |= EXTI_IMR_IM3;
+
+   //Set pin as an interrupt
+   SYSCFG -> EXTICR[0] |= SYSCFG_EXTICR1_EXTI3_PC; //Tie port C to interrupt line 3
+   EXTI->RTSR |= EXTI_RTSR_TR3; // Trigger pin 3 on both edges, the magnet follows the button level
+   EXTI->FTSR |= EXTI_FTSR_TR3;
+   NVIC_SetPriority(EXTI3_IRQn, EVENT_QUEUE_IRQ_PRIORITY); // Same priority as every other event producer
+   NVIC_EnableIRQ(EXTI3_IRQn);
 }
 
 /**
-* @brief Check if auto button has been pressed
+* @brief Check if manual button is currently being pressed
 * @param[in] NONE
-* @return NONE
+* @return Debounced level, 1 while pressed
 *
 */
 uint8_t
-button_auto_status(void)
+button_manual_status(void)
 {
-   return(buttons_auto_detection);
-}
+   uint8_t button_press = buttons_debounce[button_manual].level;
 
+   return(button_press);
+}
 
+#if BUTTONS_SCAN
 /**
-* @brief Reset the button flag so it can be used again
+* @brief Initialize every button as a plain input, debounced by sampling the
+*        whole port from the timer 6 tick. Replaces the button_x_init calls
 * @param[in] NONE
 * @return NONE
-*
 */
 void
-button_auto_reset(void)
+button_scan_init(void)
 {
-	buttons_auto_detection = 0;
-}
+   const s_timers_config tmp_config = {BUTTONS_TIM6_PSC, BUTTONS_TIM6_ARR};
 
+   //Initialize pins to input, no pull-up/down, low speed. They all have external pull downs
+   gpio_gen_input_init(BUTTON_MAIN_MODE);
+   gpio_gen_input_init(BUTTON_AUTO_MODE);
+   gpio_gen_input_init(BUTTON_LED);
+   gpio_gen_input_init(BUTTON_MANUAL);
 
+   debounce_vertical_init(&buttons_scan, (uint16_t)BUTTONS_PORT->IDR);
 
-/**
-* @brief Check if led button has been pressed
-* @param[in] NONE
-* @return NONE
-*
-*/
-uint8_t
-button_led_status(void)
-{
-   return(buttons_led_detection);
+   //Only the counters are used, the vertical counter does the debouncing
+   for(uint8_t button = 0; button < max_button; button++)
+   {
+      debounce_init(&buttons_debounce[button], 0, (buttons_scan.state >> buttons_pins[button]) & 1U);
+   }
+
+   timers_init(timers_tim6, &tmp_config);
+   timers_update_irq_enable(timers_tim6, EVENT_QUEUE_IRQ_PRIORITY); // Same priority as every other event producer
+   timers_start(timers_tim6);
 }
 
+
 /**
-* @brief Reset the button flag so it can be used again
+* @brief Timer 6 tick, samples and debounces every button at once
 * @param[in] NONE
-* @return NONE
-*
+* @return  NONE
+* @note Not traced, it fires BUTTONS_SCAN_HZ times a second and would flush the trace buffer
 */
 void
-button_led_reset(void)
+TIM6_DAC_IRQHandler(void)
 {
-	buttons_led_detection = 0;
+   uint16_t tmp_pressed;
+   uint16_t tmp_released;
+
+   TIM6->SR = ~TIM_SR_UIF;
+
+   debounce_vertical_scan(&buttons_scan, (uint16_t)BUTTONS_PORT->IDR, &tmp_pressed, &tmp_released);
+
+   //Nearly every tick ends here
+   if(tmp_pressed | tmp_released)
+   {
+      button_scan_edges(tmp_pressed, tmp_released);
+   }
 }
+#endif
 
 
 /**
-* @brief ISR that is called when PC0 experiences a
-*        rising edge (main mode button is pressed)
+* @brief ISR that is called when PC0 experiences an
+*        edge, queues the main mode button's presses and releases
 * @param[in] NONE
 * @return  NONE
 */
 void
 EXTI0_IRQHandler(void)
 {
-   buttons_mode_detection = 1;
+   TRACE(trace_id_isr_enter, trace_isr_exti0, 0);
 
-   //Clear interrupt flag
+   //Clear interrupt flag first, so an edge landing while this runs is not lost
    EXTI->PR = EXTI_PR_PR0;
+
+   button_edge(button_mode, gpio_read_pin(BUTTON_MAIN_MODE));
+
+   TRACE(trace_id_isr_exit, trace_isr_exti0, 0);
 }
 
 /**
-* @brief ISR that is called when PC1 experiences a
-*        rising edge (automatic mode button is pressed)
+* @brief ISR that is called when PC1 experiences an
+*        edge, queues the automatic mode button's presses and releases
 * @param[in] NONE
 * @return  NONE
 */
 void
 EXTI1_IRQHandler(void)
 {
-   buttons_auto_detection = 1;
+   TRACE(trace_id_isr_enter, trace_isr_exti1, 0);
 
-   //Clear interrupt flag
+   //Clear interrupt flag first, so an edge landing while this runs is not lost
    EXTI->PR = EXTI_PR_PR1;
+
+   button_edge(button_auto, gpio_read_pin(BUTTON_AUTO_MODE));
+
+   TRACE(trace_id_isr_exit, trace_isr_exti1, 0);
 }
 
 /**
-* @brief ISR that is called when PC2 experiences a
-*        rising edge (led button is pressed)
+* @brief ISR that is called when PC2 experiences an
+*        edge, queues the led button's presses and releases
 * @param[in] NONE
 * @return  NONE
 */
 void
 EXTI2_IRQHandler(void)
 {
-   buttons_led_detection = 1;
+   TRACE(trace_id_isr_enter, trace_isr_exti2, 0);
 
-   //Clear interrupt flag
+   //Clear interrupt flag first, so an edge landing while this runs is not lost
    EXTI->PR = EXTI_PR_PR2;
+
+   button_edge(button_led, gpio_read_pin(BUTTON_LED));
+
+   TRACE(trace_id_isr_exit, trace_isr_exti2, 0);
+}
+
+/**
+* @brief ISR that is called when PC3 experiences an
+*        edge, switches the magnet while in the manual state
+* @param[in] NONE
+* @return  NONE
+*/
+void
+EXTI3_IRQHandler(void)
+{
+   TRACE(trace_id_isr_enter, trace_isr_exti3, 0);
+
+   //Clear interrupt flag first, so an edge landing while this runs is not lost
+   EXTI->PR = EXTI_PR_PR3;
+
+   button_edge(button_manual, gpio_read_pin(BUTTON_MANUAL));
+
+   TRACE(trace_id_isr_exit, trace_isr_exti3, 0);
+}
+
+
+/**
+* @brief Timestamp an edge, run it through the button's debouncer and pass on what it turned out to be
+* @param[in] tmp_button Button the edge was seen on
+* @param[in] tmp_level Pin level read right after the edge
+* @return NONE
+* @note Called from the EXTI handlers. A clean edge costs a few loads and compares on top of
+*       the timestamp, only a rejected one arms the settle check
+*/
+void
+button_edge(e_button tmp_button, uint8_t tmp_level)
+{
+   uint32_t tmp_settle_us = buttons_debounce[tmp_button].window_us;
+   e_debounce_edge tmp_edge = debounce_edge(&buttons_debounce[tmp_button], system_clock_get_us(), tmp_level);
+
+   if(debounce_none != tmp_edge)
+   {
+      button_deliver(tmp_button, tmp_edge);
+      return;
+   }
+
+   //A dropped edge may have been a quick release, look at the pin again once it has been quiet
+   if(DELAY_CALLBACK_MAX_US < tmp_settle_us)
+   {
+      tmp_settle_us = DELAY_CALLBACK_MAX_US;
+   }
+
+   delay_cancel(button_settle, (void *)(uintptr_t)tmp_button);
+   delay_call_in_us(tmp_settle_us ? tmp_settle_us : 1UL, button_settle, (void *)(uintptr_t)tmp_button);
+}
+
+
+/**
+* @brief Pass a debounced press or release on to whoever handles that button
+* @param[in] tmp_button Button the edge belongs to
+* @param[in] tmp_edge Debounced edge, debounce_none does nothing
+* @return NONE
+* @note Must run at EVENT_QUEUE_IRQ_PRIORITY, or with interrupts masked
+*/
+void
+button_deliver(e_button tmp_button, e_debounce_edge tmp_edge)
+{
+   if(debounce_none == tmp_edge)
+   {
+      return;
+   }
+
+   if(button_manual == tmp_button)
+   {
+      //Straight to the magnet rather than through the event queue, like the timer 5 tick
+      if(input_replay_capture(input_replay_source_event, event_type_button_manual, tmp_edge))
+      {
+         states_manual_edge((debounce_press == tmp_edge) ? 1 : 0);
+      }
+      return;
+   }
+
+   event_queue_push(buttons_events[tmp_button], tmp_edge);
+   scheduler_signal(scheduler_task_states);
+}
+
+
+/**
+* @brief Delay callback, a window after a button's last rejected edge. Catches a level
+*        change whose edge was dropped as a bounce
+* @param[in] p_context e_button
+* @return NONE
+*/
+void
+button_settle(void * p_context)
+{
+   e_button tmp_button = (e_button)(uintptr_t)p_context;
+   uint32_t tmp_primask = __get_PRIMASK();
+
+   //Runs at the delay priority, below the EXTI handlers that share the debouncer and the event queue
+   __disable_irq();
+   button_deliver(tmp_button, debounce_settle(&buttons_debounce[tmp_button],
+                                              gpio_read_pin(BUTTONS_PORT, buttons_pins[tmp_button])));
+   __set_PRIMASK(tmp_primask);
+}
+
+
+#if BUTTONS_SCAN
+/**
+* @brief Turn the edge masks of one scan into counts and button edges
+* @param[in] tmp_pressed Pins that just settled high
+* @param[in] tmp_released Pins that just settled low
+* @return NONE
+*/
+void
+button_scan_edges(uint16_t tmp_pressed, uint16_t tmp_released)
+{
+   for(uint8_t button = 0; button < max_button; button++)
+   {
+      uint16_t tmp_mask = (uint16_t)(1U << buttons_pins[button]);
+
+      if(tmp_mask & (tmp_pressed | tmp_released))
+      {
+         buttons_debounce[button].accepted++;
+         buttons_debounce[button].level = (tmp_mask & tmp_pressed) ? 1 : 0;
+         button_deliver(button, (tmp_mask & tmp_pressed) ? debounce_press : debounce_release);
+      }
+   }
 }
+#endif
 
 
 /*** end of file ***/
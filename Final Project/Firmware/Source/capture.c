@@ -0,0 +1,396 @@
+/** @file capture.c
+*
+* @brief  This file contains the timer 5 input capture service, period and duty of an external signal
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "capture.h"
+#include "timers.h"
+#include "soft_timers.h"
+#include "base_gpio_drivers.h"
+#include <stddef.h>
+
+/*
+* Timer 5 keeps free running as the magnet tick, so captures are timestamps modulo ARR + 1 rather
+* than the counter being reset on each edge. Both capture channels listen to the same pin, CH1 on
+* the rising edge and CH2 on the falling one, and DMA copies every capture into a ring per channel.
+* Nothing happens per edge on the CPU, a soft timer drains the rings every CAPTURE_POLL_MS.
+* Periods have to stay under one timer 5 wrap, 100ms at the 10Hz magnet step rate.
+*/
+
+#define CAPTURE_RING_MASK (CAPTURE_RING_SIZE - 1U)
+
+_Static_assert(0 == (CAPTURE_RING_SIZE & CAPTURE_RING_MASK), "CAPTURE_RING_SIZE must be a power of two");
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void capture_poll(void * p_context);
+void capture_pair(const volatile uint32_t * p_rises, const volatile uint32_t * p_falls,
+                  uint32_t tmp_rise_head, uint32_t tmp_fall_head, uint64_t tmp_modulus);
+uint32_t capture_elapsed(uint32_t tmp_from, uint32_t tmp_to, uint64_t tmp_modulus);
+void capture_record(uint32_t tmp_period, uint32_t tmp_high, uint8_t tmp_high_valid);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static volatile uint32_t capture_rises[CAPTURE_RING_SIZE]; //Written by DMA1 stream 2
+static volatile uint32_t capture_falls[CAPTURE_RING_SIZE]; //Written by DMA1 stream 4
+static uint32_t capture_rise_tail = 0;   //Next ring entries to process
+static uint32_t capture_fall_tail = 0;
+static uint32_t capture_prev_rise = 0;
+static uint8_t capture_have_prev = 0;
+static uint8_t capture_running = 0;
+static uint64_t capture_avg_period_fp = 0; //Average << CAPTURE_AVG_SHIFT
+static uint32_t capture_avg_duty_fp = 0;
+static s_capture_stats capture_stats;
+static s_soft_timer capture_timer;
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Routes PA0 to timer 5 and sets channels 1 and 2 up to capture its edges into DMA rings
+* @param[in] NONE
+* @return NONE
+* @note Call after timers_timer5_init and soft_timers_init. Capturing starts with capture_start
+*/
+void
+capture_init(void)
+{
+   gpio_clk_init(CAPTURE_PIN);
+   gpio_func_init(CAPTURE_PIN, GPIO_MODER_ALTERNATE_FUNCTION);
+   gpio_pupd_init(CAPTURE_PIN, GPIO_PUPDR_NONE);
+   gpio_af_init(CAPTURE_PIN, CAPTURE_AF_TIM5);
+
+   //IC1 on TI1 rising, IC2 also on TI1 but falling, both filtered
+   TIM5->CCMR1 &= ~0xFFFFUL;
+   TIM5->CCMR1 |= TIM_CCMR1_CC1S_0 | TIM_CCMR1_CC2S_1 |
+                  (CAPTURE_FILTER << TIM_CCMR1_IC1F_Pos) | (CAPTURE_FILTER << TIM_CCMR1_IC2F_Pos);
+   TIM5->CCER &= ~(TIM_CCER_CC1P | TIM_CCER_CC1NP | TIM_CCER_CC2NP);
+   TIM5->CCER |= TIM_CCER_CC2P;
+
+   RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+
+   //Word sized, peripheral to memory, circular, so the rings refill forever with no interrupt
+   DMA1_Stream2->CR = 0;
+   DMA1_Stream2->PAR = (uint32_t)(uintptr_t)&(TIM5->CCR1);
+   DMA1_Stream2->M0AR = (uint32_t)(uintptr_t)capture_rises;
+   DMA1_Stream4->CR = 0;
+   DMA1_Stream4->PAR = (uint32_t)(uintptr_t)&(TIM5->CCR2);
+   DMA1_Stream4->M0AR = (uint32_t)(uintptr_t)capture_falls;
+
+   capture_reset();
+}
+
+
+/*!
+* @brief Starts capturing edges and draining the rings
+* @param[in] NONE
+* @return NONE
+*/
+void
+capture_start(void)
+{
+   if(capture_running)
+   {
+      return;
+   }
+
+   DMA1->LIFCR = DMA_LIFCR_CTCIF2 | DMA_LIFCR_CHTIF2 | DMA_LIFCR_CTEIF2 | DMA_LIFCR_CDMEIF2 | DMA_LIFCR_CFEIF2;
+   DMA1->HIFCR = DMA_HIFCR_CTCIF4 | DMA_HIFCR_CHTIF4 | DMA_HIFCR_CTEIF4 | DMA_HIFCR_CDMEIF4 | DMA_HIFCR_CFEIF4;
+
+   DMA1_Stream2->NDTR = CAPTURE_RING_SIZE;
+   DMA1_Stream2->CR = CAPTURE_DMA_CHSEL_TIM5 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC | DMA_SxCR_CIRC;
+   DMA1_Stream4->NDTR = CAPTURE_RING_SIZE;
+   DMA1_Stream4->CR = CAPTURE_DMA_CHSEL_TIM5 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC | DMA_SxCR_CIRC;
+   DMA1_Stream2->CR |= DMA_SxCR_EN;
+   DMA1_Stream4->CR |= DMA_SxCR_EN;
+
+   capture_rise_tail = 0;
+   capture_fall_tail = 0;
+   capture_have_prev = 0;
+
+   TIM5->DIER |= TIM_DIER_CC1DE | TIM_DIER_CC2DE;
+   TIM5->CCER |= TIM_CCER_CC1E | TIM_CCER_CC2E;
+
+   capture_running = 1;
+   soft_timer_start(&capture_timer, CAPTURE_POLL_MS, CAPTURE_POLL_MS, capture_poll, 0);
+}
+
+
+/*!
+* @brief Stops capturing, the statistics are kept
+* @param[in] NONE
+* @return NONE
+*/
+void
+capture_stop(void)
+{
+   soft_timer_stop(&capture_timer);
+
+   TIM5->CCER &= ~(TIM_CCER_CC1E | TIM_CCER_CC2E);
+   TIM5->DIER &= ~(TIM_DIER_CC1DE | TIM_DIER_CC2DE);
+
+   DMA1_Stream2->CR &= ~DMA_SxCR_EN;
+   DMA1_Stream4->CR &= ~DMA_SxCR_EN;
+
+   capture_running = 0;
+}
+
+
+/*!
+* @brief Tells whether edges are being captured
+* @param[in] NONE
+* @return 1 between capture_start and capture_stop
+*/
+uint8_t
+capture_is_running(void)
+{
+   return capture_running;
+}
+
+
+/*!
+* @brief Clears the statistics
+* @param[in] NONE
+* @return NONE
+* @note The next period measured seeds the averages
+*/
+void
+capture_reset(void)
+{
+   capture_stats.periods = 0;
+   capture_stats.last_period = 0;
+   capture_stats.min_period = UINT32_MAX;
+   capture_stats.max_period = 0;
+   capture_stats.avg_period = 0;
+   capture_stats.last_duty = 0;
+   capture_stats.avg_duty = 0;
+   capture_stats.overruns = 0;
+   capture_avg_period_fp = 0;
+   capture_avg_duty_fp = 0;
+}
+
+
+/*!
+* @brief Copies the statistics
+* @param[out] p_stats Filled with the statistics as of the last poll
+* @return NONE
+*/
+void
+capture_get_stats(s_capture_stats * p_stats)
+{
+   *p_stats = capture_stats;
+}
+
+
+/*!
+* @brief Gets the signal frequency from the average period
+* @param[in] NONE
+* @return Frequency in millihertz, 0 before a period has been measured
+*/
+uint32_t
+capture_get_mhz(void)
+{
+   if(0 == capture_stats.avg_period)
+   {
+      return 0;
+   }
+
+   return (uint32_t)((1000ULL * timers_get_instance(timers_tim5)->clock_hz) /
+                     (((uint64_t)TIM5->PSC + 1U) * capture_stats.avg_period));
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Soft timer callback, hands the edges DMA has written since the last poll to capture_pair
+* @param[in] p_context Unused
+* @return NONE
+*/
+void
+capture_poll(void * p_context)
+{
+   capture_pair(capture_rises, capture_falls,
+                (CAPTURE_RING_SIZE - DMA1_Stream2->NDTR) & CAPTURE_RING_MASK,
+                (CAPTURE_RING_SIZE - DMA1_Stream4->NDTR) & CAPTURE_RING_MASK,
+                (uint64_t)TIM5->ARR + 1U);
+}
+
+
+/*!
+* @brief Turns every new edge in the rings into a period and a duty
+* @param[in] p_rises Ring of rising edge captures
+* @param[in] p_falls Ring of falling edge captures
+* @param[in] tmp_rise_head Next entry DMA writes in p_rises
+* @param[in] tmp_fall_head Next entry DMA writes in p_falls
+* @param[in] tmp_modulus Timer 5 ARR + 1
+* @return NONE
+* @note Touches no registers, the host test feeds it synthetic rings
+*/
+void
+capture_pair(const volatile uint32_t * p_rises, const volatile uint32_t * p_falls,
+             uint32_t tmp_rise_head, uint32_t tmp_fall_head, uint64_t tmp_modulus)
+{
+   uint32_t tmp_rise;
+   uint32_t tmp_fall;
+   uint32_t tmp_period;
+   uint32_t tmp_high;
+   uint8_t tmp_high_valid;
+
+   //A ring this full may already have wrapped past the tail, drop it all and resync
+   if(((tmp_rise_head - capture_rise_tail) & CAPTURE_RING_MASK) >= (CAPTURE_RING_SIZE - 1U))
+   {
+      capture_stats.overruns++;
+      capture_rise_tail = tmp_rise_head;
+      capture_fall_tail = tmp_fall_head;
+      capture_have_prev = 0;
+      return;
+   }
+
+   while(capture_rise_tail != tmp_rise_head)
+   {
+      tmp_rise = p_rises[capture_rise_tail];
+      capture_rise_tail = (capture_rise_tail + 1U) & CAPTURE_RING_MASK;
+
+      if(capture_have_prev)
+      {
+         tmp_period = capture_elapsed(capture_prev_rise, tmp_rise, tmp_modulus);
+         tmp_high_valid = 0;
+         tmp_high = 0;
+
+         //The high time is the first fall after the previous rise, if it came before this one
+         while(capture_fall_tail != tmp_fall_head)
+         {
+            tmp_fall = p_falls[capture_fall_tail];
+            tmp_high = capture_elapsed(capture_prev_rise, tmp_fall, tmp_modulus);
+
+            if(tmp_high < tmp_period)
+            {
+               capture_fall_tail = (capture_fall_tail + 1U) & CAPTURE_RING_MASK;
+               tmp_high_valid = 1;
+               break;
+            }
+            else if(capture_elapsed(tmp_fall, capture_prev_rise, tmp_modulus) < (tmp_modulus / 2U))
+            {
+               //Fell before the previous rise, left over from a period that was skipped
+               capture_fall_tail = (capture_fall_tail + 1U) & CAPTURE_RING_MASK;
+            }
+            else
+            {
+               //Belongs to a later period, no fall in this one (100% or 0% duty)
+               break;
+            }
+         }
+
+         if(0 != tmp_period)
+         {
+            capture_record(tmp_period, tmp_high, tmp_high_valid);
+         }
+      }
+
+      capture_prev_rise = tmp_rise;
+      capture_have_prev = 1;
+   }
+}
+
+
+/*!
+* @brief Counts from one timestamp to a later one on a counter that wraps at tmp_modulus
+* @param[in] tmp_from Earlier capture
+* @param[in] tmp_to Later capture
+* @param[in] tmp_modulus Timer 5 ARR + 1
+* @return Counts between them
+*/
+uint32_t
+capture_elapsed(uint32_t tmp_from, uint32_t tmp_to, uint64_t tmp_modulus)
+{
+   return (tmp_to >= tmp_from) ? (tmp_to - tmp_from) : (uint32_t)((tmp_modulus - tmp_from) + tmp_to);
+}
+
+
+/*!
+* @brief Folds one measured period into the statistics
+* @param[in] tmp_period Rising to rising counts, not 0
+* @param[in] tmp_high Rising to falling counts
+* @param[in] tmp_high_valid 0 if no fall was seen in the period, the duty is then left alone
+* @return NONE
+*/
+void
+capture_record(uint32_t tmp_period, uint32_t tmp_high, uint8_t tmp_high_valid)
+{
+   uint32_t tmp_duty;
+
+   if(0 == capture_stats.periods)
+   {
+      capture_avg_period_fp = (uint64_t)tmp_period << CAPTURE_AVG_SHIFT;
+   }
+   else
+   {
+      capture_avg_period_fp -= capture_avg_period_fp >> CAPTURE_AVG_SHIFT;
+      capture_avg_period_fp += tmp_period;
+   }
+
+   capture_stats.periods++;
+   capture_stats.last_period = tmp_period;
+   capture_stats.avg_period = (uint32_t)(capture_avg_period_fp >> CAPTURE_AVG_SHIFT);
+
+   if(tmp_period < capture_stats.min_period)
+   {
+      capture_stats.min_period = tmp_period;
+   }
+   if(tmp_period > capture_stats.max_period)
+   {
+      capture_stats.max_period = tmp_period;
+   }
+
+   if(tmp_high_valid)
+   {
+      tmp_duty = (uint32_t)(((uint64_t)tmp_high * 1000U) / tmp_period);
+
+      capture_avg_duty_fp = (0 == capture_avg_duty_fp) ? (tmp_duty << CAPTURE_AVG_SHIFT) :
+                            (capture_avg_duty_fp + tmp_duty - (capture_avg_duty_fp >> CAPTURE_AVG_SHIFT));
+      capture_stats.last_duty = (uint16_t)tmp_duty;
+      capture_stats.avg_duty = (uint16_t)(capture_avg_duty_fp >> CAPTURE_AVG_SHIFT);
+   }
+}
+
+
+/* end of file */
@@ -9,6 +9,7 @@
 #include "console.h"
 #include "consoleIo.h"
 #include "consoleCommands.h"
+#include "trace.h"
 
 #ifndef MIN
   #define MIN(X, Y)		(((X) < (Y)) ? (X) : (Y))
@@ -63,6 +64,11 @@ static uint32_t ConsoleCommandMatch(const char* name, const char *buffer)
 		}
 		i++;
 	}
+	// the buffer word ended, make sure the name did too ("he" is not "help")
+	if ( ( 1u == result ) && ( NULL_CHAR != name[i] ) )
+	{
+		result = 0u;
+	}
 
 	return result;
 }
@@ -97,8 +103,9 @@ static int32_t ConsoleCommandEndline(const char receiveBuffer[], const  uint32_t
 	uint32_t i = 0;
 	int32_t result = NOT_FOUND; // if no endline is found, then return -1 (NOT_FOUND)
 
-	while ( ( CR_CHAR != receiveBuffer[i])  && (LF_CHAR != receiveBuffer[i])
-			&& ( i < filledLength ) )
+	// check the length first so a full buffer is never read one past its end
+	while ( ( i < filledLength ) && ( CR_CHAR != receiveBuffer[i])
+			&& (LF_CHAR != receiveBuffer[i]) )
 	{
 		i++;
 	}
@@ -155,6 +162,7 @@ void ConsoleProcess(void)
 			{
 				if ( ConsoleCommandMatch(commandTable[cmdIndex].name, mReceiveBuffer) )
 				{
+					TRACE(trace_id_command, cmdIndex, 0);
 					result = commandTable[cmdIndex].execute(mReceiveBuffer);
 					if ( COMMAND_SUCCESS != result )
 					{
@@ -188,27 +196,43 @@ void ConsoleProcess(void)
 			mReceiveBufferNeedsChecking = mReceivedSoFar > 0 ? true : false;
 			ConsoleIoSendString(CONSOLE_PROMPT);
 		}
+		else if ( mReceivedSoFar >= CONSOLE_COMMAND_MAX_LENGTH )
+		{
+			// full with no endline, nothing can ever complete this command so drop it
+			mReceivedSoFar = ConsoleResetBuffer(mReceiveBuffer, mReceivedSoFar, mReceivedSoFar);
+			ConsoleIoSendString("Command too long.");
+			ConsoleIoSendString(STR_ENDLINE);
+			ConsoleIoSendString(CONSOLE_PROMPT);
+		}
 	}
 }
 
 // ConsoleParamFindN
 // Find the start location of the nth parametr in the buffer where the command itself is parameter 0
+// The search stops at the end of the current line, the buffer may already hold the next command
+// and its separators must not be counted as parameters of this one.
 static eCommandResult_T ConsoleParamFindN(const char * buffer, const uint8_t parameterNumber, uint32_t *startLocation)
 {
 	uint32_t bufferIndex = 0;
 	uint32_t parameterIndex = 0;
 	eCommandResult_T result = COMMAND_SUCCESS;
+	char charVal;
 
 
 	while ( ( parameterNumber != parameterIndex ) && ( bufferIndex < CONSOLE_COMMAND_MAX_LENGTH ) )
 	{
-		if ( PARAMETER_SEPARATER == buffer[bufferIndex] )
+		charVal = buffer[bufferIndex];
+		if ( ( LF_CHAR == charVal ) || ( CR_CHAR == charVal ) || ( NULL_CHAR == charVal ) )
+		{
+			break;
+		}
+		if ( PARAMETER_SEPARATER == charVal )
 		{
 			parameterIndex++;
 		}
 		bufferIndex++;
 	}
-	if  ( CONSOLE_COMMAND_MAX_LENGTH == bufferIndex )
+	if  ( ( parameterNumber != parameterIndex ) || ( CONSOLE_COMMAND_MAX_LENGTH == bufferIndex ) )
 	{
 		result = COMMAND_PARAMETER_ERROR;
 	}
@@ -232,18 +256,24 @@ eCommandResult_T ConsoleReceiveParamInt16(const char * buffer, const uint8_t par
 	char str[INT16_MAX_STR_LENGTH];
 
 	result = ConsoleParamFindN(buffer, parameterNumber, &startIndex);
+	if ( COMMAND_SUCCESS != result )
+	{
+		return result;
+	}
 
+	// copy at most INT16_MAX_STR_LENGTH - 1 characters so the NULL always fits,
+	// and never read past the end of the receive buffer
 	i = 0;
 	charVal = buffer[startIndex + i];
 	while ( ( LF_CHAR != charVal ) && ( CR_CHAR != charVal )
-			&& ( PARAMETER_SEPARATER != charVal )
-		&& ( i < INT16_MAX_STR_LENGTH ) )
+			&& ( PARAMETER_SEPARATER != charVal ) && ( NULL_CHAR != charVal )
+		&& ( i < ( INT16_MAX_STR_LENGTH - 1u ) ) )
 	{
 		str[i] = charVal;					// copy the relevant part
 		i++;
-		charVal = buffer[startIndex + i];
+		charVal = ( ( startIndex + i ) < CONSOLE_COMMAND_MAX_LENGTH ) ? buffer[startIndex + i] : NULL_CHAR;
 	}
-	if ( i == INT16_MAX_STR_LENGTH)
+	if ( ( 0u == i ) || ( ( INT16_MAX_STR_LENGTH - 1u ) == i ) )
 	{
 		result = COMMAND_PARAMETER_ERROR;
 	}
@@ -273,6 +303,10 @@ eCommandResult_T ConsoleReceiveParamHexUint16(const char * buffer, const uint8_t
 		// next separator or newline or NULL indicates end of parameter
 		for ( i = 0u ; i < 4u ; i ++)   // U16 must be less than 4 hex digits: 0xFFFF
 		{
+			if ( ( COMMAND_SUCCESS == result ) && ( ( startIndex + i ) >= CONSOLE_COMMAND_MAX_LENGTH ) )
+			{
+				result = COMMAND_PARAMETER_END;
+			}
 			if ( COMMAND_SUCCESS == result )
 			{
 				result = ConsoleUtilHexCharToInt(buffer[startIndex + i], &tmpUint8);
@@ -421,8 +455,8 @@ static eCommandResult_T ConsoleUtilHexCharToInt(char charVal, uint8_t* pInt)
     {
         *pInt = 10u + charVal - 'a';
     }
-	else if ( ( LF_CHAR != charVal ) || ( CR_CHAR != charVal )
-			|| ( PARAMETER_SEPARATER == charVal ) )
+	else if ( ( LF_CHAR == charVal ) || ( CR_CHAR == charVal )
+			|| ( PARAMETER_SEPARATER == charVal ) || ( NULL_CHAR == charVal ) )
 	{
 		result = COMMAND_PARAMETER_END;
 
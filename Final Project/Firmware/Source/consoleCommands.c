@@ -7,6 +7,7 @@
 //		3. Implement the function, using ConsoleReceiveParam<Type> to get the parameters from the buffer.
 
 #include <string.h>
+#include <stdbool.h>
 #include "consoleCommands.h"
 #include "console.h"
 #include "consoleIo.h"
@@ -18,6 +19,16 @@ static eCommandResult_T ConsoleCommandHelp(const char buffer[]);
 static eCommandResult_T ConsoleCommandLedOn(const char buffer[]);
 static eCommandResult_T ConsoleCommandLedOff(const char buffer[]);
 static eCommandResult_T ConsoleCommandState(const char buffer[]);
+static eCommandResult_T ConsoleCommandTasks(const char buffer[]);
+static eCommandResult_T ConsoleCommandWrites(const char buffer[]);
+static eCommandResult_T ConsoleCommandProf(const char buffer[]);
+static eCommandResult_T ConsoleCommandTrace(const char buffer[]);
+static eCommandResult_T ConsoleCommandReplay(const char buffer[]);
+static eCommandResult_T ConsoleCommandKernel(const char buffer[]);
+static eCommandResult_T ConsoleCommandAnim(const char buffer[]);
+static eCommandResult_T ConsoleCommandPod(const char buffer[]);
+static eCommandResult_T ConsoleCommandCapture(const char buffer[]);
+static eCommandResult_T ConsoleCommandButtons(const char buffer[]);
 
 static const sConsoleCommandTable_T mConsoleCommandTable[] =
 {
@@ -25,10 +36,56 @@ static const sConsoleCommandTable_T mConsoleCommandTable[] =
     {"ledOn", &ConsoleCommandLedOn, HELP("Turns the onboard LED on")},
     {"ledOff", &ConsoleCommandLedOff, HELP("Turns the onboard LED off")},
     {"state", &ConsoleCommandState, HELP("Prints the current state to the console")},
+    {"tasks", &ConsoleCommandTasks, HELP("Task runs/WCET, sleep and wake latency. 'tasks reset'")},
+    {"writes", &ConsoleCommandWrites, HELP("Peripheral register writes, total and per sec. 'writes reset'")},
+    {"prof", &ConsoleCommandProf, HELP("Loop stage cycles min/avg/max and log2 histogram. 'prof reset'")},
+    {"kernel", &ConsoleCommandKernel, HELP("Switch cost, thread jitter and stack. 'kernel reset'")},
+    {"replay", &ConsoleCommandReplay, HELP("Inputs. 'replay record', 'play', 'fast', 'stop'")},
+    {"trace", &ConsoleCommandTrace, HELP("Event recorder. 'trace start', 'trace stop', 'trace dump'")},
+    {"anim", &ConsoleCommandAnim, HELP("LED. 'anim breathe|fadein|fadeout|blink|off [ms] [%] [gamma10]'")},
+    {"pod", &ConsoleCommandPod, HELP("Jelly pod LED. 'pod 1-4 level|breathe|...|off [ms] [%] [g10]'")},
+    {"capture", &ConsoleCommandCapture, HELP("PA0 period/duty. 'capture start', 'stop', 'reset'")},
+    {"buttons", &ConsoleCommandButtons, HELP("Debounce edges. 'buttons reset', 'buttons <window ms>'")},
 
 	CONSOLE_COMMAND_TABLE_END // must be LAST
 };
 
+// ConsoleCommandParamNIs
+// True if parameter number (1 is the first after the command) is exactly word, e.g. "pod 2 blink"
+static bool ConsoleCommandParamNIs(const char buffer[], uint8_t number, const char* word)
+{
+	uint32_t i = 0u;
+	uint32_t length = strlen(word);
+
+	while ( number > 0u )
+	{
+		while ( ( i < CONSOLE_COMMAND_MAX_LENGTH ) && ( ' ' != buffer[i] ) &&
+				( '\r' != buffer[i] ) && ( '\n' != buffer[i] ) && ( '\0' != buffer[i] ) )
+		{
+			i++;
+		}
+		if ( ( i + 1u + length ) >= CONSOLE_COMMAND_MAX_LENGTH || ( ' ' != buffer[i] ) )
+		{
+			return false;
+		}
+		i++;
+		number--;
+	}
+	if ( 0 != strncmp(&buffer[i], word, length) )
+	{
+		return false;
+	}
+	i += length;
+	return ( ( ' ' == buffer[i] ) || ( '\r' == buffer[i] ) || ( '\n' == buffer[i] ) || ( '\0' == buffer[i] ) );
+}
+
+// ConsoleCommandParamIs
+// True if the first parameter on this line is exactly word, e.g. "tasks reset"
+static bool ConsoleCommandParamIs(const char buffer[], const char* word)
+{
+	return ConsoleCommandParamNIs(buffer, 1u, word);
+}
+
 static eCommandResult_T ConsoleCommandComment(const char buffer[])
 {
 	// do nothing
@@ -105,8 +162,8 @@ static eCommandResult_T ConsoleCommandLedOn(const char buffer[])
 
 
 	IGNORE_UNUSED_VARIABLE(buffer);
-	led_set_mag(LED_MAG_MED);
-	uart1_printf("\r\n LED is now on \n\r\0");
+	led_set_level(LED_LEVEL_MED);
+	ConsoleIoSendString("\r\n LED is now on \n\r");
 
 	return(result);
 }
@@ -119,7 +176,7 @@ static eCommandResult_T ConsoleCommandLedOff(const char buffer[])
 	IGNORE_UNUSED_VARIABLE(buffer);
 
 	led_set_mag(LED_MAG_OFF);
-	uart1_printf("\r\n LED is now off \n\r\0");
+	ConsoleIoSendString("\r\n LED is now off \n\r");
 
 	return(result);
 }
@@ -135,6 +192,379 @@ static eCommandResult_T ConsoleCommandState(const char buffer[])
 	return(result);
 }
 
+static eCommandResult_T ConsoleCommandTasks(const char buffer[])
+{
+	eCommandResult_T result = COMMAND_SUCCESS;
+	uint32_t i;
+	uint32_t wakeLast;
+	uint32_t wakeMax;
+
+	for ( i = 0u ; i < max_scheduler_task ; i++ )
+	{
+		ConsoleIoSendString(scheduler_get_name(i));
+		ConsoleIoSendString(" runs: ");
+		ConsoleSendParamInt32(scheduler_get_run_count(i));
+		ConsoleIoSendString(" wcet: ");
+		ConsoleSendParamInt32(scheduler_get_wcet(i));
+		ConsoleIoSendString(STR_ENDLINE);
+	}
+
+	scheduler_get_wake_latency(&wakeLast, &wakeMax);
+	ConsoleIoSendString("asleep (0.1%): ");
+	ConsoleSendParamInt32(scheduler_get_sleep_permille());
+	ConsoleIoSendString(" wake latency last: ");
+	ConsoleSendParamInt32(wakeLast);
+	ConsoleIoSendString(" max: ");
+	ConsoleSendParamInt32(wakeMax);
+	ConsoleIoSendString(STR_ENDLINE);
+
+	if ( ConsoleCommandParamIs(buffer, "reset") )
+	{
+		scheduler_reset_stats();
+	}
+
+	return(result);
+}
+
+static eCommandResult_T ConsoleCommandWrites(const char buffer[])
+{
+	eCommandResult_T result = COMMAND_SUCCESS;
+	uint32_t i;
+
+	for ( i = 0u ; i < max_io_stats_periph ; i++ )
+	{
+		ConsoleIoSendString(io_stats_get_name(i));
+		ConsoleIoSendString(" total: ");
+		ConsoleSendParamInt32(io_stats_get_total(i));
+		ConsoleIoSendString(" per second: ");
+		ConsoleSendParamInt32(io_stats_get_rate(i));
+		ConsoleIoSendString(STR_ENDLINE);
+	}
+
+	if ( ConsoleCommandParamIs(buffer, "reset") )
+	{
+		io_stats_reset();
+	}
+
+	return(result);
+}
+
+// One line of stats per stage, then the non-empty histogram buckets as "2^n:count"
+static eCommandResult_T ConsoleCommandProf(const char buffer[])
+{
+	eCommandResult_T result = COMMAND_SUCCESS;
+	uint32_t i;
+	uint8_t bucket;
+
+	for ( i = 0u ; i < max_profiler_stage ; i++ )
+	{
+		ConsoleIoSendString(profiler_get_name(i));
+		ConsoleIoSendString(" n: ");
+		ConsoleSendParamInt32(profiler_get_count(i));
+		ConsoleIoSendString(" min: ");
+		ConsoleSendParamInt32(profiler_get_min(i));
+		ConsoleIoSendString(" avg: ");
+		ConsoleSendParamInt32(profiler_get_avg(i));
+		ConsoleIoSendString(" max: ");
+		ConsoleSendParamInt32(profiler_get_max(i));
+		ConsoleIoSendString(STR_ENDLINE);
+
+		for ( bucket = 0u ; bucket < PROFILER_BUCKETS ; bucket++ )
+		{
+			if ( profiler_get_bucket(i, bucket) )
+			{
+				ConsoleIoSendString(" 2^");
+				ConsoleSendParamInt32(bucket);
+				ConsoleIoSendString(":");
+				ConsoleSendParamInt32(profiler_get_bucket(i, bucket));
+			}
+		}
+		ConsoleIoSendString(STR_ENDLINE);
+	}
+
+	if ( ConsoleCommandParamIs(buffer, "reset") )
+	{
+		profiler_reset();
+	}
+
+	return(result);
+}
+
+// The dump is raw binary on the same port, capture it and run Tools/trace2json.py
+static eCommandResult_T ConsoleCommandTrace(const char buffer[])
+{
+	eCommandResult_T result = COMMAND_SUCCESS;
+
+	if ( ConsoleCommandParamIs(buffer, "dump") )
+	{
+		trace_dump();
+		ConsoleIoSendString(STR_ENDLINE);
+	}
+	else
+	{
+		if ( ConsoleCommandParamIs(buffer, "start") )
+		{
+			trace_start();
+		}
+		else if ( ConsoleCommandParamIs(buffer, "stop") )
+		{
+			trace_stop();
+		}
+
+		ConsoleIoSendString("records: ");
+		ConsoleSendParamInt32(trace_get_count());
+		ConsoleIoSendString(" overwritten: ");
+		ConsoleSendParamInt32(trace_get_overwritten());
+		ConsoleIoSendString(STR_ENDLINE);
+	}
+
+	return(result);
+}
+
+// All times in CPU cycles, jitter is the spread of the time from semaphore give to thread running
+static eCommandResult_T ConsoleCommandKernel(const char buffer[])
+{
+	eCommandResult_T result = COMMAND_SUCCESS;
+	uint32_t i;
+	uint32_t min;
+	uint32_t max;
+
+	kernel_get_switch_cycles(&min, &max);
+	ConsoleIoSendString("switches: ");
+	ConsoleSendParamInt32(kernel_get_switch_count());
+	ConsoleIoSendString(" cost min: ");
+	ConsoleSendParamInt32(min);
+	ConsoleIoSendString(" max: ");
+	ConsoleSendParamInt32(max);
+	ConsoleIoSendString(STR_ENDLINE);
+
+	for ( i = 0u ; i < max_kernel_thread ; i++ )
+	{
+		kernel_get_wake_latency(i, &min, &max);
+		ConsoleIoSendString(kernel_get_name(i));
+		ConsoleIoSendString(" wake min: ");
+		ConsoleSendParamInt32(min);
+		ConsoleIoSendString(" max: ");
+		ConsoleSendParamInt32(max);
+		ConsoleIoSendString(" jitter: ");
+		ConsoleSendParamInt32(max - min);
+		ConsoleIoSendString(" stack free: ");
+		ConsoleSendParamInt32(kernel_get_stack_free(i));
+		ConsoleIoSendString(STR_ENDLINE);
+	}
+
+	if ( ConsoleCommandParamIs(buffer, "reset") )
+	{
+		kernel_reset_stats();
+	}
+
+	return(result);
+}
+
+// Typing anything during playback aborts it, so the stop option is mostly for recording
+static eCommandResult_T ConsoleCommandReplay(const char buffer[])
+{
+	eCommandResult_T result = COMMAND_SUCCESS;
+	const char* modeNames[max_input_replay_mode] = {"off", "recording", "playing", "playing fast"};
+
+	if ( ConsoleCommandParamIs(buffer, "record") )
+	{
+		input_replay_record();
+	}
+	else if ( ConsoleCommandParamIs(buffer, "play") )
+	{
+		input_replay_play(false);
+	}
+	else if ( ConsoleCommandParamIs(buffer, "fast") )
+	{
+		input_replay_play(true);
+	}
+	else if ( ConsoleCommandParamIs(buffer, "stop") )
+	{
+		input_replay_stop();
+	}
+
+	ConsoleIoSendString(modeNames[input_replay_get_mode()]);
+	ConsoleIoSendString(" inputs: ");
+	ConsoleSendParamInt32(input_replay_get_count());
+	ConsoleIoSendString(" played: ");
+	ConsoleSendParamInt32(input_replay_get_position());
+	ConsoleIoSendString(STR_ENDLINE);
+
+	return(result);
+}
+
+// e.g. "anim breathe 3000 60 25", numbers left off keep the last values so one can be tuned at a time
+static eCommandResult_T ConsoleCommandAnim(const char buffer[])
+{
+	eCommandResult_T result = COMMAND_SUCCESS;
+	s_led_anim_params params = *led_anim_get_params();
+	int16_t value;
+	uint32_t i;
+
+	for ( i = 0u ; i < max_led_anim ; i++ )
+	{
+		if ( ConsoleCommandParamIs(buffer, led_anim_get_name(i)) )
+		{
+			if ( ( COMMAND_SUCCESS == ConsoleReceiveParamInt16(buffer, 2, &value) ) && ( value > 0 ) )
+			{
+				params.period_ms = (uint16_t) value;
+			}
+			if ( ( COMMAND_SUCCESS == ConsoleReceiveParamInt16(buffer, 3, &value) ) && ( value > 0 ) && ( value <= 100 ) )
+			{
+				params.peak_percent = (uint8_t) value;
+			}
+			if ( ( COMMAND_SUCCESS == ConsoleReceiveParamInt16(buffer, 4, &value) ) && ( value > 0 ) && ( value <= 50 ) )
+			{
+				params.gamma_x10 = (uint8_t) value;
+			}
+			led_anim_start(i, &params);
+			break;
+		}
+	}
+
+	ConsoleIoSendString(led_anim_get_name(led_anim_get()));
+	ConsoleIoSendString(" period ms: ");
+	ConsoleSendParamInt32(led_anim_get_params()->period_ms);
+	ConsoleIoSendString(" peak %: ");
+	ConsoleSendParamInt32(led_anim_get_params()->peak_percent);
+	ConsoleIoSendString(" gamma x10: ");
+	ConsoleSendParamInt32(led_anim_get_params()->gamma_x10);
+	ConsoleIoSendString(STR_ENDLINE);
+
+	return(result);
+}
+
+// "pod 2 5" sets a gamma level, "pod 2 breathe 1500" animates it with the anim settings otherwise
+static eCommandResult_T ConsoleCommandPod(const char buffer[])
+{
+	eCommandResult_T result = COMMAND_SUCCESS;
+	s_led_anim_params params = *led_anim_get_params();
+	int16_t pod;
+	int16_t value;
+	uint32_t i;
+
+	if ( ( COMMAND_SUCCESS != ConsoleReceiveParamInt16(buffer, 1, &pod) ) || ( pod < 1 ) || ( pod > (int16_t) PWM_PODS ) )
+	{
+		ConsoleIoSendString("pod 1 to 4" STR_ENDLINE);
+		return(result);
+	}
+	pod--;
+
+	for ( i = 0u ; i < max_led_anim ; i++ )
+	{
+		if ( ConsoleCommandParamNIs(buffer, 2u, led_anim_get_name(i)) )
+		{
+			if ( ( COMMAND_SUCCESS == ConsoleReceiveParamInt16(buffer, 3, &value) ) && ( value > 0 ) )
+			{
+				params.period_ms = (uint16_t) value;
+			}
+			if ( ( COMMAND_SUCCESS == ConsoleReceiveParamInt16(buffer, 4, &value) ) && ( value > 0 ) && ( value <= 100 ) )
+			{
+				params.peak_percent = (uint8_t) value;
+			}
+			if ( ( COMMAND_SUCCESS == ConsoleReceiveParamInt16(buffer, 5, &value) ) && ( value > 0 ) && ( value <= 50 ) )
+			{
+				params.gamma_x10 = (uint8_t) value;
+			}
+			led_pod_anim_start(pod, i, &params);
+			break;
+		}
+	}
+
+	if ( ( max_led_anim == i ) && ( COMMAND_SUCCESS == ConsoleReceiveParamInt16(buffer, 2, &value) ) && ( value >= 0 ) )
+	{
+		led_pod_set_level(pod, (uint8_t) value);
+	}
+
+	ConsoleIoSendString("pod ");
+	ConsoleSendParamInt32(pod + 1);
+	ConsoleIoSendString(": ");
+	ConsoleIoSendString(led_anim_get_name(led_pod_anim_get(pod)));
+	ConsoleIoSendString(STR_ENDLINE);
+
+	return(result);
+}
+
+// Periods are timer 5 counts (10ns), duty is permille high
+static eCommandResult_T ConsoleCommandCapture(const char buffer[])
+{
+	eCommandResult_T result = COMMAND_SUCCESS;
+	s_capture_stats stats;
+
+	if ( ConsoleCommandParamIs(buffer, "start") )
+	{
+		capture_start();
+	}
+	else if ( ConsoleCommandParamIs(buffer, "stop") )
+	{
+		capture_stop();
+	}
+	else if ( ConsoleCommandParamIs(buffer, "reset") )
+	{
+		capture_reset();
+	}
+
+	capture_get_stats(&stats);
+	ConsoleIoSendString(capture_is_running() ? "running" : "stopped");
+	ConsoleIoSendString(" periods: ");
+	ConsoleSendParamInt32(stats.periods);
+	ConsoleIoSendString(" overruns: ");
+	ConsoleSendParamInt32(stats.overruns);
+	ConsoleIoSendString(" mHz: ");
+	ConsoleSendParamInt32(capture_get_mhz());
+	ConsoleIoSendString(STR_ENDLINE);
+	ConsoleIoSendString("period last: ");
+	ConsoleSendParamInt32(stats.last_period);
+	ConsoleIoSendString(" min: ");
+	ConsoleSendParamInt32(stats.periods ? stats.min_period : 0u);
+	ConsoleIoSendString(" avg: ");
+	ConsoleSendParamInt32(stats.avg_period);
+	ConsoleIoSendString(" max: ");
+	ConsoleSendParamInt32(stats.max_period);
+	ConsoleIoSendString(" duty last: ");
+	ConsoleSendParamInt32(stats.last_duty);
+	ConsoleIoSendString(" avg: ");
+	ConsoleSendParamInt32(stats.avg_duty);
+	ConsoleIoSendString(STR_ENDLINE);
+
+	return(result);
+}
+
+// Accepted edges are presses and releases, rejected ones are bounces
+static eCommandResult_T ConsoleCommandButtons(const char buffer[])
+{
+	static const char* const names[max_button] = {"mode", "auto", "led", "manual"};
+	eCommandResult_T result = COMMAND_SUCCESS;
+	const s_debounce* debounce;
+	int16_t windowMs;
+	uint32_t i;
+
+	if ( ConsoleCommandParamIs(buffer, "reset") )
+	{
+		button_reset_debounce_counts();
+	}
+	else if ( ( COMMAND_SUCCESS == ConsoleReceiveParamInt16(buffer, 1, &windowMs) ) && ( windowMs >= 0 ) )
+	{
+		button_set_debounce_us((uint32_t) windowMs * 1000u);
+	}
+
+	for ( i = 0u ; i < max_button ; i++ )
+	{
+		debounce = button_get_debounce(i);
+		ConsoleIoSendString(names[i]);
+		ConsoleIoSendString(" accepted: ");
+		ConsoleSendParamInt32(debounce->accepted);
+		ConsoleIoSendString(" rejected: ");
+		ConsoleSendParamInt32(debounce->rejected);
+		ConsoleIoSendString(" window us: ");
+		ConsoleSendParamInt32(debounce->window_us);
+		ConsoleIoSendString(STR_ENDLINE);
+	}
+
+	return(result);
+}
+
 const sConsoleCommandTable_T* ConsoleCommandsGetTable(void)
 {
 	return (mConsoleCommandTable);
@@ -3,6 +3,8 @@
 #include "consoleIo.h"
 #include <stdio.h>
 
+#ifndef CONSOLE_IO_HOST // see consoleIoHost.c for the Linux backend
+
 eConsoleError ConsoleIoInit(void)
 {
 	return CONSOLE_SUCCESS;
@@ -14,7 +16,7 @@ eConsoleError ConsoleIoReceive(uint8_t *buffer, const uint32_t bufferLength, uin
 	uint32_t i = 0;
 	char ch;
 
-	while (uart1_is_readable())
+	while ((i < bufferLength) && uart1_is_readable()) // leave anything extra in the UART until there is room
 	{
 		ch = uart1_receive_byte();
 		uart1_send_byte((uint8_t) ch); // echo
@@ -33,3 +35,4 @@ eConsoleError ConsoleIoSendString(const char *buffer)
 	return CONSOLE_SUCCESS;
 }
 
+#endif // CONSOLE_IO_HOST
@@ -0,0 +1,54 @@
+// Console IO is a wrapper between the actual in and output and the console code
+// This is the Linux backend: it reads from stdin and writes to stdout so console.c
+// and consoleCommands.c can be run on a dev box, either interactively, on a pty,
+// or with a file of command lines piped in.
+// Only compiled when CONSOLE_IO_HOST is defined, consoleIo.c is the USART1 backend.
+
+#include "consoleIo.h"
+
+#ifdef CONSOLE_IO_HOST
+
+#include <stdio.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+eConsoleError ConsoleIoInit(void)
+{
+	int flags = fcntl(STDIN_FILENO, F_GETFL, 0);
+
+	// ConsoleProcess is polled, so a read must never block the loop
+	if ( ( flags < 0 ) || ( fcntl(STDIN_FILENO, F_SETFL, flags | O_NONBLOCK) < 0 ) )
+	{
+		return CONSOLE_ERROR;
+	}
+	return CONSOLE_SUCCESS;
+}
+
+// There is no echo here, the terminal (or pty) already does that
+eConsoleError ConsoleIoReceive(uint8_t *buffer, const uint32_t bufferLength, uint32_t *readLength)
+{
+	ssize_t received = 0;
+
+	if ( bufferLength > 0u )
+	{
+		received = read(STDIN_FILENO, buffer, bufferLength);
+	}
+
+	if ( received <= 0 )
+	{
+		// nothing pending (or EOF), push out whatever the last command printed
+		fflush(stdout);
+		received = 0;
+	}
+
+	*readLength = (uint32_t) received;
+	return CONSOLE_SUCCESS;
+}
+
+eConsoleError ConsoleIoSendString(const char *buffer)
+{
+	fputs(buffer, stdout);
+	return CONSOLE_SUCCESS;
+}
+
+#endif // CONSOLE_IO_HOST
@@ -26,6 +26,7 @@
 */
 
 #include "dac.h"
+#include "delay.h"
 
 /*
 ****************************************************
@@ -114,7 +115,7 @@ dac_audio_from_sd(uint32_t memory_starting_address)
 
    //512 bytes-per-block
    total_blocks = dac_start_audio_transmission(memory_starting_address);
-   timers_delay(200);
+   delay_ms(10);
 
    for(block_number = 0; block_number < (total_blocks); block_number++)
    {
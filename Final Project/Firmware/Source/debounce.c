@@ -0,0 +1,192 @@
+/** @file debounce.c
+*
+* @brief  This file contains a timestamp based edge debouncer.
+*         It only does arithmetic on the values it is handed, so edge trains can be fed to it off target.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "debounce.h"
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Sets up a debouncer for one input
+* @param[in] p_debounce Debouncer to set up
+* @param[in] tmp_window_us Quiet time needed before an edge counts, clamped to DEBOUNCE_MAX_WINDOW_US
+* @param[in] tmp_level Level the input is at right now, 1 is pressed
+* @return NONE
+*/
+void
+debounce_init(s_debounce * p_debounce, uint32_t tmp_window_us, uint8_t tmp_level)
+{
+   p_debounce->last_edge_us = 0;
+   p_debounce->accepted = 0;
+   p_debounce->rejected = 0;
+   p_debounce->level = tmp_level ? 1 : 0;
+   p_debounce->has_edge = 0;
+   debounce_set_window(p_debounce, tmp_window_us);
+}
+
+
+/*!
+* @brief Classifies one edge on an input
+* @param[in] p_debounce Debouncer of the input the edge was seen on
+* @param[in] tmp_now_us Timestamp of the edge
+* @param[in] tmp_level Level read right after the edge, 1 is pressed
+* @return debounce_press or debounce_release when the debounced level changed, else debounce_none
+* @note An edge only counts when the line has been quiet for a full window before it, so the first
+*       edge of a press is passed straight through and the bounces that follow it (or the ones a
+*       release makes) are dropped. A quiet edge that reads the level already held is dropped too,
+*       a release lost inside a window is handed back by debounce_settle rather than by
+*       reporting a second press.
+*       Timestamps wrap every ~71 minutes, an edge landing inside the window a whole wrap after the
+*       last one is (wrongly) rejected once, the next edge gets through.
+*/
+e_debounce_edge
+debounce_edge(s_debounce * p_debounce, uint32_t tmp_now_us, uint8_t tmp_level)
+{
+   uint8_t tmp_quiet = (!p_debounce->has_edge) ||
+                       ((uint32_t)(tmp_now_us - p_debounce->last_edge_us) >= p_debounce->window_us);
+
+   p_debounce->last_edge_us = tmp_now_us;
+   p_debounce->has_edge = 1;
+   tmp_level = tmp_level ? 1 : 0;
+
+   if(!tmp_quiet || (tmp_level == p_debounce->level))
+   {
+      p_debounce->rejected++;
+      return(debounce_none);
+   }
+
+   p_debounce->level = tmp_level;
+   p_debounce->accepted++;
+
+   return(tmp_level ? debounce_press : debounce_release);
+}
+
+
+/*!
+* @brief Lines the debounced level up with an input that has gone quiet
+* @param[in] p_debounce Debouncer of the input
+* @param[in] tmp_level Level read now, 1 is pressed
+* @return debounce_press or debounce_release if a dropped edge changed the level, else debounce_none
+* @note Call it a window after the last rejected edge. Without it a release that follows its
+*       press inside the window is only noticed at the next edge
+*/
+e_debounce_edge
+debounce_settle(s_debounce * p_debounce, uint8_t tmp_level)
+{
+   tmp_level = tmp_level ? 1 : 0;
+
+   if(tmp_level == p_debounce->level)
+   {
+      return(debounce_none);
+   }
+
+   p_debounce->level = tmp_level;
+   p_debounce->accepted++;
+
+   return(tmp_level ? debounce_press : debounce_release);
+}
+
+
+/*!
+* @brief Changes the debounce window of an input
+* @param[in] p_debounce Debouncer to change
+* @param[in] tmp_window_us New window, clamped to DEBOUNCE_MAX_WINDOW_US
+* @return NONE
+* @note A 32-bit store, safe against the ISR that reads it
+*/
+void
+debounce_set_window(s_debounce * p_debounce, uint32_t tmp_window_us)
+{
+   if(tmp_window_us > DEBOUNCE_MAX_WINDOW_US)
+   {
+      tmp_window_us = DEBOUNCE_MAX_WINDOW_US;
+   }
+
+   p_debounce->window_us = tmp_window_us;
+}
+
+
+/*!
+* @brief Clears the accepted and rejected edge counters of an input
+* @param[in] p_debounce Debouncer to clear
+* @return NONE
+*/
+void
+debounce_reset_counts(s_debounce * p_debounce)
+{
+   p_debounce->accepted = 0;
+   p_debounce->rejected = 0;
+}
+
+
+/*!
+* @brief Sets up a bit-sliced debouncer
+* @param[in] p_vertical Debouncer to set up
+* @param[in] tmp_sample Levels the inputs are at right now, taken as already debounced
+* @return NONE
+*/
+void
+debounce_vertical_init(s_debounce_vertical * p_vertical, uint16_t tmp_sample)
+{
+   p_vertical->state = tmp_sample;
+   p_vertical->count0 = 0xFFFFU;
+   p_vertical->count1 = 0xFFFFU;
+}
+
+
+/*!
+* @brief Feeds one sample of every input through the debouncer
+* @param[in] p_vertical Debouncer of the inputs
+* @param[in] tmp_sample New levels, one bit per input
+* @param[out] p_pressed Inputs whose debounced level just went to 1
+* @param[out] p_released Inputs whose debounced level just went to 0
+* @return NONE
+* @note All 16 counters step at once in a handful of logic ops. A counter sits at 3 while its
+*       input agrees with the state, counts down on every sample that disagrees and is put
+*       back at 3 by one that agrees, so a bounce restarts it. The state flips when it wraps.
+*/
+void
+debounce_vertical_scan(s_debounce_vertical * p_vertical, uint16_t tmp_sample,
+                       uint16_t * p_pressed, uint16_t * p_released)
+{
+   uint16_t tmp_changed = p_vertical->state ^ tmp_sample;
+
+   p_vertical->count0 = (uint16_t)~(p_vertical->count0 & tmp_changed);
+   p_vertical->count1 = (uint16_t)(p_vertical->count0 ^ (p_vertical->count1 & tmp_changed));
+
+   tmp_changed &= p_vertical->count0 & p_vertical->count1;
+   p_vertical->state ^= tmp_changed;
+
+   *p_pressed = tmp_changed & p_vertical->state;
+   *p_released = tmp_changed & (uint16_t)~p_vertical->state;
+}
+
+/* end of file */
@@ -0,0 +1,285 @@
+/** @file delay.c
+*
+* @brief  This file contains calibrated blocking delays based on the DWT cycle counter
+*         and an asynchronous microsecond callback service on timer 9.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "delay.h"
+#include "system_clock.h"
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+typedef struct s_delay_slot_tag
+{
+   delay_callback p_callback;  //NULL while the slot is free
+   void * p_context;
+   uint32_t deadline_cycles;   //Cycle count the callback is due at
+
+} s_delay_slot;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void delay_arm(void);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static s_delay_slot delay_slots[DELAY_CALLBACK_SLOTS];
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Sets timer 9 up as a one-shot microsecond timer for the callback service
+* @param[in] NONE
+* @return NONE
+* @note The blocking delays only need the cycle counter and work before this is called
+*/
+void
+delay_init(void)
+{
+   const s_timers_config tmp_config = {DELAY_TIM9_PSC, TIMERS_MAX_ARR_16};
+
+   timers_init(timers_tim9, &tmp_config);
+   TIM9->CR1 |= TIM_CR1_OPM; //Stop after one period. ARR stays unbuffered so each arm takes effect at once
+
+   timers_update_irq_enable(timers_tim9, DELAY_IRQ_PRIORITY);
+}
+
+
+/*!
+* @brief Blocks for a number of microseconds
+* @param[in] tmp_us Time to wait, up to ~42s
+* @return NONE
+* @note Counts CPU cycles, so it doesn't depend on optimization level. It still stalls the
+*       calling thread, keep it to init code and use delay_call_in_us elsewhere.
+*/
+void
+delay_us(uint32_t tmp_us)
+{
+   uint32_t tmp_start = system_clock_get_cycles();
+   uint32_t tmp_cycles = tmp_us * SYSTEM_CLOCK_CYCLES_PER_US;
+
+   while(system_clock_elapsed(tmp_start, system_clock_get_cycles()) < tmp_cycles)
+   {
+   }
+}
+
+
+/*!
+* @brief Blocks for a number of milliseconds
+* @param[in] tmp_ms Time to wait
+* @return NONE
+* @note Waits one millisecond at a time so long delays don't overflow the cycle count
+*/
+void
+delay_ms(uint32_t tmp_ms)
+{
+   while(tmp_ms--)
+   {
+      delay_us(1000UL);
+   }
+}
+
+
+/*!
+* @brief Calls a function once after a number of microseconds, without blocking
+* @param[in] tmp_us Delay, 1 to DELAY_CALLBACK_MAX_US
+* @param[in] p_callback Function to call. Runs in the timer 9 ISR, keep it short
+* @param[in] p_context Passed to the callback
+* @return 1 if scheduled, 0 if every slot is in use or the delay is out of range
+*/
+uint8_t
+delay_call_in_us(uint32_t tmp_us, delay_callback p_callback, void * p_context)
+{
+   uint32_t tmp_primask = 0;
+   uint8_t tmp_scheduled = 0;
+
+   if((0 == tmp_us) || (DELAY_CALLBACK_MAX_US < tmp_us) || (0 == p_callback))
+   {
+      return(0);
+   }
+
+   tmp_primask = __get_PRIMASK();
+   __disable_irq();
+
+   for(uint8_t i = 0; i < DELAY_CALLBACK_SLOTS; i++)
+   {
+      if(0 == delay_slots[i].p_callback)
+      {
+         delay_slots[i].deadline_cycles = system_clock_get_cycles() + (tmp_us * SYSTEM_CLOCK_CYCLES_PER_US);
+         delay_slots[i].p_context = p_context;
+         delay_slots[i].p_callback = p_callback;
+         tmp_scheduled = 1;
+         break;
+      }
+   }
+
+   if(tmp_scheduled)
+   {
+      delay_arm();
+   }
+
+   __set_PRIMASK(tmp_primask);
+
+   return(tmp_scheduled);
+}
+
+
+/*!
+* @brief Cancels every pending call of a callback with a given context
+* @param[in] p_callback Function that was scheduled
+* @param[in] p_context Context it was scheduled with
+* @return NONE
+*/
+void
+delay_cancel(delay_callback p_callback, void * p_context)
+{
+   uint32_t tmp_primask = __get_PRIMASK();
+
+   __disable_irq();
+
+   for(uint8_t i = 0; i < DELAY_CALLBACK_SLOTS; i++)
+   {
+      if((p_callback == delay_slots[i].p_callback) && (p_context == delay_slots[i].p_context))
+      {
+         delay_slots[i].p_callback = 0;
+      }
+   }
+
+   delay_arm();
+
+   __set_PRIMASK(tmp_primask);
+}
+
+
+/*!
+* @brief Timer 9 interrupt handler. Runs every callback that has come due, then re-arms
+*        the timer for the next one
+* @param[in] NONE
+* @return NONE
+* @note Shares its vector with the TIM1 break interrupt, which is never enabled
+*/
+void
+TIM1_BRK_TIM9_IRQHandler(void)
+{
+   uint32_t tmp_primask = 0;
+
+   TIM9->SR = ~TIM_SR_UIF;
+
+   for(uint8_t i = 0; i < DELAY_CALLBACK_SLOTS; i++)
+   {
+      delay_callback p_callback = delay_slots[i].p_callback;
+
+      if(p_callback && system_clock_has_reached(system_clock_get_cycles(), delay_slots[i].deadline_cycles))
+      {
+         //Free the slot first so the callback can schedule itself again
+         delay_slots[i].p_callback = 0;
+         p_callback(delay_slots[i].p_context);
+      }
+   }
+
+   tmp_primask = __get_PRIMASK();
+   __disable_irq();
+   delay_arm();
+   __set_PRIMASK(tmp_primask);
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Starts timer 9 for the earliest pending callback, or stops it if there is none
+* @param[in] NONE
+* @return NONE
+* @note Called with interrupts masked. A callback that is already due pends the ISR directly.
+*/
+void
+delay_arm(void)
+{
+   uint32_t tmp_now = system_clock_get_cycles();
+   uint32_t tmp_wait = 0xFFFFFFFFUL;
+   uint8_t tmp_pending = 0;
+
+   TIM9->CR1 &= ~TIM_CR1_CEN;
+
+   for(uint8_t i = 0; i < DELAY_CALLBACK_SLOTS; i++)
+   {
+      if(delay_slots[i].p_callback)
+      {
+         tmp_pending = 1;
+
+         if(system_clock_has_reached(tmp_now, delay_slots[i].deadline_cycles))
+         {
+            tmp_wait = 0;
+         }
+
+         else if((delay_slots[i].deadline_cycles - tmp_now) < tmp_wait)
+         {
+            tmp_wait = delay_slots[i].deadline_cycles - tmp_now;
+         }
+      }
+   }
+
+   if(!tmp_pending)
+   {
+      return;
+   }
+
+   //Round up so the callback never runs early
+   tmp_wait = (tmp_wait + SYSTEM_CLOCK_CYCLES_PER_US - 1UL) / SYSTEM_CLOCK_CYCLES_PER_US;
+
+   if(0 == tmp_wait)
+   {
+      NVIC_SetPendingIRQ(TIM1_BRK_TIM9_IRQn);
+      return;
+   }
+
+   TIM9->CNT = 0;
+   TIM9->ARR = tmp_wait;
+   TIM9->CR1 |= TIM_CR1_CEN;
+}
+
+
+/* end of file */
@@ -28,6 +28,8 @@
 #define MAGNET_TERMINATION_CHAR 5000; //Used to signal the end of an electromagnet pattern
 
 #include "electromagnet.h"
+#include "io_stats.h"
+#include "trace.h"
 
 /*
 ****************************************************
@@ -40,6 +42,8 @@ static const uint16_t magnet_fast_pattern[] =
 
 };
 
+static uint16_t magnet_current = MAGNET_MAG_OFF; //Last value written to the DAC
+
 /*
 ****************************************************
 ********** Private Function Prototypes *************
@@ -78,22 +82,27 @@ magnet_init(void)
    dac_enable();
 
    //Set initial voltage to 0v
-   DAC1->DHR12R1 |= 0x0000;
+   DAC1->DHR12R1 = MAGNET_MAG_OFF;
+   magnet_current = MAGNET_MAG_OFF;
 }
 
 
 /*!
 * @brief Control the magnitude of current through the electromagnet
-* @param[in] NONE
+* @param[in] tmp_magnitude 12 bit DAC value
 * @return NONE
+* @note The DAC is only written when the value changes, so callers can set it freely
 */
 void
 magnet_set_mag(uint16_t tmp_magnitude)
 {
    //Bounds check for 12 bit, right-aligned DAC register
-   if(4095 > tmp_magnitude)
+   if((4095 > tmp_magnitude) && (magnet_current != tmp_magnitude))
    {
       DAC1->DHR12R1 = tmp_magnitude;
+      magnet_current = tmp_magnitude;
+      io_stats_count(io_stats_dac);
+      TRACE(trace_id_dac, 0, tmp_magnitude);
    }
 
 }
@@ -0,0 +1,212 @@
+/** @file event_queue.c
+*
+* @brief  This file contains a lock-free single-producer/single-consumer queue
+*         that carries typed, timestamped events from ISRs to the state machine.
+* @note The producer side is every ISR that raises events, the consumer is the states task.
+*       All producers run at EVENT_QUEUE_IRQ_PRIORITY so none can preempt another, which
+*       makes them one producer as far as the queue is concerned. Only the producer writes
+*       event_queue_head and only the consumer writes event_queue_tail, so no locking is needed.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "event_queue.h"
+#include "input_replay.h"
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+uint8_t event_queue_write(e_event_type tmp_type, uint8_t tmp_data, uint32_t tmp_timestamp);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static s_event event_queue_buffer[EVENT_QUEUE_SIZE];
+static volatile uint8_t event_queue_head = 0; //Next slot to write, owned by the producer
+static volatile uint8_t event_queue_tail = 0; //Next slot to read, owned by the consumer
+static volatile uint32_t event_queue_dropped = 0;
+static volatile uint8_t event_queue_high_water = 0;
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Queue an event. Called from the producer ISRs
+* @param[in] tmp_type Type of event
+* @param[in] tmp_data Event specific payload
+* @return 1 if queued, 0 if the queue was full and the event was dropped
+* @note Live events pass through the input recorder, which drops them during a replay.
+*       They are stamped with the recorder's clock, which replayed events are stamped on too
+*/
+uint8_t
+event_queue_push(e_event_type tmp_type, uint8_t tmp_data)
+{
+   if(!input_replay_capture(input_replay_source_event, (uint8_t)tmp_type, tmp_data))
+   {
+      return(0);
+   }
+
+   return(event_queue_write(tmp_type, tmp_data, input_replay_get_time_us()));
+}
+
+
+/*!
+* @brief Queue a replayed event from task context
+* @param[in] tmp_type Type of event
+* @param[in] tmp_data Event specific payload
+* @param[in] tmp_timestamp When the event happened, so gestures time it as recorded rather than as fed
+* @return 1 if queued, 0 if the queue was full and the event was dropped
+* @note Interrupts are masked so this can't interleave with a producer ISR
+*/
+uint8_t
+event_queue_inject(e_event_type tmp_type, uint8_t tmp_data, uint32_t tmp_timestamp)
+{
+   uint32_t tmp_primask = __get_PRIMASK();
+   uint8_t tmp_queued = 0;
+
+   __disable_irq();
+   tmp_queued = event_queue_write(tmp_type, tmp_data, tmp_timestamp);
+   __set_PRIMASK(tmp_primask);
+
+   return(tmp_queued);
+}
+
+
+/*!
+* @brief Check if the consumer has handled every queued event
+* @param[in] NONE
+* @return 1 if the queue is empty
+*/
+uint8_t
+event_queue_is_empty(void)
+{
+   return((event_queue_head == event_queue_tail) ? 1 : 0);
+}
+
+
+/*!
+* @brief Take the oldest event off the queue. Called from the consumer only
+* @param[out] p_event Filled with the event if one was waiting
+* @return 1 if an event was read, 0 if the queue was empty
+*/
+uint8_t
+event_queue_pop(s_event * p_event)
+{
+   uint8_t tmp_tail = event_queue_tail;
+
+   if(tmp_tail == event_queue_head)
+   {
+      return(0);
+   }
+
+   //Don't read the slot before seeing the head that published it
+   __DMB();
+   *p_event = event_queue_buffer[tmp_tail];
+
+   //Finish reading the slot before handing it back to the producer
+   __DMB();
+   event_queue_tail = (tmp_tail + 1U) & (EVENT_QUEUE_SIZE - 1U);
+
+   return(1);
+}
+
+
+/*!
+* @brief Get the number of events lost because the queue was full
+* @param[in] NONE
+* @return event_queue_dropped
+*/
+uint32_t
+event_queue_get_dropped(void)
+{
+   return(event_queue_dropped);
+}
+
+
+/*!
+* @brief Get the most events that have been waiting in the queue at once
+* @param[in] NONE
+* @return event_queue_high_water
+*/
+uint8_t
+event_queue_get_high_water(void)
+{
+   return(event_queue_high_water);
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Adds an event at the head of the ring, the single producer side of the queue
+* @param[in] tmp_type Type of event
+* @param[in] tmp_data Event specific payload
+* @param[in] tmp_timestamp input_replay_get_time_us() when the event happened
+* @return 1 if queued, 0 if the queue was full and the event was dropped
+*/
+uint8_t
+event_queue_write(e_event_type tmp_type, uint8_t tmp_data, uint32_t tmp_timestamp)
+{
+   uint8_t tmp_head = event_queue_head;
+   uint8_t tmp_next = (tmp_head + 1U) & (EVENT_QUEUE_SIZE - 1U);
+   uint8_t tmp_used = 0;
+
+   if(tmp_next == event_queue_tail)
+   {
+      event_queue_dropped++;
+      return(0);
+   }
+
+   event_queue_buffer[tmp_head].timestamp = tmp_timestamp;
+   event_queue_buffer[tmp_head].type = (uint8_t)tmp_type;
+   event_queue_buffer[tmp_head].data = tmp_data;
+
+   //The event must be in memory before the consumer can see the new head
+   __DMB();
+   event_queue_head = tmp_next;
+
+   tmp_used = (tmp_next - event_queue_tail) & (EVENT_QUEUE_SIZE - 1U);
+
+   if(tmp_used > event_queue_high_water)
+   {
+      event_queue_high_water = tmp_used;
+   }
+
+   return(1);
+}
+
+
+/* end of file */
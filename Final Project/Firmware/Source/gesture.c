@@ -0,0 +1,259 @@
+/** @file gesture.c
+*
+* @brief  This file contains a button gesture recognizer: click, double-click, long-press and hold-repeat.
+*         Like debounce.c it only works on the edges and timestamps it is handed, so it runs off target as is.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "gesture.h"
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+typedef enum e_gesture_phase_tag
+{
+   gesture_phase_idle,
+   gesture_phase_held,       //Pressed, waiting for the release, a long-press or the first repeat
+   gesture_phase_repeating,  //Held past repeat_delay_ms
+   gesture_phase_pressed,    //Held, only the release can tell what the press was
+   gesture_phase_spent,      //Held, but the press was already reported. The release is ignored
+   gesture_phase_gap,        //Released once, waiting double_click_ms for a second press
+   gesture_phase_second,     //Pressed again inside the gap
+   max_gesture_phase
+
+} e_gesture_phase;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+e_gesture gesture_press(s_gesture * p_gesture, uint32_t tmp_now_us);
+e_gesture gesture_release(s_gesture * p_gesture, uint32_t tmp_now_us);
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Sets up the recognizer of one button
+* @param[in] p_gesture Recognizer to set up
+* @param[in] p_config Which gestures the button has and their times, must stay valid
+* @return NONE
+*/
+void
+gesture_init(s_gesture * p_gesture, const s_gesture_config * p_config)
+{
+   p_gesture->p_config = p_config;
+   p_gesture->deadline_us = 0;
+   p_gesture->phase = gesture_phase_idle;
+}
+
+
+/*!
+* @brief Feeds one debounced edge of the button to the recognizer
+* @param[in] p_gesture Recognizer of the button
+* @param[in] tmp_edge debounce_press or debounce_release, anything else is ignored
+* @param[in] tmp_now_us Timestamp of the edge
+* @return The gesture this edge completes, or gesture_none
+* @note Call gesture_poll first, so a deadline that passed before this edge is handled before it
+*/
+e_gesture
+gesture_edge(s_gesture * p_gesture, e_debounce_edge tmp_edge, uint32_t tmp_now_us)
+{
+   if(debounce_press == tmp_edge)
+   {
+      return(gesture_press(p_gesture, tmp_now_us));
+   }
+
+   if(debounce_release == tmp_edge)
+   {
+      return(gesture_release(p_gesture, tmp_now_us));
+   }
+
+   return(gesture_none);
+}
+
+
+/*!
+* @brief Reports the gestures that are made by time passing rather than by an edge
+* @param[in] p_gesture Recognizer of the button
+* @param[in] tmp_now_us Current time
+* @return gesture_long_press, gesture_repeat, a deferred gesture_click, or gesture_none
+* @note Returns at most one gesture per call, for a repeat that fell behind call it until gesture_none
+*/
+e_gesture
+gesture_poll(s_gesture * p_gesture, uint32_t tmp_now_us)
+{
+   const s_gesture_config * p_config = p_gesture->p_config;
+   uint32_t tmp_deadline_us;
+
+   if(!gesture_get_deadline(p_gesture, &tmp_deadline_us) ||
+      (0 > (int32_t)(tmp_now_us - tmp_deadline_us)))
+   {
+      return(gesture_none);
+   }
+
+   switch(p_gesture->phase)
+   {
+      case gesture_phase_held:
+         if(GESTURE_OFF != p_config->repeat_ms)
+         {
+            p_gesture->phase = gesture_phase_repeating;
+            p_gesture->deadline_us += (uint32_t)p_config->repeat_ms * 1000UL;
+            return(gesture_repeat);
+         }
+
+         p_gesture->phase = gesture_phase_spent;
+         return(gesture_long_press);
+
+      case gesture_phase_repeating:
+         //Step from the deadline, not from now, so late polls don't stretch the rate
+         p_gesture->deadline_us += (uint32_t)p_config->repeat_ms * 1000UL;
+         return(gesture_repeat);
+
+      case gesture_phase_gap:
+         //No second press came, so the first one was a plain click after all
+         p_gesture->phase = gesture_phase_idle;
+         return(gesture_click);
+
+      default:
+         return(gesture_none);
+   }
+}
+
+
+/*!
+* @brief Tells when gesture_poll next has something to report
+* @param[in] p_gesture Recognizer of the button
+* @param[in,out] p_deadline_us Set to the deadline if there is one, untouched otherwise
+* @return 1 if the recognizer is waiting on time, 0 if only an edge can move it on
+*/
+uint8_t
+gesture_get_deadline(const s_gesture * p_gesture, uint32_t * p_deadline_us)
+{
+   if((gesture_phase_held == p_gesture->phase) || (gesture_phase_repeating == p_gesture->phase) ||
+      (gesture_phase_gap == p_gesture->phase))
+   {
+      *p_deadline_us = p_gesture->deadline_us;
+      return(1);
+   }
+
+   return(0);
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Handles a press
+* @param[in] p_gesture Recognizer of the button
+* @param[in] tmp_now_us Timestamp of the press
+* @return gesture_click straight away for a button that can't be long-pressed or double-clicked
+*/
+e_gesture
+gesture_press(s_gesture * p_gesture, uint32_t tmp_now_us)
+{
+   const s_gesture_config * p_config = p_gesture->p_config;
+
+   if(gesture_phase_gap == p_gesture->phase)
+   {
+      p_gesture->phase = gesture_phase_second;
+      return(gesture_none);
+   }
+
+   if(GESTURE_OFF != p_config->repeat_ms)
+   {
+      //Click now, the repeats follow if it is held
+      p_gesture->phase = gesture_phase_held;
+      p_gesture->deadline_us = tmp_now_us + ((uint32_t)p_config->repeat_delay_ms * 1000UL);
+      return(gesture_click);
+   }
+
+   if(GESTURE_OFF != p_config->long_press_ms)
+   {
+      p_gesture->phase = gesture_phase_held;
+      p_gesture->deadline_us = tmp_now_us + ((uint32_t)p_config->long_press_ms * 1000UL);
+      return(gesture_none);
+   }
+
+   if(GESTURE_OFF != p_config->double_click_ms)
+   {
+      p_gesture->phase = gesture_phase_pressed;
+      return(gesture_none);
+   }
+
+   p_gesture->phase = gesture_phase_spent;
+   return(gesture_click);
+}
+
+
+/*!
+* @brief Handles a release
+* @param[in] p_gesture Recognizer of the button
+* @param[in] tmp_now_us Timestamp of the release
+* @return gesture_double_click, a click that can't be a double-click, or gesture_none
+*/
+e_gesture
+gesture_release(s_gesture * p_gesture, uint32_t tmp_now_us)
+{
+   const s_gesture_config * p_config = p_gesture->p_config;
+   uint8_t tmp_phase = p_gesture->phase;
+
+   p_gesture->phase = gesture_phase_idle;
+
+   if(gesture_phase_second == tmp_phase)
+   {
+      return(gesture_double_click);
+   }
+
+   //Released short of a long-press, or a press held back only for a double-click
+   if(((gesture_phase_held == tmp_phase) && (GESTURE_OFF == p_config->repeat_ms)) ||
+      (gesture_phase_pressed == tmp_phase))
+   {
+      if(GESTURE_OFF != p_config->double_click_ms)
+      {
+         p_gesture->phase = gesture_phase_gap;
+         p_gesture->deadline_us = tmp_now_us + ((uint32_t)p_config->double_click_ms * 1000UL);
+         return(gesture_none);
+      }
+
+      return(gesture_click);
+   }
+
+   return(gesture_none);
+}
+
+/* end of file */
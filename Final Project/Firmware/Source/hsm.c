@@ -0,0 +1,335 @@
+/** @file hsm.c
+*
+* @brief  This file contains a generic table-driven hierarchical state machine engine.
+*         States and transitions are described by const tables, so they live in flash.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "hsm.h"
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+uint8_t hsm_common_ancestor(const s_hsm * p_hsm, uint8_t tmp_source, uint8_t tmp_target);
+void hsm_exit_to(s_hsm * p_hsm, uint8_t tmp_ancestor);
+void hsm_enter_from(s_hsm * p_hsm, uint8_t tmp_ancestor, uint8_t tmp_target);
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Enters the initial state, running its entry actions outermost first
+* @param[in] p_hsm State machine with its tables already filled in
+* @param[in] tmp_initial First state. If it has children its initial child is entered too
+* @return NONE
+*/
+void
+hsm_init(s_hsm * p_hsm, uint8_t tmp_initial)
+{
+   if(p_hsm->p_history)
+   {
+      for(uint8_t i = 0; i < p_hsm->num_states; i++)
+      {
+         p_hsm->p_history[i] = HSM_NO_STATE;
+      }
+   }
+
+   hsm_enter_from(p_hsm, HSM_NO_STATE, tmp_initial);
+}
+
+
+/*!
+* @brief Delivers an event to the active state. If that state doesn't handle it,
+*        it is offered to each parent in turn
+* @param[in] p_hsm State machine
+* @param[in] tmp_event Event number, less than num_events
+* @return 1 if some state handled the event, 0 if it was ignored
+* @note The lookup is a single array index per level, no searching
+*/
+uint8_t
+hsm_dispatch(s_hsm * p_hsm, uint8_t tmp_event)
+{
+   uint8_t tmp_state = p_hsm->current;
+   const s_hsm_transition * p_transition = NULL;
+   uint8_t tmp_ancestor = HSM_NO_STATE;
+
+   if(tmp_event >= p_hsm->num_events)
+   {
+      return(0);
+   }
+
+   while(HSM_NO_STATE != tmp_state)
+   {
+      p_transition = &p_hsm->p_table[(tmp_state * p_hsm->num_events) + tmp_event];
+
+      if((hsm_unhandled != p_transition->kind) &&
+         ((NULL == p_transition->p_guard) || p_transition->p_guard()))
+      {
+         if(hsm_internal == p_transition->kind)
+         {
+            if(p_transition->p_action)
+            {
+               p_transition->p_action();
+            }
+         }
+
+         else
+         {
+            tmp_ancestor = hsm_common_ancestor(p_hsm, tmp_state, p_transition->target);
+            hsm_exit_to(p_hsm, tmp_ancestor);
+
+            if(p_transition->p_action)
+            {
+               p_transition->p_action();
+            }
+
+            hsm_enter_from(p_hsm, tmp_ancestor, p_transition->target);
+         }
+
+         return(1);
+      }
+
+      tmp_state = p_hsm->p_states[tmp_state].parent;
+   }
+
+   return(0);
+}
+
+
+/*!
+* @brief Runs the do action of the active state and each of its parents, outermost first
+* @param[in] p_hsm State machine
+* @return NONE
+*/
+void
+hsm_run(s_hsm * p_hsm)
+{
+   uint8_t tmp_path[HSM_MAX_DEPTH];
+   uint8_t tmp_depth = 0;
+   uint8_t tmp_state = p_hsm->current;
+
+   while((HSM_NO_STATE != tmp_state) && (HSM_MAX_DEPTH > tmp_depth))
+   {
+      tmp_path[tmp_depth++] = tmp_state;
+      tmp_state = p_hsm->p_states[tmp_state].parent;
+   }
+
+   while(tmp_depth)
+   {
+      hsm_action p_do = p_hsm->p_states[tmp_path[--tmp_depth]].p_do;
+
+      if(p_do)
+      {
+         p_do();
+      }
+   }
+}
+
+
+/*!
+* @brief Get the active leaf state
+* @param[in] p_hsm State machine
+* @return current
+*/
+uint8_t
+hsm_get_state(const s_hsm * p_hsm)
+{
+   return(p_hsm->current);
+}
+
+
+/*!
+* @brief Check if a state is active, either as the leaf or as one of its parents
+* @param[in] p_hsm State machine
+* @param[in] tmp_state State to look for
+* @return 1 if tmp_state is active
+*/
+uint8_t
+hsm_is_in(const s_hsm * p_hsm, uint8_t tmp_state)
+{
+   uint8_t tmp_active = p_hsm->current;
+
+   while(HSM_NO_STATE != tmp_active)
+   {
+      if(tmp_active == tmp_state)
+      {
+         return(1);
+      }
+
+      tmp_active = p_hsm->p_states[tmp_active].parent;
+   }
+
+   return(0);
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Finds the innermost state that contains both ends of a transition
+* @param[in] p_hsm State machine
+* @param[in] tmp_source State whose table entry fired
+* @param[in] tmp_target Target of the transition
+* @return Common ancestor, HSM_NO_STATE if the transition crosses the top level
+* @note A self transition uses the parent, so the state is exited and re-entered
+*/
+uint8_t
+hsm_common_ancestor(const s_hsm * p_hsm, uint8_t tmp_source, uint8_t tmp_target)
+{
+   uint8_t tmp_candidate = p_hsm->p_states[tmp_source].parent;
+   uint8_t tmp_walk = HSM_NO_STATE;
+
+   //Target inside the source, the source stays active
+   tmp_walk = p_hsm->p_states[tmp_target].parent;
+
+   while(HSM_NO_STATE != tmp_walk)
+   {
+      if(tmp_walk == tmp_source)
+      {
+         return(tmp_source);
+      }
+
+      tmp_walk = p_hsm->p_states[tmp_walk].parent;
+   }
+
+   while(HSM_NO_STATE != tmp_candidate)
+   {
+      tmp_walk = tmp_target;
+
+      while(HSM_NO_STATE != tmp_walk)
+      {
+         if(tmp_walk == tmp_candidate)
+         {
+            return(tmp_candidate);
+         }
+
+         tmp_walk = p_hsm->p_states[tmp_walk].parent;
+      }
+
+      tmp_candidate = p_hsm->p_states[tmp_candidate].parent;
+   }
+
+   return(HSM_NO_STATE);
+}
+
+
+/*!
+* @brief Exits from the active leaf up to, but not including, an ancestor
+* @param[in] p_hsm State machine
+* @param[in] tmp_ancestor Innermost state that stays active, HSM_NO_STATE to exit everything
+* @return NONE
+*/
+void
+hsm_exit_to(s_hsm * p_hsm, uint8_t tmp_ancestor)
+{
+   uint8_t tmp_state = p_hsm->current;
+
+   while((HSM_NO_STATE != tmp_state) && (tmp_ancestor != tmp_state))
+   {
+      const s_hsm_state * p_state = &p_hsm->p_states[tmp_state];
+
+      if(p_state->p_exit)
+      {
+         p_state->p_exit();
+      }
+
+      //Remember which child was active for parents that resume where they left off
+      if((HSM_NO_STATE != p_state->parent) && p_hsm->p_history)
+      {
+         p_hsm->p_history[p_state->parent] = tmp_state;
+      }
+
+      tmp_state = p_state->parent;
+   }
+}
+
+
+/*!
+* @brief Enters every state from just below an ancestor down to the target, then
+*        follows initial (or history) children down to a leaf
+* @param[in] p_hsm State machine
+* @param[in] tmp_ancestor State that is already active, HSM_NO_STATE if none
+* @param[in] tmp_target State to end up in
+* @return NONE
+*/
+void
+hsm_enter_from(s_hsm * p_hsm, uint8_t tmp_ancestor, uint8_t tmp_target)
+{
+   uint8_t tmp_path[HSM_MAX_DEPTH];
+   uint8_t tmp_depth = 0;
+   uint8_t tmp_state = tmp_target;
+
+   //Collect the path bottom-up so it can be entered top-down
+   while((HSM_NO_STATE != tmp_state) && (tmp_ancestor != tmp_state) && (HSM_MAX_DEPTH > tmp_depth))
+   {
+      tmp_path[tmp_depth++] = tmp_state;
+      tmp_state = p_hsm->p_states[tmp_state].parent;
+   }
+
+   while(tmp_depth)
+   {
+      tmp_state = tmp_path[--tmp_depth];
+
+      if(p_hsm->p_states[tmp_state].p_entry)
+      {
+         p_hsm->p_states[tmp_state].p_entry();
+      }
+   }
+
+   tmp_state = tmp_target;
+
+   //Drill down to a leaf
+   while(HSM_NO_STATE != p_hsm->p_states[tmp_state].initial)
+   {
+      uint8_t tmp_child = p_hsm->p_states[tmp_state].initial;
+
+      if((p_hsm->p_states[tmp_state].flags & HSM_FLAG_HISTORY) && p_hsm->p_history &&
+         (HSM_NO_STATE != p_hsm->p_history[tmp_state]))
+      {
+         tmp_child = p_hsm->p_history[tmp_state];
+      }
+
+      tmp_state = tmp_child;
+
+      if(p_hsm->p_states[tmp_state].p_entry)
+      {
+         p_hsm->p_states[tmp_state].p_entry();
+      }
+   }
+
+   p_hsm->current = tmp_state;
+}
+
+
+/* end of file */
@@ -0,0 +1,444 @@
+/** @file input_replay.c
+*
+* @brief  This file contains a recorder for the external inputs the firmware sees,
+*         button and timer events plus console bytes, and a player that feeds a
+*         recording back in place of the live inputs.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "input_replay.h"
+#include "event_queue.h"
+#include "uart.h"
+#include "scheduler.h"
+#include "soft_timers.h"
+#include "system_clock.h"
+#include "states.h"
+#include "console.h"
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+typedef struct s_input_replay_entry_tag
+{
+   uint32_t timestamp;  //input_replay_get_time_us() when the input arrived
+   uint8_t source;      //e_input_replay_source
+   uint8_t data;
+   uint8_t payload;     //Data of the event, e.g. press or release. Fits in the padding
+
+} s_input_replay_entry;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void input_replay_tick(void * p_context);
+void input_replay_feed(const s_input_replay_entry * p_entry, uint32_t tmp_timestamp);
+void input_replay_consume(const s_input_replay_entry * p_entry);
+void input_replay_drop_line(void);
+uint8_t input_replay_is_endline(uint8_t tmp_byte);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static s_input_replay_entry input_replay_buffer[INPUT_REPLAY_BUFFER_SIZE];
+static uint32_t input_replay_count = 0;     //Entries recorded
+static uint32_t input_replay_position = 0;  //Next entry to play
+static uint32_t input_replay_start_us = 0;  //When playback started
+static uint32_t input_replay_line_start = 0; //First entry of the console line being recorded
+static uint8_t input_replay_line_ended = 1;  //The last recorded console byte ended a line
+static volatile uint32_t input_replay_skew_us = 0; //How far fast playback has moved the input clock past the system clock
+static volatile e_input_replay_mode input_replay_mode = input_replay_mode_off;
+static s_soft_timer input_replay_timer;
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Hook for every live input, called from the ISR that received it
+* @param[in] tmp_source Kind of input
+* @param[in] tmp_data Event type or received byte
+* @param[in] tmp_payload Data of the event, 0 for a console byte
+* @return 1 if the ISR should go on and deliver the input, 0 if it should drop it
+* @note While playing, live events are dropped so only the recording drives the system.
+*       A live console byte aborts playback, so the console always stays usable. A bare line
+*       ending doesn't, so the LF a terminal sends after the CR that started playback is dropped.
+*/
+uint8_t
+input_replay_capture(e_input_replay_source tmp_source, uint8_t tmp_data, uint8_t tmp_payload)
+{
+   uint32_t tmp_primask = 0;
+
+   switch(input_replay_mode)
+   {
+      case input_replay_mode_recording:
+         //USART1 can preempt the event ISRs, so claim the slot with interrupts masked
+         tmp_primask = __get_PRIMASK();
+         __disable_irq();
+
+         //Line endings left over from the command that started recording aren't part of the recording
+         if((input_replay_source_uart == tmp_source) && (0 == input_replay_count) && input_replay_is_endline(tmp_data))
+         {
+            __set_PRIMASK(tmp_primask);
+            return(1);
+         }
+
+         if(INPUT_REPLAY_BUFFER_SIZE > input_replay_count)
+         {
+            if(input_replay_source_uart == tmp_source)
+            {
+               if(input_replay_line_ended)
+               {
+                  input_replay_line_start = input_replay_count;
+               }
+
+               input_replay_line_ended = input_replay_is_endline(tmp_data);
+            }
+
+            input_replay_buffer[input_replay_count].timestamp = input_replay_get_time_us();
+            input_replay_buffer[input_replay_count].source = tmp_source;
+            input_replay_buffer[input_replay_count].data = tmp_data;
+            input_replay_buffer[input_replay_count].payload = tmp_payload;
+            input_replay_count++;
+         }
+
+         else
+         {
+            input_replay_mode = input_replay_mode_off;
+         }
+
+         __set_PRIMASK(tmp_primask);
+         return(1);
+
+      case input_replay_mode_playing:
+      case input_replay_mode_playing_fast:
+         if((input_replay_source_uart == tmp_source) && !input_replay_is_endline(tmp_data))
+         {
+            input_replay_mode = input_replay_mode_off;
+            return(1);
+         }
+
+         return(0);
+
+      default:
+         return(1);
+   }
+}
+
+
+/*!
+* @brief Clears the recording and starts recording live inputs
+* @param[in] NONE
+* @return NONE
+* @note Recording stops by itself when the buffer is full
+*/
+void
+input_replay_record(void)
+{
+   input_replay_stop();
+   input_replay_count = 0;
+   input_replay_position = 0;
+   input_replay_line_start = 0;
+   input_replay_line_ended = 1;
+   input_replay_mode = input_replay_mode_recording;
+}
+
+
+/*!
+* @brief Plays the recording from the start in place of the live inputs
+* @param[in] tmp_fast 0 keeps the recorded timing, 1 feeds each input as soon as the
+*            previous one has been handled, which keeps the order but skips the gaps
+* @return NONE
+* @note Events carry their recorded timestamps either way, so gestures come out as recorded.
+*       Fast mode moves the input clock over each gap rather than waiting it out.
+*/
+void
+input_replay_play(uint8_t tmp_fast)
+{
+   input_replay_stop();
+
+   if(0 == input_replay_count)
+   {
+      return;
+   }
+
+   input_replay_position = 0;
+   input_replay_start_us = input_replay_get_time_us();
+   input_replay_mode = tmp_fast ? input_replay_mode_playing_fast : input_replay_mode_playing;
+   soft_timer_start(&input_replay_timer, INPUT_REPLAY_TICK_MS, INPUT_REPLAY_TICK_MS, input_replay_tick, 0);
+}
+
+
+/*!
+* @brief Ends recording or playback. The recording is kept
+* @param[in] NONE
+* @return NONE
+* @note Called by the console, so when recording the line that asked for the stop is dropped
+*       from the recording, or playing it back would stop the playback
+*/
+void
+input_replay_stop(void)
+{
+   uint32_t tmp_primask = __get_PRIMASK();
+   uint8_t tmp_was_recording = 0;
+
+   __disable_irq();
+   tmp_was_recording = (input_replay_mode_recording == input_replay_mode) ? 1 : 0;
+   input_replay_mode = input_replay_mode_off;
+   __set_PRIMASK(tmp_primask);
+
+   if(tmp_was_recording)
+   {
+      input_replay_drop_line();
+   }
+
+   soft_timer_stop(&input_replay_timer);
+}
+
+
+/*!
+* @brief Get the clock inputs are timestamped with
+* @param[in] NONE
+* @return system_clock_get_us() plus the gaps fast playback has skipped
+* @note Button events are stamped and gestures are timed on this clock, so a fast playback
+*       still sees the recorded spacing. It never runs backwards, and live inputs after a
+*       playback carry on from where it left off.
+*/
+uint32_t
+input_replay_get_time_us(void)
+{
+   return(system_clock_get_us() + input_replay_skew_us);
+}
+
+
+/*!
+* @brief Get what the recorder is doing
+* @param[in] NONE
+* @return input_replay_mode
+*/
+e_input_replay_mode
+input_replay_get_mode(void)
+{
+   return(input_replay_mode);
+}
+
+
+/*!
+* @brief Get the number of inputs in the recording
+* @param[in] NONE
+* @return input_replay_count
+*/
+uint32_t
+input_replay_get_count(void)
+{
+   return(input_replay_count);
+}
+
+
+/*!
+* @brief Get the number of inputs played back so far
+* @param[in] NONE
+* @return input_replay_position
+*/
+uint32_t
+input_replay_get_position(void)
+{
+   return(input_replay_position);
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Soft timer callback, feeds every recorded input that has come due
+* @param[in] p_context Unused
+* @return NONE
+* @note In fast mode each input is handled right here before the next is fed, so a tick plays
+*       inputs back to back until the recording ends or the tick has run for INPUT_REPLAY_TICK_MS.
+*       This runs in the tasks thread, the same one as the states and console tasks it calls.
+*/
+void
+input_replay_tick(void * p_context)
+{
+   uint32_t tmp_tick_start = system_clock_get_us();
+   uint32_t tmp_now = 0;
+   uint32_t tmp_at = 0;
+   const s_input_replay_entry * p_entry = 0;
+
+   while(input_replay_count > input_replay_position)
+   {
+      //Playback was aborted by a live console byte
+      if((input_replay_mode_playing != input_replay_mode) && (input_replay_mode_playing_fast != input_replay_mode))
+      {
+         soft_timer_stop(&input_replay_timer);
+         return;
+      }
+
+      p_entry = &input_replay_buffer[input_replay_position];
+      tmp_at = input_replay_start_us + (p_entry->timestamp - input_replay_buffer[0].timestamp);
+      tmp_now = input_replay_get_time_us();
+
+      if(0 < (int32_t)(tmp_at - tmp_now))
+      {
+         if(input_replay_mode_playing == input_replay_mode)
+         {
+            return;
+         }
+
+         //Skip the gap rather than wait it out
+         input_replay_skew_us += tmp_at - tmp_now;
+      }
+
+      if(input_replay_mode_playing_fast == input_replay_mode)
+      {
+         //Whatever the buttons had due before this input happens first, as it did when recorded
+         states_update_main_event();
+      }
+
+      input_replay_feed(p_entry, tmp_at);
+      input_replay_position++;
+
+      if(input_replay_mode_playing_fast == input_replay_mode)
+      {
+         input_replay_consume(p_entry);
+
+         if((INPUT_REPLAY_TICK_MS * 1000UL) <= (system_clock_get_us() - tmp_tick_start))
+         {
+            return;
+         }
+      }
+   }
+
+   input_replay_stop();
+}
+
+
+/*!
+* @brief Delivers one recorded input the same way its ISR would
+* @param[in] p_entry Input to deliver
+* @param[in] tmp_timestamp When it is due on the input clock, events are stamped with it
+* @return NONE
+*/
+void
+input_replay_feed(const s_input_replay_entry * p_entry, uint32_t tmp_timestamp)
+{
+   if(input_replay_source_uart == p_entry->source)
+   {
+      uart1_inject_byte((char)p_entry->data);
+      scheduler_signal(scheduler_task_console);
+   }
+
+   else if(event_type_tim5 == p_entry->data)
+   {
+      states_mag_tick();
+   }
+
+   else if(event_type_button_manual == p_entry->data)
+   {
+      states_manual_edge((debounce_press == p_entry->payload) ? 1 : 0);
+   }
+
+   else
+   {
+      event_queue_inject((e_event_type)p_entry->data, p_entry->payload, tmp_timestamp);
+      scheduler_signal(scheduler_task_states);
+   }
+}
+
+
+/*!
+* @brief Runs the task an input was fed to, so fast mode can feed the next one straight away
+* @param[in] p_entry Input that was just fed
+* @return NONE
+* @note The timer 5 tick and the manual button are handled when they are fed, like their ISRs
+*/
+void
+input_replay_consume(const s_input_replay_entry * p_entry)
+{
+   if(input_replay_source_uart == p_entry->source)
+   {
+      ConsoleProcess();
+   }
+
+   else if((event_type_tim5 != p_entry->data) && (event_type_button_manual != p_entry->data))
+   {
+      states_update_main_event();
+   }
+}
+
+
+/*!
+* @brief Takes the bytes of the console line being typed out of the recording
+* @param[in] NONE
+* @return NONE
+* @note Button and timer inputs that came in while the line was typed are kept.
+*       Recording must be off so the ISRs can't add entries meanwhile.
+*/
+void
+input_replay_drop_line(void)
+{
+   uint32_t tmp_kept = input_replay_line_start;
+
+   for(uint32_t i = input_replay_line_start; i < input_replay_count; i++)
+   {
+      if(input_replay_source_uart != input_replay_buffer[i].source)
+      {
+         input_replay_buffer[tmp_kept++] = input_replay_buffer[i];
+      }
+   }
+
+   input_replay_count = tmp_kept;
+   input_replay_line_start = tmp_kept;
+   input_replay_line_ended = 1;
+}
+
+
+/*!
+* @brief Check if a console byte ends a line
+* @param[in] tmp_byte Received byte
+* @return 1 for CR or LF
+*/
+uint8_t
+input_replay_is_endline(uint8_t tmp_byte)
+{
+   return((('\r' == tmp_byte) || ('\n' == tmp_byte)) ? 1 : 0);
+}
+
+
+/* end of file */
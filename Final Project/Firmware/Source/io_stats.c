@@ -0,0 +1,177 @@
+/** @file io_stats.c
+*
+* @brief  This file contains counters of peripheral register writes made by the
+*         output drivers, with a once-per-second rate for each.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "io_stats.h"
+#include "soft_timers.h"
+#include "stm32f4xx.h"
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void io_stats_latch(void * p_context);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static volatile uint32_t io_stats_total[max_io_stats_periph];
+static uint32_t io_stats_last_total[max_io_stats_periph]; //Total at the previous latch
+static uint32_t io_stats_rate[max_io_stats_periph];       //Writes during the last full period
+static s_soft_timer io_stats_timer;
+
+static const char * const io_stats_names[max_io_stats_periph] =
+{
+   [io_stats_dac] = "dac",
+   [io_stats_pwm] = "pwm",
+};
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Clears the counters and starts the periodic rate latch
+* @param[in] NONE
+* @return NONE
+* @note Call after soft_timers_init
+*/
+void
+io_stats_init(void)
+{
+   io_stats_reset();
+   soft_timer_start(&io_stats_timer, IO_STATS_PERIOD_MS, IO_STATS_PERIOD_MS, io_stats_latch, 0);
+}
+
+
+/*!
+* @brief Records one register write, called by a driver each time it touches the hardware
+* @param[in] tmp_periph Peripheral that was written
+* @return NONE
+* @note Safe from any thread or ISR. magnet_set_mag runs from both threads and EXTI3, so the
+*       increment is masked or a preempted one would lose counts
+*/
+void
+io_stats_count(e_io_stats_periph tmp_periph)
+{
+   uint32_t tmp_primask;
+
+   if(max_io_stats_periph > tmp_periph)
+   {
+      tmp_primask = __get_PRIMASK();
+      __disable_irq();
+      io_stats_total[tmp_periph]++;
+      __set_PRIMASK(tmp_primask);
+   }
+}
+
+
+/*!
+* @brief Get the number of writes since boot or the last reset
+* @param[in] tmp_periph Peripheral to look up
+* @return io_stats_total
+*/
+uint32_t
+io_stats_get_total(e_io_stats_periph tmp_periph)
+{
+   return((max_io_stats_periph > tmp_periph) ? io_stats_total[tmp_periph] : 0);
+}
+
+
+/*!
+* @brief Get the number of writes during the last full second
+* @param[in] tmp_periph Peripheral to look up
+* @return io_stats_rate
+*/
+uint32_t
+io_stats_get_rate(e_io_stats_periph tmp_periph)
+{
+   return((max_io_stats_periph > tmp_periph) ? io_stats_rate[tmp_periph] : 0);
+}
+
+
+/*!
+* @brief Get a printable name for a peripheral
+* @param[in] tmp_periph Peripheral to look up
+* @return Name string, "?" if out of range
+*/
+const char *
+io_stats_get_name(e_io_stats_periph tmp_periph)
+{
+   return((max_io_stats_periph > tmp_periph) ? io_stats_names[tmp_periph] : "?");
+}
+
+
+/*!
+* @brief Clears all totals and rates
+* @param[in] NONE
+* @return NONE
+*/
+void
+io_stats_reset(void)
+{
+   for(uint8_t i = 0; i < max_io_stats_periph; i++)
+   {
+      io_stats_total[i] = 0;
+      io_stats_last_total[i] = 0;
+      io_stats_rate[i] = 0;
+   }
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Soft timer callback, turns the growth of each total over the last period into a rate
+* @param[in] p_context Unused
+* @return NONE
+*/
+void
+io_stats_latch(void * p_context)
+{
+   for(uint8_t i = 0; i < max_io_stats_periph; i++)
+   {
+      uint32_t tmp_total = io_stats_total[i];
+
+      io_stats_rate[i] = tmp_total - io_stats_last_total[i];
+      io_stats_last_total[i] = tmp_total;
+   }
+}
+
+
+/* end of file */
@@ -0,0 +1,484 @@
+/** @file kernel.c
+*
+* @brief  This file contains a minimal preemptive kernel: fixed-priority threads on
+*         static stacks, switched by PendSV, with semaphores to wake them from ISRs.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "kernel.h"
+#include "system_clock.h"
+#include "scheduler.h"
+#include "states.h"
+
+#define KERNEL_MAGNET_STACK_WORDS 256U
+#define KERNEL_TASKS_STACK_WORDS 768U
+#define KERNEL_INITIAL_XPSR 0x01000000UL     //Thumb bit set
+#define KERNEL_INITIAL_EXC_RETURN 0xFFFFFFFDUL //Return to thread mode on PSP, no FPU frame
+
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+typedef struct s_kernel_thread_tag
+{
+   const char * name;
+   void (*p_entry)(void * p_context);
+   uint32_t * p_stack;          //Lowest word of the stack
+   uint32_t stack_words;
+   volatile uint32_t sp;        //Saved stack pointer while switched out
+   volatile uint8_t ready;      //Cleared while blocked on a semaphore
+   uint32_t wake_min_cycles;    //Semaphore give to thread running again
+   uint32_t wake_max_cycles;
+
+} s_kernel_thread;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+uint32_t kernel_switch_context(uint32_t tmp_sp);
+void kernel_thread_exit(void);
+void kernel_thread_setup(s_kernel_thread * p_thread);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static uint32_t kernel_magnet_stack[KERNEL_MAGNET_STACK_WORDS] __attribute__((aligned(8)));
+static uint32_t kernel_tasks_stack[KERNEL_TASKS_STACK_WORDS] __attribute__((aligned(8)));
+
+//Highest priority first, indexed by e_kernel_thread
+static s_kernel_thread kernel_threads[max_kernel_thread] =
+{
+   {"magnet", states_mag_thread, kernel_magnet_stack, KERNEL_MAGNET_STACK_WORDS, 0, 0, 0, 0},
+   {"tasks", scheduler_thread, kernel_tasks_stack, KERNEL_TASKS_STACK_WORDS, 0, 0, 0, 0},
+};
+
+static volatile uint8_t kernel_current = KERNEL_NO_THREAD;
+static volatile uint32_t kernel_switch_start = 0;  //Cycle count when PendSV picked the next thread
+static uint32_t kernel_switch_count = 0;
+static uint32_t kernel_switch_min_cycles = 0;
+static uint32_t kernel_switch_max_cycles = 0;
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Builds the initial stack frame of every thread
+* @param[in] NONE
+* @return NONE
+*/
+void
+kernel_init(void)
+{
+   for(uint8_t i = 0; i < max_kernel_thread; i++)
+   {
+      kernel_thread_setup(&kernel_threads[i]);
+   }
+
+   kernel_reset_stats();
+}
+
+
+/*!
+* @brief Hands the CPU to the threads. Never returns
+* @param[in] NONE
+* @return NONE
+* @note From here on thread mode runs on the process stack and the main stack is only used by
+*       handlers. PendSV gets the lowest priority so a switch never preempts an ISR.
+*/
+void
+kernel_start(void)
+{
+   NVIC_SetPriority(PendSV_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL);
+
+   //A zero PSP tells PendSV there is no context to save on the first switch
+   __set_PSP(0);
+   SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+   __DSB();
+   __ISB();
+
+   while(1)
+   {
+   }
+}
+
+
+/*!
+* @brief Sets up a semaphore
+* @param[in] p_sem Semaphore to set up
+* @param[in] tmp_count Number of gives already available
+* @return NONE
+*/
+void
+kernel_sem_init(s_kernel_sem * p_sem, uint32_t tmp_count)
+{
+   p_sem->count = tmp_count;
+   p_sem->waiter = KERNEL_NO_THREAD;
+   p_sem->give_cycles = 0;
+}
+
+
+/*!
+* @brief Blocks the calling thread until the semaphore is given
+* @param[in] p_sem Semaphore to take
+* @return NONE
+* @note Thread context only, and only one thread may wait on a semaphore
+*/
+void
+kernel_sem_wait(s_kernel_sem * p_sem)
+{
+   s_kernel_thread * p_thread = 0;
+   uint32_t tmp_now = 0;
+   uint32_t tmp_cycles = 0;
+
+   __disable_irq();
+
+   if(p_sem->count)
+   {
+      p_sem->count--;
+      __enable_irq();
+      return;
+   }
+
+   p_thread = &kernel_threads[kernel_current];
+   p_sem->waiter = kernel_current;
+   p_thread->ready = 0;
+
+   //PendSV is taken as soon as interrupts are enabled, we continue here once given. The barriers
+   //make sure the switch happens before the statistics below are taken
+   SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+   __DSB();
+   __enable_irq();
+   __ISB();
+
+   tmp_now = system_clock_get_cycles();
+
+   tmp_cycles = system_clock_elapsed(p_sem->give_cycles, tmp_now);
+
+   if((0 == p_thread->wake_min_cycles) || (tmp_cycles < p_thread->wake_min_cycles))
+   {
+      p_thread->wake_min_cycles = tmp_cycles;
+   }
+
+   if(tmp_cycles > p_thread->wake_max_cycles)
+   {
+      p_thread->wake_max_cycles = tmp_cycles;
+   }
+
+   //From PendSV choosing this thread to the thread running again
+   tmp_cycles = system_clock_elapsed(kernel_switch_start, tmp_now);
+
+   if((0 == kernel_switch_min_cycles) || (tmp_cycles < kernel_switch_min_cycles))
+   {
+      kernel_switch_min_cycles = tmp_cycles;
+   }
+
+   if(tmp_cycles > kernel_switch_max_cycles)
+   {
+      kernel_switch_max_cycles = tmp_cycles;
+   }
+}
+
+
+/*!
+* @brief Gives a semaphore, waking its thread. Safe to call from an ISR
+* @param[in] p_sem Semaphore to give
+* @return NONE
+* @note If the woken thread outranks the running one, the switch happens as soon as
+*       every active ISR has returned
+*/
+void
+kernel_sem_give(s_kernel_sem * p_sem)
+{
+   uint32_t tmp_primask = __get_PRIMASK();
+   uint8_t tmp_waiter = KERNEL_NO_THREAD;
+
+   __disable_irq();
+
+   p_sem->give_cycles = system_clock_get_cycles();
+   tmp_waiter = p_sem->waiter;
+
+   if(KERNEL_NO_THREAD != tmp_waiter)
+   {
+      p_sem->waiter = KERNEL_NO_THREAD;
+      kernel_threads[tmp_waiter].ready = 1;
+
+      if(tmp_waiter < kernel_current)
+      {
+         SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+      }
+   }
+
+   else if(KERNEL_SEM_MAX > p_sem->count)
+   {
+      p_sem->count++;
+   }
+
+   __set_PRIMASK(tmp_primask);
+}
+
+
+/*!
+* @brief Get the number of context switches since the last stats reset
+* @param[in] NONE
+* @return kernel_switch_count
+*/
+uint32_t
+kernel_get_switch_count(void)
+{
+   return(kernel_switch_count);
+}
+
+
+/*!
+* @brief Get the cost of switching into a thread that was waiting on a semaphore
+* @param[out] p_min Fastest switch in cycles
+* @param[out] p_max Slowest switch in cycles
+* @return NONE
+* @note Measured from PendSV choosing the thread to the thread running again, so it
+*       covers the register restore and exception return
+*/
+void
+kernel_get_switch_cycles(uint32_t * p_min, uint32_t * p_max)
+{
+   *p_min = kernel_switch_min_cycles;
+   *p_max = kernel_switch_max_cycles;
+}
+
+
+/*!
+* @brief Get the name of a thread for printing
+* @param[in] tmp_thread Thread to look up
+* @return name Null terminated thread name
+*/
+const char *
+kernel_get_name(e_kernel_thread tmp_thread)
+{
+   return(kernel_threads[tmp_thread].name);
+}
+
+
+/*!
+* @brief Get the time from a semaphore give to the waiting thread running again
+* @param[in] tmp_thread Thread to look up
+* @param[out] p_min Shortest wake latency in cycles
+* @param[out] p_max Longest wake latency in cycles, max - min is the release jitter
+* @return NONE
+*/
+void
+kernel_get_wake_latency(e_kernel_thread tmp_thread, uint32_t * p_min, uint32_t * p_max)
+{
+   *p_min = kernel_threads[tmp_thread].wake_min_cycles;
+   *p_max = kernel_threads[tmp_thread].wake_max_cycles;
+}
+
+
+/*!
+* @brief Get the stack a thread has never touched
+* @param[in] tmp_thread Thread to look up
+* @return Unused stack in bytes
+*/
+uint32_t
+kernel_get_stack_free(e_kernel_thread tmp_thread)
+{
+   const s_kernel_thread * p_thread = &kernel_threads[tmp_thread];
+   uint32_t tmp_free = 0;
+
+   //Stacks grow down, so the untouched words are at the bottom
+   while((p_thread->stack_words > tmp_free) && (KERNEL_STACK_FILL == p_thread->p_stack[tmp_free]))
+   {
+      tmp_free++;
+   }
+
+   return(tmp_free * sizeof(uint32_t));
+}
+
+
+/*!
+* @brief Restart the switch and wake latency statistics
+* @param[in] NONE
+* @return NONE
+*/
+void
+kernel_reset_stats(void)
+{
+   kernel_switch_count = 0;
+   kernel_switch_min_cycles = 0;
+   kernel_switch_max_cycles = 0;
+
+   for(uint8_t i = 0; i < max_kernel_thread; i++)
+   {
+      kernel_threads[i].wake_min_cycles = 0;
+      kernel_threads[i].wake_max_cycles = 0;
+   }
+}
+
+
+/*!
+* @brief Saves the running thread's registers on its stack and restores the next thread's
+* @param[in] NONE
+* @return NONE
+* @note Only r4-r11 and EXC_RETURN are saved by hand, the hardware stacks the rest. When the
+*       thread has used the FPU, s16-s31 are saved too.
+*/
+__attribute__((naked)) void
+PendSV_Handler(void)
+{
+   __ASM volatile
+   (
+      "   mrs r0, psp                \n"
+      "   cbz r0, 1f                 \n" //First switch, nothing to save
+#if defined(__FPU_USED) && (__FPU_USED == 1U)
+      "   tst lr, #0x10              \n"
+      "   it eq                      \n"
+      "   vstmdbeq r0!, {s16-s31}    \n"
+#endif
+      "   stmdb r0!, {r4-r11, lr}    \n"
+      "1: cpsid i                    \n"
+      "   bl kernel_switch_context   \n"
+      "   cpsie i                    \n"
+      "   ldmia r0!, {r4-r11, lr}    \n"
+#if defined(__FPU_USED) && (__FPU_USED == 1U)
+      "   tst lr, #0x10              \n"
+      "   it eq                      \n"
+      "   vldmiaeq r0!, {s16-s31}    \n"
+#endif
+      "   msr psp, r0                \n"
+      "   bx lr                      \n"
+   );
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Picks the highest priority ready thread. Called from PendSV with interrupts masked
+* @param[in] tmp_sp Stack pointer of the thread being switched out, 0 on the first switch
+* @return Stack pointer of the thread to run
+*/
+__attribute__((used)) uint32_t
+kernel_switch_context(uint32_t tmp_sp)
+{
+   uint8_t tmp_next = max_kernel_thread - 1U; //The last thread never blocks
+
+   if(KERNEL_NO_THREAD != kernel_current)
+   {
+      kernel_threads[kernel_current].sp = tmp_sp;
+   }
+
+   for(uint8_t i = 0; i < max_kernel_thread; i++)
+   {
+      if(kernel_threads[i].ready)
+      {
+         tmp_next = i;
+         break;
+      }
+   }
+
+   if(tmp_next != kernel_current)
+   {
+      kernel_switch_count++;
+   }
+
+   kernel_current = tmp_next;
+   kernel_switch_start = system_clock_get_cycles();
+
+   return(kernel_threads[tmp_next].sp);
+}
+
+
+/*!
+* @brief Where a thread lands if its entry function returns. Parks it for good
+* @param[in] NONE
+* @return NONE
+*/
+void
+kernel_thread_exit(void)
+{
+   __disable_irq();
+   kernel_threads[kernel_current].ready = 0;
+   SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+   __enable_irq();
+
+   while(1)
+   {
+   }
+}
+
+
+/*!
+* @brief Fills a thread's stack and builds the frame PendSV expects to restore
+* @param[in] p_thread Thread to set up
+* @return NONE
+*/
+void
+kernel_thread_setup(s_kernel_thread * p_thread)
+{
+   uint32_t * p_sp = &p_thread->p_stack[p_thread->stack_words];
+
+   for(uint32_t i = 0; i < p_thread->stack_words; i++)
+   {
+      p_thread->p_stack[i] = KERNEL_STACK_FILL;
+   }
+
+   //Hardware frame, popped by the exception return
+   *(--p_sp) = KERNEL_INITIAL_XPSR;
+   *(--p_sp) = (uint32_t)(uintptr_t)p_thread->p_entry & ~1UL; //PC
+   *(--p_sp) = (uint32_t)(uintptr_t)kernel_thread_exit; //LR
+   *(--p_sp) = 0;                                  //R12
+   *(--p_sp) = 0;                                  //R3
+   *(--p_sp) = 0;                                  //R2
+   *(--p_sp) = 0;                                  //R1
+   *(--p_sp) = 0;                                  //R0, the entry function's p_context
+
+   //Software frame, popped by PendSV
+   *(--p_sp) = KERNEL_INITIAL_EXC_RETURN;
+
+   for(uint8_t i = 0; i < 8U; i++)
+   {
+      *(--p_sp) = 0;                               //R11 down to R4
+   }
+
+   p_thread->sp = (uint32_t)(uintptr_t)p_sp;
+   p_thread->ready = 1;
+}
+
+
+/* end of file */
@@ -27,14 +27,61 @@
 */
 
 #include "led.h"
+#include "io_stats.h"
+#include <math.h>
+#include <stddef.h>
 
 
+/*
+****************************************************
+********** Compile-Time Configurations *************
+****************************************************
+*/
+
+#define LED_ANIM_STREAM5_FLAGS (DMA_HIFCR_CTCIF5 | DMA_HIFCR_CHTIF5 | DMA_HIFCR_CTEIF5 | DMA_HIFCR_CDMEIF5 | DMA_HIFCR_CFEIF5)
+
+_Static_assert(LED_GAMMA_BITS == TIMERS_LED_PWM_BITS,
+               "led_gamma.h was generated for another PWM depth, rerun Tools/gamma_lut.py");
+
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+typedef struct s_led_pod_tag
+{
+   volatile e_led_anim anim;       //led_anim_none while the pod holds a static level
+   uint16_t frames;                //Frames in the table
+   uint16_t position;              //Next frame to write
+   uint16_t table[LED_POD_MAX_FRAMES];
+
+} s_led_pod;
+
 
 /*
 ****************************************************
 ************* File-Static Variables ****************
 ****************************************************
 */
+static uint16_t led_current = LED_MAG_UNKNOWN; //Last duty written to the timer
+static const uint16_t led_gamma_levels[LED_GAMMA_LEVELS] = LED_GAMMA_TABLE;
+
+//Streamed into TIM11->CCR1 by DMA, so only rewritten while the stream is off
+static uint16_t led_anim_frames[LED_ANIM_MAX_FRAMES];
+static volatile e_led_anim led_anim_current = led_anim_none;
+static s_led_anim_params led_anim_params =
+{
+   LED_ANIM_DEFAULT_PERIOD_MS,
+   LED_ANIM_DEFAULT_PEAK_PERCENT,
+   LED_ANIM_DEFAULT_GAMMA_X10
+};
+
+static const char * const led_anim_names[max_led_anim] = {"off", "breathe", "fadein", "fadeout", "blink"};
+
+//Stepped by the timer 1 update interrupt, which only runs while a pod is animating
+static s_led_pod led_pods[PWM_PODS];
 
 
 /*
@@ -42,6 +89,9 @@
 ********** Private Function Prototypes *************
 ****************************************************
 */
+uint16_t led_anim_fill(e_led_anim tmp_anim, const s_led_anim_params * p_params, uint16_t * p_frames, uint16_t tmp_max_frames);
+uint8_t led_anim_loops(e_led_anim tmp_anim);
+void led_frame_irqs(uint32_t tmp_set, uint32_t tmp_clear);
 
 
 /*
@@ -51,16 +101,445 @@
 */
 
 /*!
-* @brief Sets the brightness of the LED by changing its corresponding PWM duty cycle
+* @brief Sets up DMA2 stream 5 to feed the LED compare from timer 1's frame updates
 * @param[in] NONE
 * @return NONE
+* @note Call after pwm_init, which runs timer 1. Nothing moves until an animation starts
+*/
+void
+led_init(void)
+{
+   RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+   DMA2_Stream5->CR = 0;
+   DMA2_Stream5->PAR = (uint32_t)(uintptr_t)pwm_get_ccr(pwm_led);
+   DMA2_Stream5->M0AR = (uint32_t)(uintptr_t)led_anim_frames;
+
+   NVIC_SetPriority(DMA2_Stream5_IRQn, LED_ANIM_IRQ_PRIORITY);
+   NVIC_EnableIRQ(DMA2_Stream5_IRQn);
+   NVIC_SetPriority(TIM1_UP_TIM10_IRQn, LED_ANIM_IRQ_PRIORITY);
+   NVIC_EnableIRQ(TIM1_UP_TIM10_IRQn);
+}
+
+
+/*!
+* @brief Sets the brightness of the LED by changing its corresponding PWM duty cycle
+* @param[in] tmp_mag Compare value, LED_MAG_x
+* @return NONE
+* @note The timer is only written when the value changes. Stops any running animation
 */
 void
 led_set_mag(uint16_t tmp_mag)
 {
-	timers_timer11_duty(tmp_mag);
+   if(led_anim_none != led_anim_current)
+   {
+      led_anim_stop();
+   }
+
+   if(led_current != tmp_mag)
+   {
+      pwm_set(pwm_led, tmp_mag);
+      led_current = tmp_mag;
+      io_stats_count(io_stats_pwm);
+   }
 }
 
 
-/*** end of file ***/
+/*!
+* @brief Sets the LED to one of the perceptually even brightness levels
+* @param[in] tmp_level LED_LEVEL_OFF to LED_LEVEL_HIGH, higher values are clamped
+* @return NONE
+* @note A table lookup, the gamma maths was done by Tools/gamma_lut.py
+*/
+void
+led_set_level(uint8_t tmp_level)
+{
+   if(tmp_level > LED_LEVEL_HIGH)
+   {
+      tmp_level = LED_LEVEL_HIGH;
+   }
+
+   led_set_mag(led_gamma_levels[tmp_level]);
+}
+
+
+/*!
+* @brief Starts streaming an animation into the LED, replacing whatever it was showing
+* @param[in] tmp_anim Animation, led_anim_none just stops
+* @param[in] p_params Period, peak and gamma, or NULL to keep the last ones used
+* @return NONE
+* @note The table is computed once here. After that the only CPU cost is the single
+*       interrupt that ends a one-shot fade
+*/
+void
+led_anim_start(e_led_anim tmp_anim, const s_led_anim_params * p_params)
+{
+   uint16_t tmp_frames;
+
+   led_anim_stop();
+
+   if(NULL != p_params)
+   {
+      led_anim_params = *p_params;
+   }
+
+   if((led_anim_none == tmp_anim) || (tmp_anim >= max_led_anim))
+   {
+      return;
+   }
+
+   tmp_frames = led_anim_fill(tmp_anim, &led_anim_params, led_anim_frames, LED_ANIM_MAX_FRAMES);
+
+   //Halfword in, halfword out, one frame per timer 1 update. Loops restart on their own
+   DMA2->HIFCR = LED_ANIM_STREAM5_FLAGS;
+   DMA2_Stream5->NDTR = tmp_frames;
+   DMA2_Stream5->CR = LED_DMA_CHSEL_TIM1_UP | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 |
+                      DMA_SxCR_MINC | DMA_SxCR_DIR_0;
+
+   if(led_anim_loops(tmp_anim))
+   {
+      DMA2_Stream5->CR |= DMA_SxCR_CIRC;
+   }
+   else
+   {
+      DMA2_Stream5->CR |= DMA_SxCR_TCIE;
+   }
+
+   led_anim_current = tmp_anim;
+
+   //The register no longer matches led_current once frames start landing
+   led_current = LED_MAG_UNKNOWN;
+   io_stats_count(io_stats_pwm);
+
+   //Timer 1 keeps running for the pods, the stream only listens while an animation plays
+   DMA2_Stream5->CR |= DMA_SxCR_EN;
+   led_frame_irqs(TIM_DIER_UDE, 0);
+}
+
+
+/*!
+* @brief Stops the animation, the LED keeps the last frame written
+* @param[in] NONE
+* @return NONE
+*/
+void
+led_anim_stop(void)
+{
+   led_frame_irqs(0, TIM_DIER_UDE);
+
+   DMA2_Stream5->CR &= ~DMA_SxCR_EN;
+
+   //The stream finishes the transfer in flight before it reports disabled
+   while(DMA2_Stream5->CR & DMA_SxCR_EN)
+   {
+   }
+
+   DMA2->HIFCR = LED_ANIM_STREAM5_FLAGS;
+   led_anim_current = led_anim_none;
+}
+
+
+/*!
+* @brief Gets the animation running
+* @param[in] NONE
+* @return led_anim_none once stopped or a one-shot fade has finished
+*/
+e_led_anim
+led_anim_get(void)
+{
+   return led_anim_current;
+}
+
+
+/*!
+* @brief Gets the parameters the last animation was built with
+* @param[in] NONE
+* @return Period, peak and gamma
+*/
+const s_led_anim_params *
+led_anim_get_params(void)
+{
+   return &led_anim_params;
+}
+
+
+/*!
+* @brief Gets the console name of an animation
+* @param[in] tmp_anim Animation
+* @return Name, e.g. "breathe"
+*/
+const char *
+led_anim_get_name(e_led_anim tmp_anim)
+{
+   return led_anim_names[tmp_anim];
+}
+
+
+/*!
+* @brief Sets one pod to a perceptually even brightness level, stopping its animation
+* @param[in] tmp_pod Pod, 0 to PWM_PODS - 1
+* @param[in] tmp_level LED_LEVEL_OFF to LED_LEVEL_HIGH, higher values are clamped
+* @return NONE
+*/
+void
+led_pod_set_level(uint8_t tmp_pod, uint8_t tmp_level)
+{
+   if(tmp_level > LED_LEVEL_HIGH)
+   {
+      tmp_level = LED_LEVEL_HIGH;
+   }
+
+   led_pods[tmp_pod].anim = led_anim_none;
+   pwm_set(pwm_pod_1 + tmp_pod, led_gamma_levels[tmp_level]);
+   io_stats_count(io_stats_pwm);
+}
+
+
+/*!
+* @brief Sets every pod's level at once, they all change on the same period boundary
+* @param[in] p_levels Level per pod, LED_LEVEL_OFF to LED_LEVEL_HIGH
+* @return NONE
+*/
+void
+led_pod_set_levels(const uint8_t p_levels[PWM_PODS])
+{
+   pwm_batch_begin();
+
+   for(uint8_t pod = 0; pod < PWM_PODS; pod++)
+   {
+      led_pod_set_level(pod, p_levels[pod]);
+   }
+
+   pwm_batch_end();
+}
+
+
+/*!
+* @brief Starts an animation on one pod, the others keep what they are doing
+* @param[in] tmp_pod Pod, 0 to PWM_PODS - 1
+* @param[in] tmp_anim Animation, led_anim_none just stops
+* @param[in] p_params Period, peak and gamma, or NULL for the LED's last ones
+* @return NONE
+* @note Pods animate on the same frame clock as the LED, every frame lands on a period boundary
+*/
+void
+led_pod_anim_start(uint8_t tmp_pod, e_led_anim tmp_anim, const s_led_anim_params * p_params)
+{
+   s_led_pod * p_pod = &led_pods[tmp_pod];
+
+   //The frame interrupt skips the pod from here on, so its table is free to rewrite
+   p_pod->anim = led_anim_none;
+
+   if((led_anim_none == tmp_anim) || (tmp_anim >= max_led_anim))
+   {
+      return;
+   }
+
+   p_pod->frames = led_anim_fill(tmp_anim, (NULL != p_params) ? p_params : &led_anim_params,
+                                 p_pod->table, LED_POD_MAX_FRAMES);
+   p_pod->position = 0;
+   p_pod->anim = tmp_anim;
+   io_stats_count(io_stats_pwm);
+
+   led_frame_irqs(TIM_DIER_UIE, 0);
+}
+
+
+/*!
+* @brief Stops a pod's animation, it keeps the last frame written
+* @param[in] tmp_pod Pod, 0 to PWM_PODS - 1
+* @return NONE
+*/
+void
+led_pod_anim_stop(uint8_t tmp_pod)
+{
+   led_pods[tmp_pod].anim = led_anim_none;
+}
+
+
+/*!
+* @brief Gets the animation a pod is running
+* @param[in] tmp_pod Pod, 0 to PWM_PODS - 1
+* @return led_anim_none once stopped or a one-shot fade has finished
+*/
+e_led_anim
+led_pod_anim_get(uint8_t tmp_pod)
+{
+   return led_pods[tmp_pod].anim;
+}
+
+
+/*!
+* @brief Gamma corrected point on a 0 to peak ramp
+* @param[in] tmp_step Position on the ramp, 0 to tmp_last_step
+* @param[in] tmp_last_step Position of the peak, must not be 0
+* @param[in] tmp_peak Compare value at the end of the ramp
+* @param[in] tmp_gamma_x10 Exponent x10, 22 for gamma 2.2, 10 for linear
+* @return Compare value, peak x (step / last_step)^gamma
+* @note Uses the FPU, meant for building tables rather than per frame work
+*/
+uint16_t
+led_gamma_curve(uint32_t tmp_step, uint32_t tmp_last_step, uint16_t tmp_peak, uint8_t tmp_gamma_x10)
+{
+   float tmp_position = (float)tmp_step / (float)tmp_last_step;
+
+   return (uint16_t)((powf(tmp_position, (float)tmp_gamma_x10 / 10.0f) * (float)tmp_peak) + 0.5f);
+}
+
+
+/*!
+* @brief Ends a one-shot animation once its last frame has been written
+* @param[in] NONE
+* @return NONE
+*/
+void
+DMA2_Stream5_IRQHandler(void)
+{
+   DMA2->HIFCR = LED_ANIM_STREAM5_FLAGS;
+
+   TIM1->DIER &= ~TIM_DIER_UDE;
+   led_anim_current = led_anim_none;
+}
+
 
+/*!
+* @brief Writes the next frame of every animating pod
+* @param[in] NONE
+* @return NONE
+* @note Runs on timer 1 updates, so the compares written here all take effect together at the
+*       next frame boundary. Turns itself off once no pod is animating
+*/
+void
+TIM1_UP_TIM10_IRQHandler(void)
+{
+   uint8_t tmp_animating = 0;
+   s_led_pod * p_pod;
+
+   TIM1->SR = ~TIM_SR_UIF;
+
+   for(uint8_t pod = 0; pod < PWM_PODS; pod++)
+   {
+      p_pod = &led_pods[pod];
+
+      if(led_anim_none == p_pod->anim)
+      {
+         continue;
+      }
+
+      *pwm_get_ccr(pwm_pod_1 + pod) = p_pod->table[p_pod->position];
+      p_pod->position++;
+
+      if(p_pod->position >= p_pod->frames)
+      {
+         p_pod->position = 0;
+
+         //One-shots hold their last frame
+         if(!led_anim_loops(p_pod->anim))
+         {
+            p_pod->anim = led_anim_none;
+            continue;
+         }
+      }
+      tmp_animating = 1;
+   }
+
+   if(!tmp_animating)
+   {
+      TIM1->DIER &= ~TIM_DIER_UIE;
+   }
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Builds the frame table for an animation
+* @param[in] tmp_anim Animation, not led_anim_none
+* @param[in] p_params Period, peak and gamma. Out of range values are clamped here
+* @param[out] p_frames Table to fill
+* @param[in] tmp_max_frames Size of the table
+* @return Number of frames to stream
+*/
+uint16_t
+led_anim_fill(e_led_anim tmp_anim, const s_led_anim_params * p_params, uint16_t * p_frames, uint16_t tmp_max_frames)
+{
+   uint32_t tmp_frames = ((uint32_t)p_params->period_ms * LED_ANIM_FRAME_HZ) / 1000UL;
+   uint32_t tmp_half;
+   uint16_t tmp_peak;
+   uint8_t tmp_gamma = (0 == p_params->gamma_x10) ? 10U : p_params->gamma_x10;
+
+   tmp_peak = (p_params->peak_percent >= 100U) ? LED_MAG_HIGH : TIMERS_LED_DUTY_PERCENT(p_params->peak_percent);
+
+   if(tmp_frames < 2UL)
+   {
+      tmp_frames = 2UL;
+   }
+   else if(tmp_frames > tmp_max_frames)
+   {
+      tmp_frames = tmp_max_frames;
+   }
+   tmp_half = tmp_frames / 2UL;
+
+   for(uint32_t frame = 0; frame < tmp_frames; frame++)
+   {
+      switch(tmp_anim)
+      {
+         case led_anim_breathe:
+            //Up for the first half, back down for the second
+            p_frames[frame] = (frame < tmp_half) ?
+               led_gamma_curve(frame, tmp_half, tmp_peak, tmp_gamma) :
+               led_gamma_curve(tmp_frames - frame, tmp_frames - tmp_half, tmp_peak, tmp_gamma);
+            break;
+
+         case led_anim_fade_in:
+            p_frames[frame] = led_gamma_curve(frame, tmp_frames - 1UL, tmp_peak, tmp_gamma);
+            break;
+
+         case led_anim_fade_out:
+            p_frames[frame] = led_gamma_curve(tmp_frames - 1UL - frame, tmp_frames - 1UL, tmp_peak, tmp_gamma);
+            break;
+
+         default:
+            p_frames[frame] = (frame < tmp_half) ? tmp_peak : LED_MAG_OFF;
+            break;
+      }
+   }
+
+   return (uint16_t)tmp_frames;
+}
+
+
+/*!
+* @brief Tells looping animations from one-shots
+* @param[in] tmp_anim Animation
+* @return 1 if the animation restarts after its last frame, 0 if it holds it
+*/
+uint8_t
+led_anim_loops(e_led_anim tmp_anim)
+{
+   return (led_anim_breathe == tmp_anim) || (led_anim_blink == tmp_anim);
+}
+
+
+/*!
+* @brief Changes timer 1's DMA and interrupt enables from thread code
+* @param[in] tmp_set DIER bits to set
+* @param[in] tmp_clear DIER bits to clear
+* @return NONE
+* @note Both frame interrupts also clear their own bit in DIER, this keeps the two writers apart
+*/
+void
+led_frame_irqs(uint32_t tmp_set, uint32_t tmp_clear)
+{
+   uint32_t tmp_primask = __get_PRIMASK();
+
+   __disable_irq();
+   TIM1->DIER = (TIM1->DIER & ~tmp_clear) | tmp_set;
+   __set_PRIMASK(tmp_primask);
+}
+
+
+/*** end of file ***/
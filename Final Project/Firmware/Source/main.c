@@ -30,8 +30,8 @@ uint32_t global_uninitialized;
 
 
 /*!
-* @brief This is the main system loop. It initializes each peripheral module then jumps into an infinite loop.
-*        This loop constantly services the system's various state machines as the user interacts with the device.
+* @brief Initializes each peripheral module, the task scheduler and the kernel, then hands the CPU to the
+*        threads with kernel_start. The tasks and magnet threads run the system from there, it never returns.
 * @param[in] NONE
 * @return NONE
 *
@@ -42,17 +42,21 @@ main(void)
    //Initialize system and peripheral clocks
    system_clock_init();
 
+   //Start the event recorder as early as possible, it only needs the cycle counter
+   trace_init();
+
    //Initialize MCU peripherals and seed background state machines
    main_peripherals_init();
 
-   /* main system loop */
-   while(1)
-   {
-      ConsoleProcess();
-      states_update_main_event();
-      states_update_main_state();
-      states_update_led();
-   }
+   //Start the dog, which also latches why we booted, then report that. Every task and thread checks in from here on
+   watchdog_init();
+   watchdog_print_report();
+
+   scheduler_init();
+   kernel_init();
+
+   /* Hand over to the threads, see kernel.c for the thread table and scheduler.c for the task table */
+   kernel_start();
 
    return(0);
 }
@@ -75,16 +79,28 @@ main_peripherals_init(void)
    uart1_send_byte(DUMMY_BYTE);
    uart1_printf("\r\n");
 
+#if BUTTONS_SCAN
+   button_scan_init();
+#else
    button_mode_init();
    button_auto_init();
    button_led_init();
    button_manual_init();
+#endif
 
    ConsoleInit();
 
+   soft_timers_init();
+   delay_init();
+   io_stats_init();
+
    timers_timer5_init();
-   timers_timer11_init();
+   capture_init();
+   pwm_init();
+   led_init();
    magnet_init();
+
+   states_init();
 }
 
 
@@ -0,0 +1,225 @@
+/** @file profiler.c
+*
+* @brief  This file contains cycle-accurate profiling of the main loop stages.
+*         Each stage keeps min/avg/max and a log2 histogram of its run time in RAM.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "profiler.h"
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+typedef struct s_profiler_stats_tag
+{
+   uint32_t count;
+   uint64_t total_cycles;  //Won't overflow for years of samples, unlike a 32 bit sum
+   uint32_t min_cycles;
+   uint32_t max_cycles;
+   uint32_t histogram[PROFILER_BUCKETS];
+
+} s_profiler_stats;
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static s_profiler_stats profiler_stats[max_profiler_stage];
+
+static const char * const profiler_names[max_profiler_stage] =
+{
+   [profiler_stage_main_event] = "event",
+   [profiler_stage_main_state] = "state",
+   [profiler_stage_led]        = "led",
+   [profiler_stage_timers]     = "timers",
+   [profiler_stage_console]    = "console",
+};
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Records one run of a stage
+* @param[in] tmp_stage Stage that just finished
+* @param[in] tmp_start Cycle count from profiler_begin() when the stage started
+* @return NONE
+* @note Task context only. Costs a few dozen cycles, the CLZ makes the bucket lookup constant time
+*/
+void
+profiler_end(e_profiler_stage tmp_stage, uint32_t tmp_start)
+{
+   uint32_t tmp_cycles = system_clock_elapsed(tmp_start, system_clock_get_cycles());
+   s_profiler_stats * p_stats = 0;
+   uint32_t tmp_bucket = 0;
+
+   if(max_profiler_stage <= tmp_stage)
+   {
+      return;
+   }
+
+   p_stats = &profiler_stats[tmp_stage];
+
+   if(tmp_cycles)
+   {
+      tmp_bucket = 31UL - __CLZ(tmp_cycles);
+   }
+
+   if(PROFILER_BUCKETS <= tmp_bucket)
+   {
+      tmp_bucket = PROFILER_BUCKETS - 1;
+   }
+
+   p_stats->histogram[tmp_bucket]++;
+   p_stats->total_cycles += tmp_cycles;
+
+   if((0 == p_stats->count) || (tmp_cycles < p_stats->min_cycles))
+   {
+      p_stats->min_cycles = tmp_cycles;
+   }
+
+   if(tmp_cycles > p_stats->max_cycles)
+   {
+      p_stats->max_cycles = tmp_cycles;
+   }
+
+   p_stats->count++;
+}
+
+
+/*!
+* @brief Clears the statistics of every stage
+* @param[in] NONE
+* @return NONE
+*/
+void
+profiler_reset(void)
+{
+   for(uint8_t i = 0; i < max_profiler_stage; i++)
+   {
+      profiler_stats[i].count = 0;
+      profiler_stats[i].total_cycles = 0;
+      profiler_stats[i].min_cycles = 0;
+      profiler_stats[i].max_cycles = 0;
+
+      for(uint8_t bucket = 0; bucket < PROFILER_BUCKETS; bucket++)
+      {
+         profiler_stats[i].histogram[bucket] = 0;
+      }
+   }
+}
+
+
+/*!
+* @brief Get the name of a stage for printing
+* @param[in] tmp_stage Stage to look up
+* @return Name string, "?" if out of range
+*/
+const char *
+profiler_get_name(e_profiler_stage tmp_stage)
+{
+   return((max_profiler_stage > tmp_stage) ? profiler_names[tmp_stage] : "?");
+}
+
+
+/*!
+* @brief Get the number of runs recorded for a stage
+* @param[in] tmp_stage Stage to look up
+* @return count
+*/
+uint32_t
+profiler_get_count(e_profiler_stage tmp_stage)
+{
+   return((max_profiler_stage > tmp_stage) ? profiler_stats[tmp_stage].count : 0);
+}
+
+
+/*!
+* @brief Get the shortest run of a stage
+* @param[in] tmp_stage Stage to look up
+* @return min_cycles, 0 if the stage hasn't run
+*/
+uint32_t
+profiler_get_min(e_profiler_stage tmp_stage)
+{
+   return((max_profiler_stage > tmp_stage) ? profiler_stats[tmp_stage].min_cycles : 0);
+}
+
+
+/*!
+* @brief Get the mean run time of a stage
+* @param[in] tmp_stage Stage to look up
+* @return Average cycles per run, 0 if the stage hasn't run
+*/
+uint32_t
+profiler_get_avg(e_profiler_stage tmp_stage)
+{
+   if((max_profiler_stage <= tmp_stage) || (0 == profiler_stats[tmp_stage].count))
+   {
+      return(0);
+   }
+
+   return((uint32_t)(profiler_stats[tmp_stage].total_cycles / profiler_stats[tmp_stage].count));
+}
+
+
+/*!
+* @brief Get the longest run of a stage
+* @param[in] tmp_stage Stage to look up
+* @return max_cycles
+*/
+uint32_t
+profiler_get_max(e_profiler_stage tmp_stage)
+{
+   return((max_profiler_stage > tmp_stage) ? profiler_stats[tmp_stage].max_cycles : 0);
+}
+
+
+/*!
+* @brief Get one histogram bucket of a stage
+* @param[in] tmp_stage Stage to look up
+* @param[in] tmp_bucket Bucket n holds runs of 2^n to 2^(n+1)-1 cycles, bucket 0 also holds 0
+* @return Number of runs in the bucket
+*/
+uint32_t
+profiler_get_bucket(e_profiler_stage tmp_stage, uint8_t tmp_bucket)
+{
+   if((max_profiler_stage <= tmp_stage) || (PROFILER_BUCKETS <= tmp_bucket))
+   {
+      return(0);
+   }
+
+   return(profiler_stats[tmp_stage].histogram[tmp_bucket]);
+}
+
+
+/* end of file */
@@ -0,0 +1,274 @@
+/** @file pwm.c
+*
+* @brief  This file contains the multi-channel PWM driver for the LED and the jelly pod LEDs
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "pwm.h"
+#include <stddef.h>
+
+
+/*
+****************************************************
+********** Compile-Time Configurations *************
+****************************************************
+*/
+
+//Every PWM timer is on APB2 and runs TIMERS_LED_PWM_COUNTS steps per period
+#define PWM_PSC TIMERS_PSC_FOR_COUNTS(TIMERS_APB2_CLOCK_HZ, TIMERS_LED_PWM_HZ, TIMERS_LED_PWM_COUNTS)
+#define PWM_ARR (TIMERS_LED_PWM_COUNTS - 1UL)
+
+//Timer 1 only raises an update every PWM_TIM1_RCR + 1 periods, which makes it the animation frame clock
+#define PWM_TIM1_RCR (((TIMERS_LED_PWM_HZ + (PWM_FRAME_HZ / 2UL)) / PWM_FRAME_HZ) - 1UL)
+
+_Static_assert(TIMERS_CONFIG_OK(TIMERS_APB2_CLOCK_HZ, TIMERS_LED_PWM_HZ, PWM_PSC, PWM_ARR, TIMERS_MAX_ARR_16),
+               "TIMERS_LED_PWM_HZ can't be reached with TIMERS_LED_PWM_COUNTS steps");
+_Static_assert(PWM_TIM1_RCR <= 0xFFUL, "PWM_FRAME_HZ is too slow for timer 1's repetition counter");
+_Static_assert(TIMERS_CONFIG_OK(TIMERS_APB2_CLOCK_HZ, PWM_FRAME_HZ, PWM_PSC,
+                                ((PWM_ARR + 1UL) * (PWM_TIM1_RCR + 1UL)) - 1UL, TIMERS_MAX_ARR_32),
+               "PWM_FRAME_HZ isn't close to a whole number of PWM periods");
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void pwm_channel_init(e_pwm_channel tmp_channel);
+
+
+/* ***** File-Static Variables ***** */
+
+//Indexed by e_pwm_channel. Timer 1 CH2 and CH3 sit under USART1 on PA9/PA10, so those
+//pods use the complementary pins. With CHx off, CHxN carries OCxREF itself, same polarity as CHx
+static const s_pwm_channel pwm_channels[max_pwm_channel] =
+{
+   [pwm_led]   = {timers_tim11, 1, 0, GPIOC, 12, PWM_AF_TIM11},
+   [pwm_pod_1] = {timers_tim1,  1, 0, GPIOA, 8,  PWM_AF_TIM1},
+   [pwm_pod_2] = {timers_tim1,  2, 1, GPIOB, 0,  PWM_AF_TIM1},
+   [pwm_pod_3] = {timers_tim1,  3, 1, GPIOB, 1,  PWM_AF_TIM1},
+   [pwm_pod_4] = {timers_tim1,  4, 0, GPIOA, 11, PWM_AF_TIM1},
+};
+
+static uint32_t pwm_timer_mask = 0; //Bit per e_timers_id used by the table
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Sets up every timer and pin in the channel table and starts them
+* @param[in] NONE
+* @return NONE
+* @note The LED starts at half brightness as before, the pods start off
+*/
+void
+pwm_init(void)
+{
+   const s_timers_config tmp_config = {PWM_PSC, PWM_ARR};
+   const s_pwm_channel * p_channel;
+
+   for(uint8_t channel = 0; channel < max_pwm_channel; channel++)
+   {
+      p_channel = &pwm_channels[channel];
+
+      //Timers are shared by channels, only set each up once
+      if(0 == (pwm_timer_mask & (1UL << p_channel->timer)))
+      {
+         timers_init(p_channel->timer, &tmp_config);
+         timers_get_instance(p_channel->timer)->p_tim->CR1 |= TIM_CR1_ARPE;
+         pwm_timer_mask |= (1UL << p_channel->timer);
+      }
+
+      pwm_channel_init(channel);
+   }
+
+   *pwm_get_ccr(pwm_led) = TIMERS_LED_DUTY_50;
+
+   TIM1->RCR = PWM_TIM1_RCR;
+   TIM1->BDTR |= TIM_BDTR_MOE; //Advanced timer outputs stay off without it
+
+   for(uint8_t timer = 0; timer < max_timers_id; timer++)
+   {
+      if(pwm_timer_mask & (1UL << timer))
+      {
+         //Loads the compare and repetition preloads, URS keeps it from raising an update
+         timers_get_instance(timer)->p_tim->EGR = TIM_EGR_UG;
+         timers_start(timer);
+      }
+   }
+}
+
+
+/*!
+* @brief Sets the duty cycle of one channel
+* @param[in] tmp_channel Channel, e_pwm_channel
+* @param[in] tmp_duty Compare counts, 0 (always low) to TIMERS_LED_PWM_COUNTS (always high)
+* @return NONE
+* @note Compare registers are preloaded, so the new duty starts at the channel's next update
+*       and never cuts a period short. Doesn't block
+*/
+void
+pwm_set(e_pwm_channel tmp_channel, uint16_t tmp_duty)
+{
+   //In PWM mode 1 a compare past ARR keeps the output high for the whole period
+   if(tmp_duty > TIMERS_LED_PWM_COUNTS)
+   {
+      tmp_duty = TIMERS_LED_PWM_COUNTS;
+   }
+
+   *pwm_get_ccr(tmp_channel) = tmp_duty;
+}
+
+
+/*!
+* @brief Holds back updates on every PWM timer so several pwm_set calls land together
+* @param[in] NONE
+* @return NONE
+* @note Pair with pwm_batch_end. Channels on one timer all change on the same period
+*       boundary, channels on different timers on each timer's next one
+*/
+void
+pwm_batch_begin(void)
+{
+   for(uint8_t timer = 0; timer < max_timers_id; timer++)
+   {
+      if(pwm_timer_mask & (1UL << timer))
+      {
+         timers_get_instance(timer)->p_tim->CR1 |= TIM_CR1_UDIS;
+      }
+   }
+}
+
+
+/*!
+* @brief Lets the batched compare values through at the next update
+* @param[in] NONE
+* @return NONE
+* @note Keep the batch short. An update that falls inside it is skipped, which on timer 1
+*       also holds the LED animation frame for one more frame
+*/
+void
+pwm_batch_end(void)
+{
+   for(uint8_t timer = 0; timer < max_timers_id; timer++)
+   {
+      if(pwm_timer_mask & (1UL << timer))
+      {
+         timers_get_instance(timer)->p_tim->CR1 &= ~TIM_CR1_UDIS;
+      }
+   }
+}
+
+
+/*!
+* @brief Gets the compare register of a channel, for DMA
+* @param[in] tmp_channel Channel, e_pwm_channel
+* @return Address of CCRx on the channel's timer
+*/
+volatile uint32_t *
+pwm_get_ccr(e_pwm_channel tmp_channel)
+{
+   const s_pwm_channel * p_channel = &pwm_channels[tmp_channel];
+
+   return &timers_get_instance(p_channel->timer)->p_tim->CCR1 + (p_channel->channel - 1U);
+}
+
+
+/*!
+* @brief Connects a channel to its pin
+* @param[in] tmp_channel Channel, e_pwm_channel
+* @return NONE
+*/
+void
+pwm_output_enable(e_pwm_channel tmp_channel)
+{
+   const s_pwm_channel * p_channel = &pwm_channels[tmp_channel];
+   uint32_t tmp_shift = 4U * (p_channel->channel - 1U);
+
+   if(p_channel->complementary)
+   {
+      //Only CHxN is on, so it is OCxREF with no complement. CCxNP stays clear or the duty inverts
+      timers_get_instance(p_channel->timer)->p_tim->CCER |= (TIM_CCER_CC1NE << tmp_shift);
+   }
+   else
+   {
+      timers_get_instance(p_channel->timer)->p_tim->CCER |= (TIM_CCER_CC1E << tmp_shift);
+   }
+}
+
+
+/*!
+* @brief Disconnects a channel from its pin
+* @param[in] tmp_channel Channel, e_pwm_channel
+* @return NONE
+* @note If the GPIO is open drain the pin goes high z
+*/
+void
+pwm_output_disable(e_pwm_channel tmp_channel)
+{
+   uint32_t tmp_shift = 4U * (pwm_channels[tmp_channel].channel - 1U);
+
+   timers_get_instance(pwm_channels[tmp_channel].timer)->p_tim->CCER &= ~((TIM_CCER_CC1E | TIM_CCER_CC1NE) << tmp_shift);
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Puts one channel in preloaded PWM mode 1, output off, and routes its pin
+* @param[in] tmp_channel Channel, e_pwm_channel
+* @return NONE
+*/
+void
+pwm_channel_init(e_pwm_channel tmp_channel)
+{
+   const s_pwm_channel * p_channel = &pwm_channels[tmp_channel];
+   TIM_TypeDef * p_tim = timers_get_instance(p_channel->timer)->p_tim;
+   volatile uint32_t * p_ccmr = (p_channel->channel <= 2U) ? &p_tim->CCMR1 : &p_tim->CCMR2;
+   uint32_t tmp_shift = ((p_channel->channel - 1U) & 1U) * 8U; //Two channels per CCMR
+
+   gpio_clk_init(p_channel->p_port, p_channel->pin);
+   gpio_func_init(p_channel->p_port, p_channel->pin, GPIO_MODER_ALTERNATE_FUNCTION);
+   gpio_type_init(p_channel->p_port, p_channel->pin, GPIO_OTYPER_PUSH_PULL);
+   gpio_speed_init(p_channel->p_port, p_channel->pin, GPIO_OSPEEDR_VERY_HIGH);
+   gpio_pupd_init(p_channel->p_port, p_channel->pin, GPIO_PUPDR_NONE);
+   gpio_af_init(p_channel->p_port, p_channel->pin, p_channel->af);
+
+   *p_ccmr &= ~(0xFFUL << tmp_shift);
+   *p_ccmr |= ((TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1PE) << tmp_shift);
+   *pwm_get_ccr(tmp_channel) = 0;
+
+   pwm_output_enable(tmp_channel);
+}
+
+
+/* end of file */
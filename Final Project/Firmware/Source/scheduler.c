@@ -0,0 +1,417 @@
+/** @file scheduler.c
+*
+* @brief  This file contains a small run-to-completion task scheduler. Tasks run
+*         when their period is due or when an ISR signals them, highest priority first.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "scheduler.h"
+#include "system_clock.h"
+#include "console.h"
+#include "states.h"
+#include "soft_timers.h"
+#include "profiler.h"
+#include "watchdog.h"
+
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+typedef struct s_scheduler_task_tag
+{
+   const char * name;
+   void (*p_run)(void);
+   uint32_t period_ms;        //SCHEDULER_EVENT_DRIVEN if the task only runs when signalled
+   uint32_t next_run_ms;
+   volatile uint8_t ready;    //Set from ISRs, cleared right before the task runs
+   volatile uint32_t signal_cycles; //Cycle count when the task was last signalled
+   uint32_t run_count;
+   uint32_t wcet_cycles;      //Worst-case execution time in CPU cycles
+   e_watchdog_client watchdog_client; //Checked in each time the task runs
+
+} s_scheduler_task;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void scheduler_task_states_run(void);
+void scheduler_task_timers_run(void);
+void scheduler_task_console_run(void);
+uint8_t scheduler_has_work(uint32_t tmp_now);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+
+//Highest priority first, indexed by e_scheduler_task
+static s_scheduler_task scheduler_tasks[max_scheduler_task] =
+{
+   {"states", scheduler_task_states_run, 100UL, 0, 0, 0, 0, 0, watchdog_client_states}, //Event driven, the period only keeps it checking in
+   {"timers", scheduler_task_timers_run, 1UL, 0, 0, 0, 0, 0, watchdog_client_timers}, //Software timer wheel, callbacks run here
+   {"console", scheduler_task_console_run, 20UL, 0, 0, 0, 0, 0, watchdog_client_console}, //Woken by USART1 RX, the period also keeps it checking in
+};
+
+static uint32_t scheduler_sleep_cycles = 0;   //Cycles spent in WFI since the last stats reset
+static uint32_t scheduler_stats_start = 0;    //Cycle count at the last stats reset
+static uint32_t scheduler_wake_latency_last = 0;
+static uint32_t scheduler_wake_latency_max = 0;
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Schedules every periodic task to run on the first pass
+* @param[in] NONE
+* @return NONE
+*/
+void
+scheduler_init(void)
+{
+   uint32_t tmp_now = system_clock_get_ms();
+
+   //WFI enters Sleep, not Stop, so SysTick, the timers and USART1 keep running
+   SCB->SCR &= ~SCB_SCR_SLEEPDEEP_Msk;
+
+   for(uint8_t i = 0; i < max_scheduler_task; i++)
+   {
+      scheduler_tasks[i].next_run_ms = tmp_now;
+      scheduler_tasks[i].ready = 0;
+      scheduler_tasks[i].run_count = 0;
+      scheduler_tasks[i].wcet_cycles = 0;
+   }
+}
+
+
+/*!
+* @brief Runs the highest priority task that is due or signalled
+* @param[in] NONE
+* @return 1 if a task ran, 0 if nothing had work
+* @note Only one task runs per call so a higher priority task that became ready
+*       in the meantime is always picked next.
+*/
+uint8_t
+scheduler_run(void)
+{
+   uint32_t tmp_now = system_clock_get_ms();
+   uint32_t tmp_start = 0;
+   uint32_t tmp_cycles = 0;
+
+   for(uint8_t i = 0; i < max_scheduler_task; i++)
+   {
+      s_scheduler_task * p_task = &scheduler_tasks[i];
+
+      //Periodic release
+      if((SCHEDULER_EVENT_DRIVEN != p_task->period_ms) && system_clock_has_reached(tmp_now, p_task->next_run_ms))
+      {
+         p_task->ready = 1;
+         p_task->next_run_ms += p_task->period_ms;
+
+         //If we fell behind, don't try to catch up with a burst of runs
+         if(system_clock_has_reached(tmp_now, p_task->next_run_ms))
+         {
+            p_task->next_run_ms = tmp_now + p_task->period_ms;
+         }
+      }
+
+      if(p_task->ready)
+      {
+         //Clear before running so a signal raised during the run is not lost
+         p_task->ready = 0;
+
+         tmp_start = system_clock_get_cycles();
+
+         //Signal to dispatch latency, includes waking from WFI
+         if(p_task->signal_cycles)
+         {
+            scheduler_wake_latency_last = system_clock_elapsed(p_task->signal_cycles, tmp_start);
+            p_task->signal_cycles = 0;
+
+            if(scheduler_wake_latency_last > scheduler_wake_latency_max)
+            {
+               scheduler_wake_latency_max = scheduler_wake_latency_last;
+            }
+         }
+
+         p_task->p_run();
+         tmp_cycles = system_clock_elapsed(tmp_start, system_clock_get_cycles());
+
+         p_task->run_count++;
+         watchdog_check_in(p_task->watchdog_client);
+
+         if(tmp_cycles > p_task->wcet_cycles)
+         {
+            p_task->wcet_cycles = tmp_cycles;
+         }
+
+         return(1);
+      }
+   }
+
+   return(0);
+}
+
+
+/*!
+* @brief Tasks thread, the lowest priority kernel thread. Runs the cooperative tasks
+*        and sleeps whenever none has work
+* @param[in] p_context Unused
+* @return NONE
+*/
+void
+scheduler_thread(void * p_context)
+{
+   while(1)
+   {
+      if(!scheduler_run())
+      {
+         scheduler_idle();
+      }
+   }
+}
+
+
+/*!
+* @brief Marks a task as ready to run. Safe to call from an ISR
+* @param[in] tmp_task Task to signal
+* @return NONE
+*/
+void
+scheduler_signal(e_scheduler_task tmp_task)
+{
+   if(max_scheduler_task > tmp_task)
+   {
+      //Zero means "not signalled", so a stamp that happens to land on zero is nudged
+      scheduler_tasks[tmp_task].signal_cycles = system_clock_get_cycles() | 1UL;
+      scheduler_tasks[tmp_task].ready = 1;
+   }
+}
+
+
+/*!
+* @brief Puts the core to sleep until the next interrupt if no task has work
+* @param[in] NONE
+* @return NONE
+* @note Interrupts are masked while checking so a signal that arrives between the check
+*       and WFI can't be missed. A pending interrupt still wakes WFI with PRIMASK set,
+*       its handler then runs as soon as interrupts are re-enabled.
+*/
+void
+scheduler_idle(void)
+{
+   uint32_t tmp_start = 0;
+
+   __disable_irq();
+
+   if(!scheduler_has_work(system_clock_get_ms()))
+   {
+      tmp_start = system_clock_get_cycles();
+      __DSB();
+      __WFI();
+      scheduler_sleep_cycles += system_clock_elapsed(tmp_start, system_clock_get_cycles());
+   }
+
+   __enable_irq();
+}
+
+
+/*!
+* @brief Get the share of time spent asleep since the last stats reset
+* @param[in] NONE
+* @return Sleep time in tenths of a percent
+* @note The CPU cycle counter wraps every ~42s at 100MHz, read and reset the stats more often than that
+*/
+uint32_t
+scheduler_get_sleep_permille(void)
+{
+   uint32_t tmp_total = system_clock_elapsed(scheduler_stats_start, system_clock_get_cycles());
+
+   if(0 == tmp_total)
+   {
+      return(0);
+   }
+
+   return((uint32_t)(((uint64_t)scheduler_sleep_cycles * 1000ULL) / tmp_total));
+}
+
+
+/*!
+* @brief Get the signal to dispatch latency of signalled tasks
+* @param[out] p_last Latency of the most recent wakeup in cycles
+* @param[out] p_max Worst latency since the last stats reset in cycles
+* @return NONE
+*/
+void
+scheduler_get_wake_latency(uint32_t * p_last, uint32_t * p_max)
+{
+   *p_last = scheduler_wake_latency_last;
+   *p_max = scheduler_wake_latency_max;
+}
+
+
+/*!
+* @brief Restart the sleep and wakeup latency statistics
+* @param[in] NONE
+* @return NONE
+*/
+void
+scheduler_reset_stats(void)
+{
+   scheduler_sleep_cycles = 0;
+   scheduler_wake_latency_last = 0;
+   scheduler_wake_latency_max = 0;
+   scheduler_stats_start = system_clock_get_cycles();
+}
+
+
+/*!
+* @brief Get the name of a task for printing
+* @param[in] tmp_task Task to look up
+* @return name Null terminated task name
+*/
+const char *
+scheduler_get_name(e_scheduler_task tmp_task)
+{
+   return(scheduler_tasks[tmp_task].name);
+}
+
+
+/*!
+* @brief Get the number of times a task has run since boot
+* @param[in] tmp_task Task to look up
+* @return run_count
+*/
+uint32_t
+scheduler_get_run_count(e_scheduler_task tmp_task)
+{
+   return(scheduler_tasks[tmp_task].run_count);
+}
+
+
+/*!
+* @brief Get the longest single run of a task
+* @param[in] tmp_task Task to look up
+* @return wcet_cycles Worst-case execution time in CPU cycles
+*/
+uint32_t
+scheduler_get_wcet(e_scheduler_task tmp_task)
+{
+   return(scheduler_tasks[tmp_task].wcet_cycles);
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Check if any task is signalled or due
+* @param[in] tmp_now Current system time in ms
+* @return 1 if scheduler_run would run a task
+*/
+uint8_t
+scheduler_has_work(uint32_t tmp_now)
+{
+   for(uint8_t i = 0; i < max_scheduler_task; i++)
+   {
+      if(scheduler_tasks[i].ready)
+      {
+         return(1);
+      }
+
+      if((SCHEDULER_EVENT_DRIVEN != scheduler_tasks[i].period_ms) &&
+         system_clock_has_reached(tmp_now, scheduler_tasks[i].next_run_ms))
+      {
+         return(1);
+      }
+   }
+
+   return(0);
+}
+
+
+/*!
+* @brief Services the main state machine, which drains the ISR event queue
+* @param[in] NONE
+* @return NONE
+*/
+void
+scheduler_task_states_run(void)
+{
+   uint32_t tmp_start = profiler_begin();
+
+   states_update_main_event();
+   profiler_end(profiler_stage_main_event, tmp_start);
+
+   tmp_start = profiler_begin();
+   states_update_main_state();
+   profiler_end(profiler_stage_main_state, tmp_start);
+}
+
+
+/*!
+* @brief Advances the software timer wheel, which runs any expired callbacks
+* @param[in] NONE
+* @return NONE
+*/
+void
+scheduler_task_timers_run(void)
+{
+   uint32_t tmp_start = profiler_begin();
+
+   soft_timers_process();
+   profiler_end(profiler_stage_timers, tmp_start);
+}
+
+
+/*!
+* @brief Services the serial console
+* @param[in] NONE
+* @return NONE
+*/
+void
+scheduler_task_console_run(void)
+{
+   uint32_t tmp_start = profiler_begin();
+
+   ConsoleProcess();
+   profiler_end(profiler_stage_console, tmp_start);
+}
+
+
+/* end of file */
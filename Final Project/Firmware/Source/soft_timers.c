@@ -0,0 +1,338 @@
+/** @file soft_timers.c
+*
+* @brief  This file contains a hierarchical timer wheel that runs many one-shot
+*         and periodic software timers off the single millisecond system tick.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "soft_timers.h"
+#include "system_clock.h"
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void soft_timers_insert(s_soft_timer * p_timer);
+void soft_timers_link(s_soft_timer ** pp_head, s_soft_timer * p_timer);
+void soft_timers_unlink(s_soft_timer * p_timer);
+void soft_timers_cascade(uint8_t tmp_level, uint32_t tmp_tick);
+void soft_timers_advance(void);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+
+//Each slot is the head of a doubly-linked list of timers, so insert and remove are O(1)
+static s_soft_timer * soft_timers_wheel[SOFT_TIMERS_LEVELS][SOFT_TIMERS_SLOTS];
+static uint32_t soft_timers_time_ms = 0;   //Last tick the wheel has processed
+static uint32_t soft_timers_active = 0;
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Empties the wheel and lines it up with the system tick
+* @param[in] NONE
+* @return NONE
+*/
+void
+soft_timers_init(void)
+{
+   for(uint8_t level = 0; level < SOFT_TIMERS_LEVELS; level++)
+   {
+      for(uint8_t slot = 0; slot < SOFT_TIMERS_SLOTS; slot++)
+      {
+         soft_timers_wheel[level][slot] = 0;
+      }
+   }
+
+   soft_timers_time_ms = system_clock_get_ms();
+   soft_timers_active = 0;
+}
+
+
+/*!
+* @brief Runs the callback of every timer that has expired since the last call
+* @param[in] NONE
+* @return NONE
+* @note Called from the timers task. Each elapsed tick costs one slot lookup, plus
+*       a cascade every 64 ticks, no matter how many timers are running.
+*/
+void
+soft_timers_process(void)
+{
+   uint32_t tmp_now = system_clock_get_ms();
+
+   while(system_clock_is_before(soft_timers_time_ms, tmp_now))
+   {
+      soft_timers_advance();
+   }
+}
+
+
+/*!
+* @brief Starts (or restarts) a software timer
+* @param[in] p_timer Timer to start, must stay valid while it is running
+* @param[in] tmp_delay_ms Time until the first expiry
+* @param[in] tmp_period_ms SOFT_TIMERS_ONE_SHOT, or the reload period for a periodic timer
+* @param[in] p_callback Called from the timers task on every expiry
+* @param[in] p_context Passed to the callback
+* @return NONE
+* @warning Task context only, not safe to call from an ISR
+*/
+void
+soft_timer_start(s_soft_timer * p_timer, uint32_t tmp_delay_ms, uint32_t tmp_period_ms,
+                 soft_timer_callback p_callback, void * p_context)
+{
+   soft_timer_stop(p_timer);
+
+   p_timer->expiry_ms = system_clock_get_ms() + tmp_delay_ms;
+   p_timer->period_ms = tmp_period_ms;
+   p_timer->p_callback = p_callback;
+   p_timer->p_context = p_context;
+
+   soft_timers_insert(p_timer);
+}
+
+
+/*!
+* @brief Stops a software timer. Does nothing if it isn't running
+* @param[in] p_timer Timer to stop
+* @return NONE
+* @warning Task context only, not safe to call from an ISR
+*/
+void
+soft_timer_stop(s_soft_timer * p_timer)
+{
+   if(p_timer->active)
+   {
+      soft_timers_unlink(p_timer);
+   }
+}
+
+
+/*!
+* @brief Check if a software timer is running
+* @param[in] p_timer Timer to check
+* @return 1 if the timer is waiting to expire
+*/
+uint8_t
+soft_timer_is_active(const s_soft_timer * p_timer)
+{
+   return(p_timer->active);
+}
+
+
+/*!
+* @brief Get the number of running software timers
+* @param[in] NONE
+* @return soft_timers_active
+*/
+uint32_t
+soft_timers_get_active_count(void)
+{
+   return(soft_timers_active);
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Links a timer into the slot matching how far away its expiry is
+* @param[in] p_timer Timer with expiry_ms already set
+* @return NONE
+* @note Level n holds timers expiring within 64^(n+1) ms. Anything further out is parked
+*       in the last level and put back through here when that slot cascades.
+*/
+void
+soft_timers_insert(s_soft_timer * p_timer)
+{
+   uint32_t tmp_next = soft_timers_time_ms + 1UL; //Next tick the wheel will process
+   uint32_t tmp_expiry = p_timer->expiry_ms;
+   uint32_t tmp_delta = 0;
+   uint8_t tmp_level = 0;
+   uint8_t tmp_slot = 0;
+
+   //Already due, fire on the next tick the wheel processes
+   if(system_clock_is_before(tmp_expiry, tmp_next))
+   {
+      tmp_expiry = tmp_next;
+   }
+
+   //Measured from the next tick, so a slot being cascaded never gets a timer put straight back in it
+   tmp_delta = tmp_expiry - tmp_next;
+
+   while((tmp_level < (SOFT_TIMERS_LEVELS - 1U)) &&
+         (tmp_delta >= (1UL << (SOFT_TIMERS_SLOT_BITS * (tmp_level + 1U)))))
+   {
+      tmp_level++;
+   }
+
+   //Too far out for the wheel, park it in the furthest slot of the last level
+   if(tmp_delta >= (1UL << (SOFT_TIMERS_SLOT_BITS * SOFT_TIMERS_LEVELS)))
+   {
+      tmp_expiry = tmp_next + (1UL << (SOFT_TIMERS_SLOT_BITS * SOFT_TIMERS_LEVELS)) - 1UL;
+   }
+
+   tmp_slot = (tmp_expiry >> (SOFT_TIMERS_SLOT_BITS * tmp_level)) & (SOFT_TIMERS_SLOTS - 1UL);
+
+   soft_timers_link(&soft_timers_wheel[tmp_level][tmp_slot], p_timer);
+}
+
+
+/*!
+* @brief Pushes a timer onto the front of a list
+* @param[in] pp_head List head, a wheel slot or a local list
+* @param[in] p_timer Timer that isn't in any list
+* @return NONE
+*/
+void
+soft_timers_link(s_soft_timer ** pp_head, s_soft_timer * p_timer)
+{
+   p_timer->p_next = *pp_head;
+   p_timer->pp_prev = pp_head;
+
+   if(p_timer->p_next)
+   {
+      p_timer->p_next->pp_prev = &p_timer->p_next;
+   }
+
+   *pp_head = p_timer;
+   p_timer->active = 1;
+   soft_timers_active++;
+}
+
+
+/*!
+* @brief Removes a timer from whichever list it is in
+* @param[in] p_timer Running timer
+* @return NONE
+*/
+void
+soft_timers_unlink(s_soft_timer * p_timer)
+{
+   *p_timer->pp_prev = p_timer->p_next;
+
+   if(p_timer->p_next)
+   {
+      p_timer->p_next->pp_prev = p_timer->pp_prev;
+   }
+
+   p_timer->p_next = 0;
+   p_timer->pp_prev = 0;
+   p_timer->active = 0;
+   soft_timers_active--;
+}
+
+
+/*!
+* @brief Moves every timer in one slot of a level down to a finer level
+* @param[in] tmp_level Wheel level to cascade, 1 or higher
+* @param[in] tmp_tick Tick about to be processed, the first tick covered by the slot
+* @return NONE
+*/
+void
+soft_timers_cascade(uint8_t tmp_level, uint32_t tmp_tick)
+{
+   uint8_t tmp_slot = (tmp_tick >> (SOFT_TIMERS_SLOT_BITS * tmp_level)) & (SOFT_TIMERS_SLOTS - 1UL);
+   s_soft_timer ** pp_head = &soft_timers_wheel[tmp_level][tmp_slot];
+   s_soft_timer * p_timer = 0;
+
+   while(*pp_head)
+   {
+      p_timer = *pp_head;
+      soft_timers_unlink(p_timer);
+      soft_timers_insert(p_timer);
+   }
+}
+
+
+/*!
+* @brief Moves the wheel forward one tick and fires everything that expires on it
+* @param[in] NONE
+* @return NONE
+*/
+void
+soft_timers_advance(void)
+{
+   uint8_t tmp_slot = 0;
+   s_soft_timer * p_timer = 0;
+   s_soft_timer * p_expired = 0;
+   uint32_t tmp_tick = soft_timers_time_ms + 1UL;
+
+   //At each level boundary pull the next slot of the coarser level down, coarsest first.
+   //This happens before the wheel time moves so a timer due on the boundary tick itself
+   //still lands in that tick's slot instead of being treated as late.
+   for(uint8_t level = SOFT_TIMERS_LEVELS - 1U; level > 0; level--)
+   {
+      if(0 == (tmp_tick & ((1UL << (SOFT_TIMERS_SLOT_BITS * level)) - 1UL)))
+      {
+         soft_timers_cascade(level, tmp_tick);
+      }
+   }
+
+   soft_timers_time_ms = tmp_tick;
+
+   tmp_slot = soft_timers_time_ms & (SOFT_TIMERS_SLOTS - 1UL);
+
+   //Move the whole slot to a local list first, so a callback can start or stop any
+   //timer, including ones that expire on this same tick, without breaking the walk
+   p_expired = soft_timers_wheel[0][tmp_slot];
+   soft_timers_wheel[0][tmp_slot] = 0;
+
+   if(p_expired)
+   {
+      p_expired->pp_prev = &p_expired;
+   }
+
+   while(p_expired)
+   {
+      p_timer = p_expired;
+      soft_timers_unlink(p_timer);
+
+      if(SOFT_TIMERS_ONE_SHOT != p_timer->period_ms)
+      {
+         //Reload from the old expiry, not from now, so a periodic timer doesn't drift
+         p_timer->expiry_ms += p_timer->period_ms;
+         soft_timers_insert(p_timer);
+      }
+
+      p_timer->p_callback(p_timer->p_context);
+   }
+}
+
+
+/* end of file */
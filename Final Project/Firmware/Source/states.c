@@ -28,6 +28,17 @@
 */
 
 #include "states.h"
+#include "event_queue.h"
+#include "hsm.h"
+#include "profiler.h"
+#include "trace.h"
+#include "kernel.h"
+#include "watchdog.h"
+#include "gesture.h"
+#include "soft_timers.h"
+#include "system_clock.h"
+#include "input_replay.h"
+#include "scheduler.h"
 
 
 
@@ -42,6 +53,9 @@ typedef enum e_state_main_tag
    state_idle,
    state_auto_pulse,
    state_manual,
+   state_auto_short,  //Children of state_auto_pulse, one per electromagnet algorithm
+   state_auto_medium,
+   state_auto_long,
    max_main_state
 
 } e_state_main;
@@ -49,33 +63,180 @@ typedef enum e_state_main_tag
 
 typedef enum e_event_main_tag
 {
-   no_event,
    event_button_mode,
+   event_button_auto,
+   event_button_mode_long,
+   event_button_auto_double,
    max_main_event
 
 } e_event_main;
 
+#define STATES_NO_EVENT max_main_event //Gesture the state machine doesn't use
+#define STATES_LED_EVENT (max_main_event + 1U) //Steps the LED, which works the same in every state
+
+
+//Kept over a reset in .noinit (see Linker/noinit.ld), restored by states_init
+typedef struct s_states_settings_tag
+{
+   uint32_t magic;      //STATES_SETTINGS_MAGIC once saved
+   uint8_t auto_state;  //Child of state_auto_pulse to resume in
+   uint8_t led_level;
+   uint8_t mag_reverse;
+
+} s_states_settings;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void states_main_dispatch(e_event_main tmp_event);
+void states_main_idle_entry(void);
+void states_main_manual_entry(void);
+void states_main_manual_exit(void);
+void states_mag_step(void);
+void states_mag_service(void);
+void states_mag_algo_start(uint8_t tmp_algo);
+void states_mag_short_entry(void);
+void states_mag_medium_entry(void);
+void states_mag_long_entry(void);
+void states_auto_pulse_exit(void);
+void states_update_led(void);
+void states_mag_reverse(void);
+void states_settings_save(void);
+void states_settings_restore(void);
+void states_gesture_edge(e_button tmp_button, const s_event * p_event);
+void states_gesture_poll(void);
+void states_gesture_dispatch(e_button tmp_button, e_gesture tmp_gesture);
+void states_gesture_wake(void * p_context);
+
 
 /*
 ****************************************************
 ************* File-Static Variables ****************
 ****************************************************
 */
-static e_event_main current_event = no_event;
-static e_state_main current_state = state_idle;
-static uint8_t current_mag_algo = 0;
+//Shared with the magnet thread, which outranks the tasks thread so it only ever sees these between writes
+static volatile uint8_t current_mag_algo = 0;
+static volatile uint8_t current_mag_step = 0;
+static volatile uint8_t mag_running = 0; //Set while an auto algorithm is active
+static volatile uint8_t mag_reverse = 0; //Plays the algorithm from its peak back down
+static volatile uint8_t current_mag_length = 0; //Steps in the active algorithm, up to STATES_MAGNETALGO_STOP
+static s_kernel_sem mag_tick_sem;
+static volatile uint8_t manual_active = 0; //Lets the manual button's ISR drive the magnet
+static uint8_t states_main_history[max_main_state];
+static uint8_t states_led_level = LED_LEVEL_OFF;
+static s_gesture states_gestures[max_button];
+static s_soft_timer states_gesture_timer; //Wakes the tasks thread for the next long-press, repeat or click timeout
+
+//Survives a reset because startup code doesn't touch it. The .noinit section comes from Linker/noinit.ld
+static s_states_settings states_settings __attribute__((section(".noinit")));
 
 
 /*
 ****************************************************
-********** Private Function Prototypes *************
+************* Static Const Variables ***************
 ****************************************************
 */
-void states_main_idle(void);
-void states_main_auto_pulse(void);
-void states_main_manual(void);
-void states_mag_service(void);
-void states_mag_algo_select(void);
+
+//Each state's place in the hierarchy and its actions: {parent, initial, flags, entry, exit, do}
+static const s_hsm_state states_main_states[max_main_state] =
+{
+   [state_idle]        = {HSM_NO_STATE, HSM_NO_STATE, 0, states_main_idle_entry, NULL, NULL},
+   [state_auto_pulse]  = {HSM_NO_STATE, state_auto_short, HSM_FLAG_HISTORY, NULL, states_auto_pulse_exit, NULL},
+   [state_manual]      = {HSM_NO_STATE, HSM_NO_STATE, 0, states_main_manual_entry, states_main_manual_exit, NULL},
+   [state_auto_short]  = {state_auto_pulse, HSM_NO_STATE, 0, states_mag_short_entry, NULL, NULL},
+   [state_auto_medium] = {state_auto_pulse, HSM_NO_STATE, 0, states_mag_medium_entry, NULL, NULL},
+   [state_auto_long]   = {state_auto_pulse, HSM_NO_STATE, 0, states_mag_long_entry, NULL, NULL},
+};
+
+
+//What each state does with each event: {kind, target, guard, action}. Entries left out are unhandled
+//and are passed up to the parent state
+static const s_hsm_transition states_main_table[max_main_state][max_main_event] =
+{
+   [state_idle] =
+   {
+      [event_button_mode] = {hsm_external, state_auto_pulse, NULL, NULL},
+      [event_button_mode_long] = {hsm_internal, HSM_NO_STATE, NULL, states_settings_save},
+   },
+
+   [state_auto_pulse] =
+   {
+      [event_button_mode] = {hsm_external, state_manual, NULL, NULL},
+      [event_button_mode_long] = {hsm_internal, HSM_NO_STATE, NULL, states_settings_save},
+      [event_button_auto_double] = {hsm_internal, HSM_NO_STATE, NULL, states_mag_reverse},
+   },
+
+   [state_manual] =
+   {
+      [event_button_mode] = {hsm_external, state_idle, NULL, NULL},
+      [event_button_mode_long] = {hsm_internal, HSM_NO_STATE, NULL, states_settings_save},
+   },
+
+   [state_auto_short] =
+   {
+      [event_button_auto] = {hsm_external, state_auto_medium, NULL, NULL},
+   },
+
+   [state_auto_medium] =
+   {
+      [event_button_auto] = {hsm_external, state_auto_long, NULL, NULL},
+   },
+
+   [state_auto_long] =
+   {
+      [event_button_auto] = {hsm_external, state_auto_short, NULL, NULL},
+   },
+};
+
+
+//Which gestures each button has: {long press, double click, repeat delay, repeat period}
+static const s_gesture_config states_gesture_config[max_button] =
+{
+   [button_mode] = {STATES_LONG_PRESS_MS, GESTURE_OFF, GESTURE_OFF, GESTURE_OFF},
+   [button_auto] = {GESTURE_OFF, STATES_DOUBLE_CLICK_MS, GESTURE_OFF, GESTURE_OFF},
+   [button_led]  = {GESTURE_OFF, GESTURE_OFF, STATES_REPEAT_DELAY_MS, STATES_REPEAT_MS},
+   [button_manual] = {GESTURE_OFF, GESTURE_OFF, GESTURE_OFF, GESTURE_OFF}, //Never queued, see states_manual_edge
+};
+
+
+//What each gesture of each button means: e_event_main, STATES_LED_EVENT or STATES_NO_EVENT
+static const uint8_t states_gesture_events[max_button][max_gesture] =
+{
+   [button_mode] = {STATES_NO_EVENT, event_button_mode, STATES_NO_EVENT, event_button_mode_long, STATES_NO_EVENT},
+   [button_auto] = {STATES_NO_EVENT, event_button_auto, event_button_auto_double, STATES_NO_EVENT, STATES_NO_EVENT},
+   [button_led]  = {STATES_NO_EVENT, STATES_LED_EVENT, STATES_NO_EVENT, STATES_NO_EVENT, STATES_LED_EVENT},
+   [button_manual] = {STATES_NO_EVENT, STATES_NO_EVENT, STATES_NO_EVENT, STATES_NO_EVENT, STATES_NO_EVENT},
+};
+
+
+//Electromagnet algorithms, one row per child of state_auto_pulse
+static const uint16_t magnet_lookup[STATES_MAGNETALGO_MAX][40] =
+{
+      {0, 544, 1088, 1632, 2176, 2720, 3264, 3808, STATES_MAGNETALGO_STOP},  //Very short ramp up
+
+      {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 272, 544, 816, 1088, 1360,1632,
+       1904, 2176, 2448, 2720, 2992, 3264, 3536, 3808, STATES_MAGNETALGO_STOP}, //Medium-length ramp up
+
+      {0, 136, 272,408,544,680,816,952,1088,1224, 1360,1496,1632,1768,
+       1904, 2040, 2176, 2312, 2448, 2584, 2720, 2856, 2992, 3128, 3264, 3400,  //Long ramp up
+       3536, 3672, 3808, 3944, STATES_MAGNETALGO_STOP},
+};
+
+
+static s_hsm states_main =
+{
+   .p_states = states_main_states,
+   .p_table = &states_main_table[0][0],
+   .p_history = states_main_history,
+   .num_states = max_main_state,
+   .num_events = max_main_event,
+   .current = state_idle,
+};
+
+
 /*
 ****************************************************
 ********** Public Function Definitions *************
@@ -84,111 +245,139 @@ void states_mag_algo_select(void);
 
 
 /*!
-* @brief This looks at all possible events in the main system state machine, ranks them in order
-*        of importance, then sets the current main event to the most important.
+* @brief Enters the main state machine's first state
 * @param[in] NONE
 * @return NONE
 *
 */
 void
-states_update_main_event(void)
+states_init(void)
 {
-   //Leaving this function for future flexibility
-   if(button_mode_status())
+   kernel_sem_init(&mag_tick_sem, 0);
+   hsm_init(&states_main, state_idle);
+
+   for(uint8_t button = 0; button < max_button; button++)
    {
-	   current_event = event_button_mode;
-	   button_mode_reset();
+      gesture_init(&states_gestures[button], &states_gesture_config[button]);
    }
+
+   states_settings_restore();
 }
 
 
 /*!
-* @brief Uses the current main event along with the current main state to determine the next appropriate state
+* @brief Releases the magnet thread for its next step. Called from the timer 5 ISR
 * @param[in] NONE
 * @return NONE
-*
 */
 void
-states_update_main_state(void)
+states_mag_tick(void)
+{
+   kernel_sem_give(&mag_tick_sem);
+}
+
+
+/*!
+* @brief Switches the magnet on a debounced manual button edge. Called from the EXTI3 ISR
+* @param[in] tmp_pressed 1 for a press, 0 for a release
+* @return NONE
+* @note Does nothing outside the manual state. The magnet thread only writes the magnet in
+*       auto, so the two never share it
+*/
+void
+states_manual_edge(uint8_t tmp_pressed)
 {
-	//Update next state depending on current state and current event
-	if(event_button_mode == current_event)
-	{
-		current_event = no_event; //Clear event for next pass
-
-		//Determine next appropriate state
-		switch(current_state)
-		{
-		   case state_idle:
-			   current_state = state_auto_pulse;
-			   break;
-		   case state_auto_pulse:
-			   current_state = state_manual;
-			   break;
-		   case state_manual:
-			   current_state = state_idle;
-			   break;
-		   default:
-			   break;
-
-		}
-	}
-
-   //Call the appropriate function based on the current state
-   switch(current_state)
+   if(manual_active)
    {
-      case state_idle:
-	     states_main_idle();
-	     break;
-	  case state_auto_pulse:
-		  states_main_auto_pulse();
-		  break;
-      case state_manual:
-         states_main_manual();
-         break;
-      default:
-         break;
+      magnet_set_mag(tmp_pressed ? MAGNET_MAG_MAX : MAGNET_MAG_OFF);
    }
 }
 
 
 /*!
-* @brief This updates the brightness of the LEDs based on user input
-* @param[in] NONE
+* @brief Magnet thread. Steps the active electromagnet algorithm once per timer 5 tick,
+*        preempting the tasks thread so console output can't delay a step
+* @param[in] p_context Unused
 * @return NONE
-*
 */
 void
-states_update_led(void)
+states_mag_thread(void * p_context)
 {
+   while(1)
+   {
+      kernel_sem_wait(&mag_tick_sem);
+      states_mag_step();
+   }
+}
 
-   //Array to cycle through
-   const uint16_t brightness_options[4] = {LED_MAG_OFF, LED_MAG_LOW, LED_MAG_MED, LED_MAG_HIGH};
-   static uint8_t current_option = 0;
 
-   //Only toggle brightness if button was pushed
-   if(button_led_status())
-   {
+/*!
+* @brief What the magnet thread does for one timer 5 tick
+* @param[in] NONE
+* @return NONE
+* @note Split out of states_mag_thread so a host build can run it without the kernel
+*/
+void
+states_mag_step(void)
+{
+   watchdog_check_in(watchdog_client_magnet);
 
-	   button_led_reset();
+   if(mag_running)
+   {
+      states_mag_service();
+   }
+}
 
-	   //Increment brightness from options list
-	   if(3 == current_option)
-	   {
-	      current_option = 0;
-	   }
 
-	   else
-	   {
-	      current_option++;
-	   }
+/*!
+* @brief Drains the event queue filled by the button and timer ISRs, turning button presses
+*        and releases into gestures and handing those to the state machine in the order they
+*        happened so none are merged or skipped
+* @param[in] NONE
+* @return NONE
+*
+*/
+void
+states_update_main_event(void)
+{
+   s_event tmp_event;
 
-	   //Push new brightness to LED
-	   led_set_mag(brightness_options[current_option]);
+   while(event_queue_pop(&tmp_event))
+   {
+      switch(tmp_event.type)
+      {
+         case event_type_button_mode:
+            states_gesture_edge(button_mode, &tmp_event);
+            break;
+         case event_type_button_auto:
+            states_gesture_edge(button_auto, &tmp_event);
+            break;
+         case event_type_button_led:
+            states_gesture_edge(button_led, &tmp_event);
+            break;
+         default:
+            break;
+      }
    }
 
+   states_gesture_poll();
+}
+
+
+/*!
+* @brief Runs the do actions of the current state. Transitions are made as events are drained
+*        in states_update_main_event
+* @param[in] NONE
+* @return NONE
+*
+*/
+void
+states_update_main_state(void)
+{
+   hsm_run(&states_main);
 }
 
+
 /*!
 * @brief Print the current state to the serial terminal
 * @param[in] NONE
@@ -198,9 +387,20 @@ states_update_led(void)
 void
 states_print_state(void)
 {
-   const char states_list[3][20] = {"\r\n Idle State\r\n\0", "\r\n Auto State\r\n\0", "\r\n Manual State\r\n\0"};
+   if(hsm_is_in(&states_main, state_auto_pulse))
+   {
+      uart1_printf("\r\n Auto State\r\n");
+   }
+
+   else if(hsm_is_in(&states_main, state_manual))
+   {
+      uart1_printf("\r\n Manual State\r\n");
+   }
 
-   uart1_printf(states_list[current_state]);
+   else
+   {
+      uart1_printf("\r\n Idle State\r\n");
+   }
 
 }
 
@@ -213,137 +413,365 @@ states_print_state(void)
 
 
 /*!
-* @brief In this state, the system will turn off all external peripherals and wait for a button press
+* @brief Hands an event to the main state machine and traces the new state if it changed
+* @param[in] tmp_event Event to deliver
+* @return NONE
+*/
+void
+states_main_dispatch(e_event_main tmp_event)
+{
+   uint8_t tmp_previous = hsm_get_state(&states_main);
+
+   if(hsm_dispatch(&states_main, tmp_event) && (tmp_previous != hsm_get_state(&states_main)))
+   {
+      TRACE(trace_id_state, hsm_get_state(&states_main), 0);
+   }
+}
+
+
+/*!
+* @brief Steps the LED to the next brightness, called for each LED button click and repeat
+* @param[in] NONE
+* @return NONE
+*
+*/
+void
+states_update_led(void)
+{
+   //Step up through the gamma levels, then wrap to off
+   if(LED_LEVEL_HIGH == states_led_level)
+   {
+      states_led_level = LED_LEVEL_OFF;
+   }
+
+   else
+   {
+      states_led_level++;
+   }
+
+   //Push new brightness to LED
+   led_set_level(states_led_level);
+
+}
+
+
+/*!
+* @brief Entering idle turns off all external peripherals, then the system waits for a button press
 * @param[in] NONE
 * @return NONE
 *
 */
 void
-states_main_idle(void)
+states_main_idle_entry(void)
 {
-	magnet_set_mag(MAGNET_MAG_OFF);
+   magnet_set_mag(MAGNET_MAG_OFF);
 }
 
 
 /*!
-* @brief In this state, the system will go through one of its predefined electromagnet cycles
+* @brief Entering manual pushes the current button level to the magnet straight away,
+*        from then on the manual button's edges drive it, see states_manual_edge
 * @param[in] NONE
 * @return NONE
 *
 */
 void
-states_main_auto_pulse(void)
+states_main_manual_entry(void)
 {
-   states_mag_service();
+   uint32_t tmp_primask = __get_PRIMASK();
+
+   //An edge can't slip in between reading the level and handing the magnet to the ISR
+   __disable_irq();
+   manual_active = 1;
+   magnet_set_mag(button_manual_status() ? MAGNET_MAG_MAX : MAGNET_MAG_OFF);
+   __set_PRIMASK(tmp_primask);
 }
 
+
 /*!
-* @brief In this state, the system will pulse the electromagnet based on the user's button presses
+* @brief Leaving manual takes the magnet back from the manual button, before the next state's entry
 * @param[in] NONE
 * @return NONE
 *
 */
 void
-states_main_manual(void)
+states_main_manual_exit(void)
+{
+   manual_active = 0;
+}
+
+
+/*!
+* @brief This will updated the next electromagnet magnitude based on the active algorithm.
+*        Called by the magnet thread once per timer 5 tick while in the auto state.
+* @param[in] NONE
+* @return NONE
+* @note The algorithm is picked by which child of state_auto_pulse is active
+*/
+void
+states_mag_service(void)
 {
-   if(button_manual_status())
+   uint8_t tmp_algo = current_mag_algo;
+   uint8_t tmp_index = 0;
+
+   //Check if the current algorithm has completed
+   if(magnet_lookup[tmp_algo][current_mag_step] != STATES_MAGNETALGO_STOP)
    {
-      magnet_set_mag(MAGNET_MAG_MAX);
+      current_mag_step++;
+
+      //Reversed, the same steps are walked from the peak back down to zero
+      tmp_index = mag_reverse ? (uint8_t)(current_mag_length - current_mag_step) : current_mag_step;
+      magnet_set_mag(magnet_lookup[tmp_algo][tmp_index]); //Push next value to external electromagnet
    }
 
    else
    {
-	   magnet_set_mag(MAGNET_MAG_OFF);
+      current_mag_step = 0;
+   }
+
+}
+
+
+/*!
+* @brief Starts an electromagnet algorithm from the beginning
+* @param[in] tmp_algo Row of magnet_lookup
+* @return NONE
+* @note The magnet thread is held off while the algorithm and step change
+*/
+void
+states_mag_algo_start(uint8_t tmp_algo)
+{
+   uint8_t tmp_length = 0;
+
+   while(STATES_MAGNETALGO_STOP != magnet_lookup[tmp_algo][tmp_length])
+   {
+      tmp_length++;
    }
 
-	//uart1_printf("\n\r State: Manual\n\r");
+   mag_running = 0;
+   current_mag_algo = tmp_algo;
+   current_mag_length = tmp_length;
+   current_mag_step = 0;
+   mag_running = 1;
 }
 
 
 /*!
-* @brief This will updated the next electromagnet magnitude based on a selectable algorithm
+* @brief Entry action of the short ramp state
 * @param[in] NONE
 * @return NONE
 *
 */
 void
-states_mag_service(void)
+states_mag_short_entry(void)
+{
+   states_mag_algo_start(0);
+}
+
+
+/*!
+* @brief Entry action of the medium ramp state
+* @param[in] NONE
+* @return NONE
+*
+*/
+void
+states_mag_medium_entry(void)
+{
+   states_mag_algo_start(1);
+}
+
+
+/*!
+* @brief Entry action of the long ramp state
+* @param[in] NONE
+* @return NONE
+*
+*/
+void
+states_mag_long_entry(void)
+{
+   states_mag_algo_start(2);
+}
+
+
+/*!
+* @brief Leaving auto stops the magnet thread from stepping, so the next state owns the magnet
+* @param[in] NONE
+* @return NONE
+*
+*/
+void
+states_auto_pulse_exit(void)
+{
+   mag_running = 0;
+}
+
+
+/*!
+* @brief Flips the direction the auto algorithms are played in, on an auto button double-click
+* @param[in] NONE
+* @return NONE
+* @note Takes effect from the magnet thread's next step
+*/
+void
+states_mag_reverse(void)
 {
+   mag_reverse = mag_reverse ? 0 : 1;
+}
 
-   static uint8_t i = 0;
-   static uint8_t previous_mag_algo = 0;
 
-   states_mag_algo_select();
+/*!
+* @brief Saves the auto algorithm, LED level and ramp direction, on a mode button long-press
+* @param[in] NONE
+* @return NONE
+* @note Kept in RAM that startup leaves alone, so they come back after any reset but not a power cycle
+*/
+void
+states_settings_save(void)
+{
+   //The active child is only written to the history on the way out, so read it live while in auto
+   states_settings.auto_state = hsm_is_in(&states_main, state_auto_pulse) ?
+                                hsm_get_state(&states_main) : states_main_history[state_auto_pulse];
+   states_settings.led_level = states_led_level;
+   states_settings.mag_reverse = mag_reverse;
+   states_settings.magic = STATES_SETTINGS_MAGIC;
+
+   uart1_printf("\r\n Settings saved\r\n");
+}
+
 
-   //If the selected magnet algorithm has changed, reset i to start from the beginning
-   if(current_mag_algo != previous_mag_algo)
+/*!
+* @brief Puts back the settings saved before a reset, if there are any
+* @param[in] NONE
+* @return NONE
+*/
+void
+states_settings_restore(void)
+{
+   if(STATES_SETTINGS_MAGIC != states_settings.magic)
    {
-      i = 0;
+      return;
    }
 
-   const uint16_t magnet_lookup[STATES_MAGNETALGO_MAX][40] =
+   //Auto resumes in the saved algorithm the first time it is entered
+   if((state_auto_short <= states_settings.auto_state) && (state_auto_long >= states_settings.auto_state))
    {
-         {0, 544, 1088, 1632, 2176, 2720, 3264, 3808, STATES_MAGNETALGO_STOP},  //Very short ramp up
+      states_main_history[state_auto_pulse] = states_settings.auto_state;
+   }
+
+   if(LED_LEVEL_HIGH >= states_settings.led_level)
+   {
+      states_led_level = states_settings.led_level;
+      led_set_level(states_led_level);
+   }
+
+   mag_reverse = states_settings.mag_reverse ? 1 : 0;
+}
 
-         {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 272, 544, 816, 1088, 1360,1632,
-          1904, 2176, 2448, 2720, 2992, 3264, 3536, 3808, STATES_MAGNETALGO_STOP}, //Medium-length ramp up
 
-         {0, 136, 272,408,544,680,816,952,1088,1224, 1360,1496,1632,1768,
-          1904, 2040, 2176, 2312, 2448, 2584, 2720, 2856, 2992, 3128, 3264, 3400,  //Long ramp up
-          3536, 3672, 3808, 3944, STATES_MAGNETALGO_STOP},
-   };
+/*!
+* @brief Runs one button press or release through that button's gesture recognizer
+* @param[in] tmp_button Button the event came from
+* @param[in] p_event Queued event, its data is the e_debounce_edge
+* @return NONE
+* @note Deadlines that passed before the edge are handled first, so gestures stay in order
+*/
+void
+states_gesture_edge(e_button tmp_button, const s_event * p_event)
+{
+   s_gesture * p_gesture = &states_gestures[tmp_button];
+   e_gesture tmp_gesture = gesture_none;
 
-   //If timer5 has expired, update the electromagnet magnitude to the next value
-   if(timers_tim5_get_status())
+   while(gesture_none != (tmp_gesture = gesture_poll(p_gesture, p_event->timestamp)))
    {
+      states_gesture_dispatch(tmp_button, tmp_gesture);
+   }
 
-      timers_tim5_reset_flag();
+   states_gesture_dispatch(tmp_button, gesture_edge(p_gesture, (e_debounce_edge)p_event->data, p_event->timestamp));
+}
+
+
+/*!
+* @brief Hands out the gestures that time has completed, and sets the gesture timer
+*        for the next one due
+* @param[in] NONE
+* @return NONE
+*/
+void
+states_gesture_poll(void)
+{
+   uint32_t tmp_now = input_replay_get_time_us(); //The clock the button events were stamped on
+   uint32_t tmp_deadline = 0;
+   uint32_t tmp_wait = 0;
+   uint8_t tmp_waiting = 0;
+   e_gesture tmp_gesture = gesture_none;
 
-      //Check if the current algorithm has completed
-      if(magnet_lookup[current_mag_algo][i] != STATES_MAGNETALGO_STOP)
+   for(uint8_t button = 0; button < max_button; button++)
+   {
+      while(gesture_none != (tmp_gesture = gesture_poll(&states_gestures[button], tmp_now)))
       {
-         i++;
-         magnet_set_mag(magnet_lookup[current_mag_algo][i]); //Push next value to external electromagnet
+         states_gesture_dispatch(button, tmp_gesture);
       }
 
-      else
+      if(gesture_get_deadline(&states_gestures[button], &tmp_deadline) &&
+         (!tmp_waiting || (system_clock_elapsed(tmp_now, tmp_deadline) < tmp_wait)))
       {
-         i = 0;
+         tmp_wait = system_clock_elapsed(tmp_now, tmp_deadline);
+         tmp_waiting = 1;
       }
-
    }
 
-   previous_mag_algo = current_mag_algo;
+   if(tmp_waiting)
+   {
+      //Round up, a wake that comes early would only find nothing due and sleep again
+      soft_timer_start(&states_gesture_timer, (tmp_wait + 999UL) / 1000UL, SOFT_TIMERS_ONE_SHOT,
+                       states_gesture_wake, NULL);
+   }
 
+   else
+   {
+      soft_timer_stop(&states_gesture_timer);
+   }
 }
 
 
 /*!
-* @brief Checks if the user has pressed the auto button and updates the electromagnet algorithm accordingly
-* @param[in] NONE
+* @brief Delivers a gesture, through the state table or straight to the LED
+* @param[in] tmp_button Button that made the gesture
+* @param[in] tmp_gesture Gesture, gesture_none does nothing
 * @return NONE
-*
 */
 void
-states_mag_algo_select(void)
+states_gesture_dispatch(e_button tmp_button, e_gesture tmp_gesture)
 {
-   //Check if user has pressed "auto" button
-   if(button_auto_status())
+   uint8_t tmp_event = states_gesture_events[tmp_button][tmp_gesture];
+
+   if(STATES_LED_EVENT == tmp_event)
    {
-      button_auto_reset();
+      //The LED steps in every state, so it is kept out of the table
+      uint32_t tmp_start = profiler_begin();
 
-      //Check if we're at the end of our list of different algorithms. If not, increment. If so, reset.
-      if((STATES_MAGNETALGO_MAX - 1) > current_mag_algo)
-      {
-         current_mag_algo++;
-      }
+      states_update_led();
+      profiler_end(profiler_stage_led, tmp_start);
+   }
 
-      else
-      {
-         current_mag_algo = 0;
-      }
+   else if(STATES_NO_EVENT != tmp_event)
+   {
+      states_main_dispatch((e_event_main)tmp_event);
    }
+}
 
+
+/*!
+* @brief Gesture timer callback, lets the states task poll the recognizers
+* @param[in] p_context Unused
+* @return NONE
+*/
+void
+states_gesture_wake(void * p_context)
+{
+   scheduler_signal(scheduler_task_states);
 }
 
 /* end of file */
@@ -27,6 +27,15 @@
 */
 
 #include "system_clock.h"
+#include "watchdog.h"
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static volatile uint32_t system_tick_ms = 0; //Milliseconds since boot, wraps after ~49 days
+static volatile uint32_t system_tick_cycles = 0; //Cycle count at the start of the current tick
 
 /*
 ****************************************************
@@ -42,6 +51,7 @@ void voltage_scale_init(void);
 void hsi_init(void);
 void pll_init(void);
 void system_tick_init(uint32_t num_ticks);
+void system_cycle_counter_init(void);
 
 /*
 ****************************************************
@@ -67,10 +77,51 @@ system_clock_init(void)
    pll_init();
    ahb_prescaler_init();
    apb_prescaler_init();
-   system_tick_init(1000UL);
+   system_cycle_counter_init();
+   system_tick_init(SYSTEM_CLOCK_TICK_HZ);
    RCC->CFGR |= (RCC_CFGR_MCO1EN | RCC_CFGR_MCO2EN);
 }
 
+
+/*!
+* @brief Get the number of milliseconds since the system tick was started
+* @param[in] NONE
+* @return system_tick_ms
+* @note Compare values with the system_clock_is_after() family so tick wrap is handled
+*/
+uint32_t
+system_clock_get_ms(void)
+{
+   return(system_tick_ms);
+}
+
+
+/*!
+* @brief Get a monotonic microsecond timestamp
+* @param[in] NONE
+* @return Microseconds since boot, wraps about every 71 minutes
+* @note The millisecond part comes from the tick count and the sub-millisecond part from
+*       the cycle counter, so only a 32-bit divide is needed. Safe from any context and
+*       stays monotonic even if the tick interrupt is held off by a masked section.
+*/
+uint32_t
+system_clock_get_us(void)
+{
+   uint32_t tmp_ms = 0;
+   uint32_t tmp_base = 0;
+   uint32_t tmp_now = 0;
+
+   //Retry if the tick interrupt landed between reading the two halves
+   do
+   {
+      tmp_ms = system_tick_ms;
+      tmp_base = system_tick_cycles;
+      tmp_now = system_clock_get_cycles();
+   } while(tmp_ms != system_tick_ms);
+
+   return((tmp_ms * 1000UL) + system_clock_cycles_to_us(tmp_now - tmp_base));
+}
+
 /*
 ****************************************************
 ********** Private Function Definitions ************
@@ -244,8 +295,43 @@ system_tick_init(uint32_t num_ticks)
    uint32_t temp_load_val = ((SYSTEM_CLOCK_FREQUENCY / num_ticks) - 1UL);
    SysTick->LOAD = temp_load_val;
    SysTick->VAL = 0UL;
-   SysTick->CTRL  = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
 
+   //Line the cycle counter up with the tick so system_clock_get_us() has no offset
+   system_tick_cycles = system_clock_get_cycles();
+   SysTick->CTRL  = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+
+}
+
+
+/*!
+* @brief System tick interrupt handler, fires once per millisecond
+* @param[in] NONE
+* @return NONE
+*/
+void
+SysTick_Handler(void)
+{
+   system_tick_ms++;
+
+   //Advance by the nominal tick length rather than sampling the counter, so handler
+   //latency never makes the microsecond time step backwards
+   system_tick_cycles += SYSTEM_CLOCK_CYCLES_PER_TICK;
+
+   watchdog_tick();
+}
+
+
+/*!
+* @brief Enable the DWT cycle counter used for sub-microsecond timestamps
+* @param[in] NONE
+* @return NONE
+*/
+void
+system_cycle_counter_init(void)
+{
+   CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+   DWT->CYCCNT = 0;
+   DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
 }
 
 
@@ -27,23 +27,44 @@
 */
 
 #include "timers.h"
-
+#include "scheduler.h"
+#include "trace.h"
+#include "input_replay.h"
+#include "states.h"
+#include "event_queue.h"
+#include "watchdog.h"
+#include <stddef.h>
 
 
 /*
 ****************************************************
-************* File-Static Variables ****************
+********** Compile-Time Configurations *************
 ****************************************************
 */
-static uint8_t tim5_interrupt_flag = 0;
 
+#define TIM5_PSC TIMERS_PSC_FOR(TIMERS_APB1_CLOCK_HZ, TIMERS_MAGNET_STEP_HZ, TIMERS_MAX_ARR_32)
+#define TIM5_ARR TIMERS_ARR_FOR(TIMERS_APB1_CLOCK_HZ, TIMERS_MAGNET_STEP_HZ, TIMERS_MAX_ARR_32)
+
+_Static_assert(TIMERS_CONFIG_OK(TIMERS_APB1_CLOCK_HZ, TIMERS_MAGNET_STEP_HZ, TIM5_PSC, TIM5_ARR, TIMERS_MAX_ARR_32),
+               "TIMERS_MAGNET_STEP_HZ can't be reached by timer 5");
+
+//The magnet thread checks in with the watchdog once per step
+_Static_assert((TIMERS_MAGNET_STEP_HZ * WATCHDOG_CHECK_MS) >= 1000UL,
+               "TIMERS_MAGNET_STEP_HZ is too slow for the watchdog window");
+
+
+/* ***** File-Static Variables ***** */
+
+//Indexed by e_timers_id. Only lists the timers this firmware drives
+static const s_timers_instance timers_instances[max_timers_id] =
+{
+   [timers_tim1]  = {TIM1,  &RCC->APB2ENR, RCC_APB2ENR_TIM1EN,  TIMERS_APB2_CLOCK_HZ, TIMERS_MAX_ARR_16, TIM1_UP_TIM10_IRQn},
+   [timers_tim5]  = {TIM5,  &RCC->APB1ENR, RCC_APB1ENR_TIM5EN,  TIMERS_APB1_CLOCK_HZ, TIMERS_MAX_ARR_32, TIM5_IRQn},
+   [timers_tim6]  = {TIM6,  &RCC->APB1ENR, RCC_APB1ENR_TIM6EN,  TIMERS_APB1_CLOCK_HZ, TIMERS_MAX_ARR_16, TIM6_DAC_IRQn},
+   [timers_tim9]  = {TIM9,  &RCC->APB2ENR, RCC_APB2ENR_TIM9EN,  TIMERS_APB2_CLOCK_HZ, TIMERS_MAX_ARR_16, TIM1_BRK_TIM9_IRQn},
+   [timers_tim11] = {TIM11, &RCC->APB2ENR, RCC_APB2ENR_TIM11EN, TIMERS_APB2_CLOCK_HZ, TIMERS_MAX_ARR_16, TIM1_TRG_COM_TIM11_IRQn},
+};
 
-/*
-****************************************************
-********** Private Function Prototypes *************
-****************************************************
-*/
-void timer_timer11_gpio_init(void);
 
 /*
 ****************************************************
@@ -51,213 +72,197 @@ void timer_timer11_gpio_init(void);
 ****************************************************
 */
 
-
 /*!
-* @brief Initialize timer 5 to
-* @param[in]
-* @return  NONE
-
+* @brief Gets the description of a timer
+* @param[in] tmp_id Timer, e_timers_id
+* @return Register block, clock and counter width of the timer
 */
-void
-timers_timer5_init(void)
+const s_timers_instance *
+timers_get_instance(e_timers_id tmp_id)
 {
-   //Enable main timer clock
-   RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;
-
-   //Fill timer prescale registers. Formula: total_prescale = (PSC x ARR)
-   TIM5->PSC = 9999;
-   TIM5->ARR = 1000;
-
-   //Set timer overflow as interrupt source
-   TIM5->CR1 |= TIM_CR1_URS;
-
-   //Enable timer interrupts
-   TIM5->DIER |= TIM_DIER_UIE;
-
-   //Set timer to trigger output. This is needed to trigger DMA
-   TIM5->CR2 |= TIM_CR2_MMS_1;
-
-   //Push setting changes to timer5
-   TIM5->EGR |= TIM_EGR_UG;
-
-   //Initialize timer5 ISR
-   NVIC_EnableIRQ(TIM5_IRQn);
-
-   //Enable timer
-   TIM5->CR1 |= TIM_CR1_CEN;
+   return &timers_instances[tmp_id];
 }
 
 
 /*!
-* @brief Adjusts the frequency of timer 5 on the fly
-* @param[in] tmp_frequency
-* @return  NONE
+* @brief Picks a prescaler and reload value for a frequency
+* @param[in] tmp_clock_hz Timer kernel clock
+* @param[in] tmp_hz Wanted update rate
+* @param[in] tmp_counts Counts per period, or TIMERS_COUNTS_ANY for the finest resolution that fits
+* @param[in] tmp_max_arr Largest reload value the counter takes
+* @param[out] p_config Solved PSC and ARR
+* @return 1 if the rate can be reached within TIMERS_MAX_ERROR_PPM, 0 otherwise (p_config untouched)
+* @note Run time twin of the TIMERS_PSC_FOR macros, they share the same rounding
 */
-void
-timers_timer5_freq(uint32_t tmp_frequency)
+uint8_t
+timers_solve(uint32_t tmp_clock_hz, uint32_t tmp_hz, uint32_t tmp_counts, uint32_t tmp_max_arr, s_timers_config * p_config)
 {
-   //Disable timer
-   TIM5->CR1 &= ~TIM_CR1_CEN;
+   uint64_t tmp_psc;
+   uint64_t tmp_arr;
 
-   //Fill timer prescale registers. Formula: total_prescale = (PSC x ARR)
-   TIM5->PSC = 1000;
-   TIM5->ARR = tmp_frequency;
-
-   //Set timer overflow as interrupt source
-   TIM5->CR1 |= TIM_CR1_URS;
-
-   //Enable timer interrupts
-   TIM5->DIER |= TIM_DIER_UIE;
+   //Needs at least two counts per period and a counts value the counter can hold
+   if((0 == tmp_hz) || ((tmp_clock_hz / 2U) < tmp_hz) || ((uint64_t)tmp_counts > ((uint64_t)tmp_max_arr + 1U)))
+   {
+      return 0;
+   }
 
-   //Set timer to trigger output. This is needed to trigger DMA
-   TIM5->CR2 |= TIM_CR2_MMS_1;
+   if(TIMERS_COUNTS_ANY == tmp_counts)
+   {
+      tmp_psc = TIMERS_PSC_FOR(tmp_clock_hz, tmp_hz, tmp_max_arr);
+      tmp_arr = TIMERS_ARR_FOR(tmp_clock_hz, tmp_hz, tmp_max_arr);
+   }
+   else
+   {
+      //A rate so high the prescaler rounds to zero wraps to a huge value and fails the check below
+      tmp_psc = TIMERS_PSC_FOR_COUNTS(tmp_clock_hz, tmp_hz, tmp_counts);
+      tmp_arr = tmp_counts - 1U;
+   }
 
-   //Push setting changes to timer5
-   TIM5->EGR |= TIM_EGR_UG;
+   if(!TIMERS_CONFIG_OK(tmp_clock_hz, tmp_hz, tmp_psc, tmp_arr, tmp_max_arr))
+   {
+      return 0;
+   }
 
-   //Enable timer
-   TIM5->CR1 |= TIM_CR1_CEN;
+   p_config->psc = (uint32_t)tmp_psc;
+   p_config->arr = (uint32_t)tmp_arr;
+   return 1;
 }
 
+
 /*!
-* @brief Initialize timer 11 to 100mS, PWM mode
-* @param[in] 
-* @return  NONE
+* @brief Clocks a timer and loads its prescaler and reload value
+* @param[in] tmp_id Timer, e_timers_id
+* @param[in] p_config PSC and ARR, from timers_solve or the TIMERS_PSC_FOR macros
+* @return NONE
+* @note Leaves the timer stopped with only counter overflow raising UIF. Mode bits
+*       (OPM, ARPE, MMS, channels) are up to the caller
 */
 void
-timers_timer11_init(void)
+timers_init(e_timers_id tmp_id, const s_timers_config * p_config)
 {
+   const s_timers_instance * p_timer = &timers_instances[tmp_id];
 
-   RCC->APB2ENR |= RCC_APB2ENR_TIM11EN; //Enable APB2 clock
-   timer_timer11_gpio_init();
-   TIM11->ARR = TIM11_ARR; //Set Autoreload
-   TIM11->PSC = 9999UL; //Initialize Prescaler
-
-   TIM11->EGR = TIM_EGR_UG; //Update Event
-   TIM11->CCER |= TIM_CCER_CC1E; //Enable Channel 1 output
-   TIM11->CCMR1 |=  TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1M_2;//Polarity of duty cycle
-   TIM11->CCR1 = TIM11->ARR / 2;  //Set initial duty cycle to 50%
-
-   TIM11->CCMR1 |= TIM_CCMR1_OC1PE; //Enable Preload register
+   *p_timer->p_rcc_enr |= p_timer->rcc_en_bit;
 
-   timers_timer11_enable();
-   timers_timer11_output_enable();
+   p_timer->p_tim->CR1 = TIM_CR1_URS;
+   p_timer->p_tim->PSC = p_config->psc;
+   p_timer->p_tim->ARR = p_config->arr;
 
-   TIM11->EGR |= TIM_EGR_UG;  //Push setting changes to timer11
+   //Load the prescaler now rather than on the first overflow
+   p_timer->p_tim->EGR = TIM_EGR_UG;
+   p_timer->p_tim->SR = 0;
 }
 
+
 /*!
-* @brief Adjusts the duty cycle of timer 11 on the fly
-* @param[in] tmp_frequency
-* @return  NONE
+* @brief Changes the update rate of a running timer
+* @param[in] tmp_id Timer, e_timers_id
+* @param[in] tmp_hz Wanted update rate
+* @param[in] tmp_counts Counts per period, or TIMERS_COUNTS_ANY
+* @param[out] p_error_ppm Achieved error, can be NULL
+* @return 1 if the rate was applied, 0 if it can't be reached (timer unchanged)
+* @note PSC is always buffered. Set ARPE on the timer and ARR is too, so the new rate
+*       starts cleanly at the next overflow
 */
-void
-timers_timer11_duty(uint16_t tmp_duty)
+uint8_t
+timers_set_hz(e_timers_id tmp_id, uint32_t tmp_hz, uint32_t tmp_counts, int32_t * p_error_ppm)
 {
-   if(0 != tmp_duty)
+   const s_timers_instance * p_timer = &timers_instances[tmp_id];
+   s_timers_config tmp_config;
+
+   if(!timers_solve(p_timer->clock_hz, tmp_hz, tmp_counts, p_timer->max_arr, &tmp_config))
    {
-      TIM11->CCR1 = tmp_duty;
-      TIM11->EGR = TIM_EGR_UG; //Update Event
-      timers_delay_mini(100);
+      return 0;
    }
-}
 
+   p_timer->p_tim->PSC = tmp_config.psc;
+   p_timer->p_tim->ARR = tmp_config.arr;
 
+   if(NULL != p_error_ppm)
+   {
+      *p_error_ppm = (int32_t)TIMERS_ERROR_PPM(p_timer->clock_hz, tmp_hz, tmp_config.psc, tmp_config.arr);
+   }
+   return 1;
+}
 
 
 /*!
-* @brief Check if the timer 5 interrupt has triggered
-* @param[in] NONE
-* @return  tim5_interrupt_flag
+* @brief Interrupts on every counter overflow
+* @param[in] tmp_id Timer, e_timers_id
+* @param[in] tmp_priority NVIC priority
+* @return NONE
+* @note Timers 1/10, 1/9 and 1/11 share vectors, the handler has to check which timer fired
 */
-uint8_t
-timers_tim5_get_status(void)
+void
+timers_update_irq_enable(e_timers_id tmp_id, uint32_t tmp_priority)
 {
-   return(tim5_interrupt_flag);
-}
+   const s_timers_instance * p_timer = &timers_instances[tmp_id];
 
+   p_timer->p_tim->DIER |= TIM_DIER_UIE;
+   NVIC_SetPriority(p_timer->update_irq, tmp_priority);
+   NVIC_EnableIRQ(p_timer->update_irq);
+}
 
 
 /*!
-* @brief
-* @return  NONE
+* @brief Starts a timer counting
+* @param[in] tmp_id Timer, e_timers_id
+* @return NONE
 */
 void
-timers_tim5_reset_flag(void)
+timers_start(e_timers_id tmp_id)
 {
-   tim5_interrupt_flag = 0;
+   timers_instances[tmp_id].p_tim->CR1 |= TIM_CR1_CEN;
 }
 
 
 /*!
-* @brief Enables Timer11 channel 1 output, which pushes the current timer logic value to a specified GPIO
-* @param[in] NONE
-* @return  NONE
+* @brief Stops a timer, the count is kept
+* @param[in] tmp_id Timer, e_timers_id
+* @return NONE
 */
 void
-timers_timer11_output_enable(void)
+timers_stop(e_timers_id tmp_id)
 {
-   TIM11->CCER |= TIM_CCER_CC1E;   
-}
-   
-/*!
-* @brief Disables Timer11 channel 1 output
-* @param[in] NONE
-* @return  NONE
-* @note If GPIO is open drain, output of channel 1
-*       will go into high z mode. 
-*/
-void
-timers_timer11_output_disable(void)
-{
-   TIM11->CCER &= ~TIM_CCER_CC1E; 
+   timers_instances[tmp_id].p_tim->CR1 &= ~TIM_CR1_CEN;
 }
 
 
 /*!
-* @brief Bad delay that locks the processor
-* @param[in] NONE
-* @return  NONE
+* @brief Gets the update rate a timer is running at
+* @param[in] tmp_id Timer, e_timers_id
+* @return Rate in millihertz, from the live PSC and ARR
 */
-void
-timers_delay(uint32_t delay_time)
+uint32_t
+timers_get_mhz(e_timers_id tmp_id)
 {
-   uint32_t i = 0;
-   for(i = 0; i < (delay_time * 1000); i++) {} //lock MCU until delay time finishes
+   const s_timers_instance * p_timer = &timers_instances[tmp_id];
+
+   return (uint32_t)TIMERS_MHZ_FOR(p_timer->clock_hz, p_timer->p_tim->PSC, p_timer->p_tim->ARR);
 }
 
 
 /*!
-* @brief Bad delay that locks the processor
+* @brief Initialize timer 5 as the magnet step tick, TIMERS_MAGNET_STEP_HZ
 * @param[in] NONE
 * @return  NONE
 */
 void
-timers_delay_mini(uint32_t delay_time)
+timers_timer5_init(void)
 {
-   uint32_t i = 0;
-   for(i = 0; i < (delay_time);i++) {} //lock MCU until delay time finishes
-}
+   const s_timers_config tmp_config = {TIM5_PSC, TIM5_ARR};
 
+   timers_init(timers_tim5, &tmp_config);
 
-/* Private Function Definitions */
+   //Set timer to trigger output. This is needed to trigger DMA
+   TIM5->CR2 |= TIM_CR2_MMS_1;
 
-/*!
-* @brief Initialize PC12 as Timer11 channel1 output
-* @param[in] NONE
-* @return  NONE
-*/
-void
-timer_timer11_gpio_init(void)
-{
-   gpio_clk_init(TIMER11_CHANNEL1);
-   gpio_func_init(TIMER11_CHANNEL1, GPIO_MODER_ALTERNATE_FUNCTION);
-   gpio_type_init(TIMER11_CHANNEL1, GPIO_OTYPER_PUSH_PULL);
-   gpio_speed_init(TIMER11_CHANNEL1, GPIO_OSPEEDR_VERY_HIGH);
-   gpio_pupd_init(TIMER11_CHANNEL1, GPIO_PUPDR_NONE);
-   GPIOC->AFR[1] |= GPIO_AFRH_PIN12_AF3; 
+   //Same priority as every other event producer
+   timers_update_irq_enable(timers_tim5, EVENT_QUEUE_IRQ_PRIORITY);
+   timers_start(timers_tim5);
 }
 
+
 /*
 * @brief Timer 5 interrupt handler
 * @param[in] NONE
@@ -266,9 +271,18 @@ timer_timer11_gpio_init(void)
 void
 TIM5_IRQHandler(void)
 {
-   tim5_interrupt_flag = 1;
+   TRACE(trace_id_isr_enter, trace_isr_tim5, 0);
+
+   //Goes straight to the magnet thread rather than through the event queue
+   if(input_replay_capture(input_replay_source_event, event_type_tim5, 0))
+   {
+      states_mag_tick();
+   }
+
+   //rc_w0, a read-modify-write would also clear capture flags set since the read
+   TIM5->SR = ~TIM_SR_UIF;
 
-   TIM5->SR &= ~TIM_SR_UIF;
+   TRACE(trace_id_isr_exit, trace_isr_tim5, 0);
 }
 
 
@@ -0,0 +1,251 @@
+/** @file trace.c
+*
+* @brief  This file contains a RAM flight recorder of cycle-stamped system events.
+*         The buffer can be dumped over USART1 and converted with Tools/trace2json.py.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "trace.h"
+#include "system_clock.h"
+#include "uart.h"
+#include "watchdog.h"
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void trace_send_u32(uint32_t tmp_value);
+void trace_send_u16(uint16_t tmp_value);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+
+//Oldest records are overwritten once full, so a dump always holds the most recent history
+static s_trace_record trace_buffer[TRACE_BUFFER_SIZE];
+static uint32_t trace_head = 0;        //Next record to write
+static uint32_t trace_count = 0;       //Valid records, at most TRACE_BUFFER_SIZE
+static uint32_t trace_overwritten = 0; //Records lost to wrapping since the last start
+static volatile uint8_t trace_enabled = 0;
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Clears the buffer and starts recording
+* @param[in] NONE
+* @return NONE
+* @note The cycle counter must already be running, see system_clock_init
+*/
+void
+trace_init(void)
+{
+   trace_start();
+}
+
+
+/*!
+* @brief Adds one record to the ring. Safe to call from any ISR or task
+* @param[in] tmp_id Record type
+* @param[in] tmp_arg8 Small argument, meaning depends on tmp_id
+* @param[in] tmp_arg16 Wide argument, meaning depends on tmp_id
+* @return NONE
+* @note Interrupts are masked for the few cycles it takes to claim a slot and fill it,
+*       so records from nested ISRs are never torn and stay in time order
+*/
+void
+trace_record(e_trace_id tmp_id, uint8_t tmp_arg8, uint16_t tmp_arg16)
+{
+   uint32_t tmp_primask = 0;
+   s_trace_record * p_record = 0;
+
+   if(!trace_enabled)
+   {
+      return;
+   }
+
+   tmp_primask = __get_PRIMASK();
+   __disable_irq();
+
+   p_record = &trace_buffer[trace_head];
+   p_record->cycles = system_clock_get_cycles();
+   p_record->id = tmp_id;
+   p_record->arg8 = tmp_arg8;
+   p_record->arg16 = tmp_arg16;
+
+   trace_head = (trace_head + 1U) & (TRACE_BUFFER_SIZE - 1U);
+
+   if(TRACE_BUFFER_SIZE > trace_count)
+   {
+      trace_count++;
+   }
+
+   else
+   {
+      trace_overwritten++;
+   }
+
+   __set_PRIMASK(tmp_primask);
+}
+
+
+/*!
+* @brief Empties the buffer and resumes recording
+* @param[in] NONE
+* @return NONE
+*/
+void
+trace_start(void)
+{
+   trace_enabled = 0;
+   trace_head = 0;
+   trace_count = 0;
+   trace_overwritten = 0;
+   trace_enabled = 1;
+}
+
+
+/*!
+* @brief Freezes the buffer so it can be dumped
+* @param[in] NONE
+* @return NONE
+*/
+void
+trace_stop(void)
+{
+   trace_enabled = 0;
+}
+
+
+/*!
+* @brief Stops recording and sends the buffer over USART1, oldest record first
+* @param[in] NONE
+* @return NONE
+* @note Binary, little endian: TRACE_MAGIC, u32 CPU clock in Hz, u32 record count,
+*       u32 overwritten count, then count records of u32 cycles, u8 id, u8 arg8, u16 arg16.
+*       Blocks while sending, a full buffer takes ~2s at 9600 baud.
+*/
+void
+trace_dump(void)
+{
+   const char tmp_magic[] = TRACE_MAGIC;
+   uint32_t tmp_index = 0;
+
+   trace_stop();
+
+   //Header plus records, one byte time at most UART1_TX_TIMEOUT_US
+   watchdog_busy((((16UL + (trace_count * sizeof(s_trace_record))) * UART1_TX_TIMEOUT_US) / 1000UL) + 1UL);
+
+   for(uint8_t i = 0; i < (sizeof(tmp_magic) - 1U); i++)
+   {
+      uart1_send_byte(tmp_magic[i]);
+   }
+
+   trace_send_u32(SYSTEM_CLOCK_FREQUENCY);
+   trace_send_u32(trace_count);
+   trace_send_u32(trace_overwritten);
+
+   tmp_index = (trace_head - trace_count) & (TRACE_BUFFER_SIZE - 1U);
+
+   for(uint32_t i = 0; i < trace_count; i++)
+   {
+      const s_trace_record * p_record = &trace_buffer[tmp_index];
+
+      trace_send_u32(p_record->cycles);
+      uart1_send_byte(p_record->id);
+      uart1_send_byte(p_record->arg8);
+      trace_send_u16(p_record->arg16);
+
+      tmp_index = (tmp_index + 1U) & (TRACE_BUFFER_SIZE - 1U);
+   }
+}
+
+
+/*!
+* @brief Get the number of records in the buffer
+* @param[in] NONE
+* @return trace_count
+*/
+uint32_t
+trace_get_count(void)
+{
+   return(trace_count);
+}
+
+
+/*!
+* @brief Get the number of old records lost to wrapping since the last start
+* @param[in] NONE
+* @return trace_overwritten
+*/
+uint32_t
+trace_get_overwritten(void)
+{
+   return(trace_overwritten);
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Sends a 32 bit value, least significant byte first
+* @param[in] tmp_value Value to send
+* @return NONE
+*/
+void
+trace_send_u32(uint32_t tmp_value)
+{
+   for(uint8_t i = 0; i < 4U; i++)
+   {
+      uart1_send_byte((char)(tmp_value >> (8U * i)));
+   }
+}
+
+
+/*!
+* @brief Sends a 16 bit value, least significant byte first
+* @param[in] tmp_value Value to send
+* @return NONE
+*/
+void
+trace_send_u16(uint16_t tmp_value)
+{
+   uart1_send_byte((char)tmp_value);
+   uart1_send_byte((char)(tmp_value >> 8U));
+}
+
+
+/* end of file */
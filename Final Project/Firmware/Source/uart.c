@@ -28,6 +28,22 @@
 */
 
 #include "uart.h"
+#include "scheduler.h"
+#include "trace.h"
+#include "input_replay.h"
+#include "system_clock.h"
+#include "watchdog.h"
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+
+//Filled by USART1_IRQHandler, emptied by uart1_receive_byte
+static volatile char uart1_rx_buffer[UART1_RX_BUFFER_SIZE];
+static volatile uint8_t uart1_rx_head = 0;
+static volatile uint8_t uart1_rx_tail = 0;
 
 /*
 ****************************************************
@@ -37,6 +53,7 @@
 
 void uart1_gpio_init(void);
 void uart_set_baud_rate(uint32_t temp_baud_rate);
+void uart1_rx_store(char tmp_char);
 
 
 /*
@@ -77,6 +94,10 @@ void uart1_init(uint32_t baud_rate)
    USART1->CR2 &= ~(USART_CR2_LINEN_Msk | USART_CR2_CLKEN_Msk);
    USART1->CR3 &= ~(USART_CR3_SCEN_Msk | USART_CR3_IREN_Msk | USART_CR3_HDSEL_Msk);
 
+   //Interrupt on every received byte so the console doesn't have to poll
+   USART1->CR1 |= USART_CR1_RXNEIE;
+   NVIC_EnableIRQ(USART1_IRQn);
+
    //Enable USART1
    USART1->CR1 |= USART_CR1_UE;
 }
@@ -90,6 +111,9 @@ void uart1_init(uint32_t baud_rate)
 void
 uart1_printf(char print_statement[])
 {
+   //Blocks for up to a timeout per character, which a long string at a slow baud rate can stretch past the watchdog window
+   watchdog_busy(((strlen(print_statement) * UART1_TX_TIMEOUT_US) / 1000UL) + 1UL);
+
    //Send message one char at a time
    for(uint8_t current_char = 0; current_char < strlen(print_statement); current_char++)
    {
@@ -116,15 +140,22 @@ uart1_printf(char print_statement[])
 * @brief Sends a single byte over uart
 * @param[in] tmp_byte byte to send
 * @return NONE
+* @note Gives up after UART1_TX_TIMEOUT_US so a stuck transmitter can't hang the caller
 */
 void
 uart1_send_byte(char tmp_byte)
 {
+  uint32_t tmp_start = system_clock_get_cycles();
+
   USART1->DR = tmp_byte;
 
   //Wait for transfer complete
   while(0 == ((USART1->SR) & USART_SR_TC))
   {
+     if(system_clock_elapsed(tmp_start, system_clock_get_cycles()) > (UART1_TX_TIMEOUT_US * SYSTEM_CLOCK_CYCLES_PER_US))
+     {
+        break;
+     }
   }
 }
 
@@ -207,16 +238,16 @@ uart1_gpio_init(void)
 
 
 /*!
-* @brief Check if USART1 receive data register is full
+* @brief Check if USART1 has received bytes that haven't been read yet
 * @param[in] NONE
-* @return NONE
+* @return tmp_readable_flag 1 if at least one byte is waiting
 */
 uint8_t
 uart1_is_readable(void)
 {
 	uint8_t tmp_readable_flag = 0;
 
-	if (USART1->SR & USART_SR_RXNE)
+	if (uart1_rx_head != uart1_rx_tail)
 	{
 		tmp_readable_flag = 1;
 	}
@@ -226,19 +257,86 @@ uart1_is_readable(void)
 
 
 /*!
-* @brief Read byte from USART1
+* @brief Read the oldest received byte from USART1
 * @param[in] NONE
-* @return NONE
+* @return tmp_char Received byte, 0 if nothing was waiting
 */
 char
 uart1_receive_byte(void)
 {
-	char tmp_char = USART1->DR; //Read byte from shadow register
+	char tmp_char = 0;
 
-	USART1->SR &= ~USART_SR_RXNE; //Clear register not empty flag
+	if (uart1_rx_head != uart1_rx_tail)
+	{
+		tmp_char = uart1_rx_buffer[uart1_rx_tail];
+		uart1_rx_tail = (uart1_rx_tail + 1U) & (UART1_RX_BUFFER_SIZE - 1U);
+	}
 
 	return(tmp_char);
 }
 
 
+/*!
+* @brief Queue a replayed byte as if USART1 had received it
+* @param[in] tmp_char Byte to queue
+* @return NONE
+* @note Called from task context, interrupts are masked so the ISR can't write the ring at the same time
+*/
+void
+uart1_inject_byte(char tmp_char)
+{
+	uint32_t tmp_primask = __get_PRIMASK();
+
+	__disable_irq();
+	uart1_rx_store(tmp_char);
+	__set_PRIMASK(tmp_primask);
+}
+
+
+/*!
+* @brief USART1 interrupt handler. Queues the received byte and wakes the console task
+* @param[in] NONE
+* @return NONE
+* @note Reading SR then DR clears both RXNE and an overrun. Bytes pass through the
+*       input recorder first.
+*/
+void
+USART1_IRQHandler(void)
+{
+	TRACE(trace_id_isr_enter, trace_isr_usart1, 0);
+
+	if (USART1->SR & USART_SR_RXNE)
+	{
+		char tmp_char = USART1->DR;
+
+		if (input_replay_capture(input_replay_source_uart, (uint8_t)tmp_char, 0))
+		{
+			uart1_rx_store(tmp_char);
+			scheduler_signal(scheduler_task_console);
+		}
+	}
+
+	TRACE(trace_id_isr_exit, trace_isr_usart1, 0);
+}
+
+
+/*!
+* @brief Adds a byte to the receive ring
+* @param[in] tmp_char Received byte
+* @return NONE
+* @note If the buffer is full the byte is dropped, same as a hardware overrun.
+*/
+void
+uart1_rx_store(char tmp_char)
+{
+	uint8_t tmp_next = (uart1_rx_head + 1U) & (UART1_RX_BUFFER_SIZE - 1U);
+
+	if (tmp_next != uart1_rx_tail)
+	{
+		uart1_rx_buffer[uart1_rx_head] = tmp_char;
+		uart1_rx_head = tmp_next;
+	}
+}
+
+
 /* end of file */
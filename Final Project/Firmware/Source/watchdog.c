@@ -0,0 +1,353 @@
+/** @file watchdog.c
+*
+* @brief  This file contains the independent watchdog driver. Every client checks in
+*         regularly and the dog is only fed while all of them are alive.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "watchdog.h"
+#include "uart.h"
+#include "system_clock.h"
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+e_watchdog_reset watchdog_read_reset_cause(void);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static volatile uint8_t watchdog_alive[max_watchdog_client]; //One byte each so check-ins from different threads never race
+static uint32_t watchdog_elapsed_ms = 0;
+static volatile uint8_t watchdog_started = 0;
+static volatile uint32_t watchdog_busy_until_ms = 0;
+static volatile uint8_t watchdog_busy_active = 0;
+static e_watchdog_reset watchdog_reset_cause = watchdog_reset_unknown;
+static uint32_t watchdog_boot_stalled = 0; //Clients that had stopped checking in before the last reset
+
+//Survives a reset because startup code doesn't touch it. The .noinit section comes from Linker/noinit.ld
+static uint32_t watchdog_noinit_magic __attribute__((section(".noinit")));
+static uint32_t watchdog_noinit_stalled __attribute__((section(".noinit"))); //Bit per e_watchdog_client
+
+//Clients that run in the tasks thread, and so are held up by a long blocking operation there
+static const uint8_t watchdog_client_in_tasks[max_watchdog_client] =
+{
+   [watchdog_client_states] = 1,
+   [watchdog_client_timers] = 1,
+   [watchdog_client_console] = 1,
+   [watchdog_client_magnet] = 0,
+};
+
+static const char * const watchdog_client_names[max_watchdog_client] =
+{
+   [watchdog_client_states] = "states",
+   [watchdog_client_timers] = "timers",
+   [watchdog_client_console] = "console",
+   [watchdog_client_magnet] = "magnet",
+};
+
+static const char * const watchdog_reset_names[max_watchdog_reset] =
+{
+   [watchdog_reset_unknown] = "unknown",
+   [watchdog_reset_power_on] = "power on",
+   [watchdog_reset_brown_out] = "brown out",
+   [watchdog_reset_pin] = "reset pin",
+   [watchdog_reset_software] = "software",
+   [watchdog_reset_iwdg] = "watchdog",
+   [watchdog_reset_wwdg] = "window watchdog",
+   [watchdog_reset_low_power] = "low power",
+};
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Latches the reset cause and any stall record left by the last run, then starts the IWDG
+* @param[in] NONE
+* @return NONE
+* @note Once started the IWDG can't be stopped until the next reset. It is frozen while a
+*       debugger has the core halted.
+*/
+void
+watchdog_init(void)
+{
+   watchdog_reset_cause = watchdog_read_reset_cause();
+
+   if((watchdog_reset_iwdg == watchdog_reset_cause) && (WATCHDOG_NOINIT_MAGIC == watchdog_noinit_magic))
+   {
+      watchdog_boot_stalled = watchdog_noinit_stalled;
+   }
+
+   watchdog_noinit_magic = WATCHDOG_NOINIT_MAGIC;
+   watchdog_noinit_stalled = 0;
+
+   for(uint8_t i = 0; i < max_watchdog_client; i++)
+   {
+      watchdog_alive[i] = 0;
+   }
+
+   watchdog_elapsed_ms = 0;
+
+   DBGMCU->APB1FZ |= DBGMCU_APB1_FZ_DBG_IWDG_STOP;
+
+   IWDG->KR = WATCHDOG_KEY_ENABLE;
+   IWDG->KR = WATCHDOG_KEY_ACCESS;
+   IWDG->PR = WATCHDOG_PRESCALER;
+   IWDG->RLR = WATCHDOG_RELOAD;
+
+   //The new values only take effect once the LSI domain has taken them
+   while(IWDG->SR & (IWDG_SR_PVU | IWDG_SR_RVU))
+   {
+   }
+
+   IWDG->KR = WATCHDOG_KEY_RELOAD;
+   watchdog_started = 1;
+}
+
+
+/*!
+* @brief Marks a client as alive for the current check window
+* @param[in] tmp_client Client checking in
+* @return NONE
+*/
+void
+watchdog_check_in(e_watchdog_client tmp_client)
+{
+   if(max_watchdog_client > tmp_client)
+   {
+      watchdog_alive[tmp_client] = 1;
+   }
+}
+
+
+/*!
+* @brief Excuses the tasks thread clients for a while, for blocking work that is known to be
+*        slow but bounded, like sending a long string at 9600 baud
+* @param[in] tmp_ms How long the caller expects to block, capped at WATCHDOG_BUSY_MAX_MS
+* @return NONE
+* @note The magnet thread still has to check in, and the dog still bites once the time is up
+*/
+void
+watchdog_busy(uint32_t tmp_ms)
+{
+   uint32_t tmp_until = 0;
+   uint32_t tmp_primask = 0;
+
+   if(WATCHDOG_BUSY_MAX_MS < tmp_ms)
+   {
+      tmp_ms = WATCHDOG_BUSY_MAX_MS;
+   }
+
+   tmp_until = system_clock_get_ms() + tmp_ms;
+
+   tmp_primask = __get_PRIMASK();
+   __disable_irq();
+
+   if(!watchdog_busy_active || system_clock_is_before(watchdog_busy_until_ms, tmp_until))
+   {
+      watchdog_busy_until_ms = tmp_until;
+      watchdog_busy_active = 1;
+   }
+
+   __set_PRIMASK(tmp_primask);
+}
+
+
+/*!
+* @brief Called every SysTick. At the end of each check window the dog is fed if every
+*        client checked in, otherwise the missing clients are recorded and the dog is left to bite
+* @param[in] NONE
+* @return NONE
+* @note Runs in SysTick so a stalled thread can't also stop the stall from being recorded
+*/
+void
+watchdog_tick(void)
+{
+   uint32_t tmp_stalled = 0;
+
+   //SysTick runs before watchdog_init, which still has to read the last stall record
+   if(!watchdog_started)
+   {
+      return;
+   }
+
+   watchdog_elapsed_ms++;
+
+   if(WATCHDOG_CHECK_MS > watchdog_elapsed_ms)
+   {
+      return;
+   }
+
+   watchdog_elapsed_ms = 0;
+
+   if(watchdog_busy_active && system_clock_has_reached(system_clock_get_ms(), watchdog_busy_until_ms))
+   {
+      watchdog_busy_active = 0;
+   }
+
+   for(uint8_t i = 0; i < max_watchdog_client; i++)
+   {
+      if(!watchdog_alive[i] && !(watchdog_busy_active && watchdog_client_in_tasks[i]))
+      {
+         tmp_stalled |= (1UL << i);
+      }
+   }
+
+   if(tmp_stalled)
+   {
+      watchdog_noinit_stalled = tmp_stalled;
+      return;
+   }
+
+   for(uint8_t i = 0; i < max_watchdog_client; i++)
+   {
+      watchdog_alive[i] = 0;
+   }
+
+   watchdog_noinit_stalled = 0;
+   IWDG->KR = WATCHDOG_KEY_RELOAD;
+}
+
+
+/*!
+* @brief Get the cause of the last reset
+* @param[in] NONE
+* @return watchdog_reset_cause
+*/
+e_watchdog_reset
+watchdog_get_reset_cause(void)
+{
+   return(watchdog_reset_cause);
+}
+
+
+/*!
+* @brief Get the clients that had stopped checking in before a watchdog reset
+* @param[in] NONE
+* @return Bit per e_watchdog_client, 0 if the last reset wasn't the watchdog
+*/
+uint32_t
+watchdog_get_stalled(void)
+{
+   return(watchdog_boot_stalled);
+}
+
+
+/*!
+* @brief Prints the reset cause, and the stalled clients after a watchdog reset
+* @param[in] NONE
+* @return NONE
+*/
+void
+watchdog_print_report(void)
+{
+   uart1_printf("\r\n Reset: ");
+   uart1_printf((char *)watchdog_reset_names[watchdog_reset_cause]);
+
+   if(watchdog_boot_stalled)
+   {
+      uart1_printf(", stalled:");
+
+      for(uint8_t i = 0; i < max_watchdog_client; i++)
+      {
+         if(watchdog_boot_stalled & (1UL << i))
+         {
+            uart1_printf(" ");
+            uart1_printf((char *)watchdog_client_names[i]);
+         }
+      }
+   }
+
+   uart1_printf("\r\n");
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Reads and clears the reset flags in RCC_CSR
+* @param[in] NONE
+* @return Most specific cause. A power on also sets the pin and brown out flags, so it is checked first
+*/
+e_watchdog_reset
+watchdog_read_reset_cause(void)
+{
+   uint32_t tmp_csr = RCC->CSR;
+   e_watchdog_reset tmp_cause = watchdog_reset_unknown;
+
+   if(tmp_csr & RCC_CSR_LPWRRSTF)
+   {
+      tmp_cause = watchdog_reset_low_power;
+   }
+
+   else if(tmp_csr & RCC_CSR_WWDGRSTF)
+   {
+      tmp_cause = watchdog_reset_wwdg;
+   }
+
+   else if(tmp_csr & RCC_CSR_IWDGRSTF)
+   {
+      tmp_cause = watchdog_reset_iwdg;
+   }
+
+   else if(tmp_csr & RCC_CSR_SFTRSTF)
+   {
+      tmp_cause = watchdog_reset_software;
+   }
+
+   else if(tmp_csr & RCC_CSR_PORRSTF)
+   {
+      tmp_cause = watchdog_reset_power_on;
+   }
+
+   else if(tmp_csr & RCC_CSR_BORRSTF)
+   {
+      tmp_cause = watchdog_reset_brown_out;
+   }
+
+   else if(tmp_csr & RCC_CSR_PINRSTF)
+   {
+      tmp_cause = watchdog_reset_pin;
+   }
+
+   RCC->CSR |= RCC_CSR_RMVF;
+
+   return(tmp_cause);
+}
+
+
+/* end of file */
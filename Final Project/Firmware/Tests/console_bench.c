@@ -0,0 +1,121 @@
+/** @file console_bench.c
+*
+* @brief  Console throughput benchmark. Replays a file of command lines through ConsoleProcess
+*         and reports lines per second, so parser and dispatch changes can be measured on a dev box.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <time.h>
+#include "console.h"
+
+#define CONSOLE_BENCH_PASSES 2000UL //Default times the command file is replayed
+
+extern bool mReceiveBufferNeedsChecking; //console.c, set while a read left a second line queued
+
+/*!
+* @brief Replays the command file, output goes to /dev/null
+* @param[in] argc 2 or 3
+* @param[in] argv Command file, then optionally the number of passes
+* @return 0, or 1 on a usage or file error
+*/
+int
+main(int argc, char ** argv)
+{
+   struct stat tmp_stat;
+   struct timespec tmp_start;
+   struct timespec tmp_end;
+   unsigned long tmp_passes = CONSOLE_BENCH_PASSES;
+   unsigned long tmp_lines = 0;
+   unsigned long i = 0;
+   double tmp_seconds = 0;
+   FILE * p_file = NULL;
+   int tmp_char = 0;
+   int tmp_fd = -1;
+
+   if((2 > argc) || (3 < argc))
+   {
+      fprintf(stderr, "usage: %s <command file> [passes]\n", argv[0]);
+      return(1);
+   }
+
+   if(3 == argc)
+   {
+      tmp_passes = strtoul(argv[2], NULL, 10);
+   }
+
+   //One command per LF, a CRLF file counts each line once
+   p_file = fopen(argv[1], "rb");
+   tmp_fd = open(argv[1], O_RDONLY);
+
+   if((NULL == p_file) || (0 > tmp_fd) || (0 != fstat(tmp_fd, &tmp_stat)))
+   {
+      perror(argv[1]);
+      return(1);
+   }
+
+   while(EOF != (tmp_char = fgetc(p_file)))
+   {
+      tmp_lines += ('\n' == tmp_char) ? 1UL : 0UL;
+   }
+
+   fclose(p_file);
+
+   //The host backend reads stdin and writes stdout, so point those at the file and at nothing
+   if((0 > dup2(tmp_fd, STDIN_FILENO)) || (NULL == freopen("/dev/null", "w", stdout)))
+   {
+      perror("redirect");
+      return(1);
+   }
+
+   ConsoleInit();
+   clock_gettime(CLOCK_MONOTONIC, &tmp_start);
+
+   for(i = 0; i < tmp_passes; i++)
+   {
+      lseek(STDIN_FILENO, 0, SEEK_SET);
+
+      //Each call handles at most one line, keep going until the file is read and nothing is left queued
+      while((lseek(STDIN_FILENO, 0, SEEK_CUR) < tmp_stat.st_size) || mReceiveBufferNeedsChecking)
+      {
+         ConsoleProcess();
+      }
+   }
+
+   clock_gettime(CLOCK_MONOTONIC, &tmp_end);
+   tmp_seconds = (double)(tmp_end.tv_sec - tmp_start.tv_sec) + ((double)(tmp_end.tv_nsec - tmp_start.tv_nsec) / 1e9);
+   tmp_lines *= tmp_passes;
+
+   fprintf(stderr, "%lu lines in %.3f s: %.0f lines/s\n", tmp_lines, tmp_seconds,
+           (tmp_seconds > 0) ? ((double)tmp_lines / tmp_seconds) : 0.0);
+
+   return(0);
+}
+
+/* end of file */
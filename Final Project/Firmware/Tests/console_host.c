@@ -0,0 +1,51 @@
+/** @file console_host.c
+*
+* @brief  Runs the console on a Linux terminal, the host backend in consoleIoHost.c reads stdin.
+*         Quit with Ctrl-C.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include <unistd.h>
+#include "console.h"
+
+/*!
+* @brief Polls the console the way the console task does, once a millisecond
+* @param[in] NONE
+* @return Never returns
+*/
+int
+main(void)
+{
+   ConsoleInit();
+
+   while(1)
+   {
+      ConsoleProcess();
+      usleep(1000);
+   }
+
+   return(0);
+}
+
+/* end of file */
@@ -0,0 +1,194 @@
+/** @file fuzz_console.c
+*
+* @brief  Fuzz harness for the console parser. Each input is a byte stream typed at the console,
+*         its first byte picks how many bytes each read hands over.
+*         Built with clang -fsanitize=fuzzer,address,undefined this is a libFuzzer target. Built with
+*         FUZZ_STANDALONE it replays files instead (the corpus, or a crash) and can mutate them
+*         itself, for compilers without libFuzzer.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "console.h"
+#include "consoleIoMemory.h"
+
+#define FUZZ_CONSOLE_MAX_INPUT 4096U  //Longest input the standalone driver reads or builds
+
+int LLVMFuzzerTestOneInput(const uint8_t * p_data, size_t tmp_size);
+
+
+/*!
+* @brief Types one input at a fresh console
+* @param[in] p_data Chunk size byte, then the bytes typed
+* @param[in] tmp_size Length of p_data
+* @return 0
+*/
+int
+LLVMFuzzerTestOneInput(const uint8_t * p_data, size_t tmp_size)
+{
+   size_t tmp_chunk = 0;
+
+   if(0 == tmp_size)
+   {
+      return(0);
+   }
+
+   //1 to 256 bytes per read, 256 fills the whole receive buffer in one go
+   tmp_chunk = (size_t)p_data[0] + 1U;
+
+   ConsoleInit();
+   ConsoleIoMemoryClearOutput();
+   ConsoleIoMemoryFeed(&p_data[1], tmp_size - 1U, tmp_chunk);
+   ConsoleIoMemoryRun();
+
+   return(0);
+}
+
+
+#ifdef FUZZ_STANDALONE
+/*!
+* @brief Reads one file into a buffer
+* @param[in] p_path File to read
+* @param[out] p_data Buffer of FUZZ_CONSOLE_MAX_INPUT bytes, longer files are cut
+* @return Bytes read
+*/
+static size_t
+fuzz_console_read(const char * p_path, uint8_t * p_data)
+{
+   FILE * p_file = fopen(p_path, "rb");
+   size_t tmp_size = 0;
+
+   if(NULL == p_file)
+   {
+      perror(p_path);
+      exit(1);
+   }
+
+   tmp_size = fread(p_data, 1, FUZZ_CONSOLE_MAX_INPUT, p_file);
+   fclose(p_file);
+
+   return(tmp_size);
+}
+
+
+/*!
+* @brief Runs every file given, then as many mutations of them as asked for
+* @param[in] argc At least 2
+* @param[in] argv [-n mutations] file...
+* @return 0 if nothing tripped a sanitizer, they abort otherwise
+* @note The mutations are seeded with a constant, so a failing run repeats
+*/
+int
+main(int argc, char ** argv)
+{
+   static uint8_t tmp_seeds[64][FUZZ_CONSOLE_MAX_INPUT];
+   static size_t tmp_sizes[64];
+   static uint8_t tmp_input[FUZZ_CONSOLE_MAX_INPUT];
+   unsigned long tmp_mutations = 0;
+   unsigned long i = 0;
+   size_t tmp_seed_count = 0;
+   size_t tmp_size = 0;
+   size_t tmp_edits = 0;
+   size_t tmp_at = 0;
+   int tmp_arg = 1;
+
+   if((3 < argc) && (0 == strcmp(argv[1], "-n")))
+   {
+      tmp_mutations = strtoul(argv[2], NULL, 10);
+      tmp_arg = 3;
+   }
+
+   for(; tmp_arg < argc; tmp_arg++)
+   {
+      tmp_size = fuzz_console_read(argv[tmp_arg], tmp_input);
+      LLVMFuzzerTestOneInput(tmp_input, tmp_size);
+
+      if(64 > tmp_seed_count)
+      {
+         memcpy(tmp_seeds[tmp_seed_count], tmp_input, tmp_size);
+         tmp_sizes[tmp_seed_count] = tmp_size;
+         tmp_seed_count++;
+      }
+   }
+
+   srand(1);
+
+   for(i = 0; (i < tmp_mutations) && (0 < tmp_seed_count); i++)
+   {
+      //Splice a random seed onto another, then overwrite, insert or drop a few bytes
+      tmp_at = (size_t)rand() % tmp_seed_count;
+      tmp_size = tmp_sizes[tmp_at];
+      memcpy(tmp_input, tmp_seeds[tmp_at], tmp_size);
+
+      if(0 == (rand() % 4))
+      {
+         tmp_at = (size_t)rand() % tmp_seed_count;
+
+         if(FUZZ_CONSOLE_MAX_INPUT >= (tmp_size + tmp_sizes[tmp_at]))
+         {
+            memcpy(&tmp_input[tmp_size], tmp_seeds[tmp_at], tmp_sizes[tmp_at]);
+            tmp_size += tmp_sizes[tmp_at];
+         }
+      }
+
+      for(tmp_edits = 1U + ((size_t)rand() % 8U); (0 < tmp_edits) && (0 < tmp_size); tmp_edits--)
+      {
+         tmp_at = (size_t)rand() % tmp_size;
+
+         switch(rand() % 3)
+         {
+            case 0:
+               tmp_input[tmp_at] = (uint8_t)rand();
+               break;
+
+            case 1:
+               if(FUZZ_CONSOLE_MAX_INPUT > tmp_size)
+               {
+                  memmove(&tmp_input[tmp_at + 1U], &tmp_input[tmp_at], tmp_size - tmp_at);
+                  tmp_input[tmp_at] = (uint8_t)" \r\n0123456789-abcdefABCDEFx"[rand() % 27];
+                  tmp_size++;
+               }
+               break;
+
+            default:
+               memmove(&tmp_input[tmp_at], &tmp_input[tmp_at + 1U], tmp_size - tmp_at - 1U);
+               tmp_size--;
+               break;
+         }
+      }
+
+      LLVMFuzzerTestOneInput(tmp_input, tmp_size);
+   }
+
+   printf("%d inputs, %lu mutations\n", argc - ((0 < tmp_mutations) ? 3 : 1), tmp_mutations);
+
+   return(0);
+}
+#endif /* FUZZ_STANDALONE */
+
+/* end of file */
@@ -0,0 +1,105 @@
+// Console IO backend that reads from and writes to memory, for the host tests and the fuzz harness.
+// Input is handed over in chunks of a chosen size so partial lines and several lines per
+// read both get exercised, the way bytes trickle in from the UART.
+
+#include <string.h>
+#include <stdbool.h>
+#include "consoleIo.h"
+#include "consoleIoMemory.h"
+#include "console.h"
+
+extern bool mReceiveBufferNeedsChecking; // console.c
+
+static const uint8_t *mInput;
+static size_t mInputLength;
+static size_t mInputRead;
+static size_t mChunk;
+static char mOutput[CONSOLE_IO_MEMORY_OUTPUT_LENGTH];
+static size_t mOutputLength;
+
+eConsoleError ConsoleIoInit(void)
+{
+	return CONSOLE_SUCCESS;
+}
+
+eConsoleError ConsoleIoReceive(uint8_t *buffer, const uint32_t bufferLength, uint32_t *readLength)
+{
+	size_t length = mInputLength - mInputRead;
+
+	if ( length > mChunk )
+	{
+		length = mChunk;
+	}
+	if ( length > bufferLength )
+	{
+		length = bufferLength;
+	}
+	memcpy(buffer, &mInput[mInputRead], length);
+	mInputRead += length;
+
+	*readLength = (uint32_t) length;
+	return CONSOLE_SUCCESS;
+}
+
+// strlen walks the whole string, so a missing terminator shows up under the address sanitizer
+eConsoleError ConsoleIoSendString(const char *buffer)
+{
+	size_t length = strlen(buffer);
+	size_t kept = sizeof(mOutput) - 1u - mOutputLength;
+
+	if ( length < kept )
+	{
+		kept = length;
+	}
+	memcpy(&mOutput[mOutputLength], buffer, kept);
+	mOutputLength += kept;
+	mOutput[mOutputLength] = '\0';
+	return CONSOLE_SUCCESS;
+}
+
+// ConsoleIoMemoryFeed
+// Queue input for ConsoleProcess, handed over at most chunk bytes per read. The data must
+// stay valid until ConsoleIoMemoryRun has consumed it.
+void ConsoleIoMemoryFeed(const uint8_t *data, size_t length, size_t chunk)
+{
+	mInput = data;
+	mInputLength = length;
+	mInputRead = 0u;
+	mChunk = ( chunk > 0u ) ? chunk : 1u;
+}
+
+// ConsoleIoMemoryRun
+// Call ConsoleProcess until the input is used up and no complete line is left in the buffer.
+// Returns the number of calls made, or -1 if the console stopped taking input with some left.
+int ConsoleIoMemoryRun(void)
+{
+	int calls = 0;
+	int stalls = 0;
+	size_t readBefore;
+
+	while ( ( mInputRead < mInputLength ) || mReceiveBufferNeedsChecking )
+	{
+		readBefore = mInputRead;
+		ConsoleProcess();
+		calls++;
+
+		// a full buffer can skip one read while it hands out a line, never two in a row
+		stalls = ( ( readBefore == mInputRead ) && ( mInputRead < mInputLength ) ) ? ( stalls + 1 ) : 0;
+		if ( stalls > 1 )
+		{
+			return -1;
+		}
+	}
+	return calls;
+}
+
+const char* ConsoleIoMemoryOutput(void)
+{
+	return mOutput;
+}
+
+void ConsoleIoMemoryClearOutput(void)
+{
+	mOutputLength = 0u;
+	mOutput[0] = '\0';
+}
@@ -0,0 +1,17 @@
+// Console IO backend that reads from and writes to memory, for the host tests and the fuzz harness.
+// Link it in place of consoleIo.c or consoleIoHost.c.
+
+#ifndef CONSOLE_IO_MEMORY_H
+#define CONSOLE_IO_MEMORY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define CONSOLE_IO_MEMORY_OUTPUT_LENGTH 8192 // output past this is counted but not kept
+
+void ConsoleIoMemoryFeed(const uint8_t *data, size_t length, size_t chunk);
+int ConsoleIoMemoryRun(void);
+const char* ConsoleIoMemoryOutput(void);
+void ConsoleIoMemoryClearOutput(void);
+
+#endif // CONSOLE_IO_MEMORY_H
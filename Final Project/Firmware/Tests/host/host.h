@@ -0,0 +1,53 @@
+/** @file host.h
+*
+* @brief  Host side of the Linux test builds: the simulated clock that stands in for system_clock.c,
+*         and what the stubbed outputs were last set to.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef HOST_H
+#define HOST_H
+
+#define HOST_UART_OUTPUT_LENGTH 16384U //uart1_printf output past this is dropped
+
+#include <stdint.h>
+
+/*
+****************************************************
+****** Public Functions Defined in host_stubs.c *****
+****************************************************
+*/
+void host_clock_set_us(uint32_t tmp_now_us);
+void host_clock_advance_us(uint32_t tmp_delta_us);
+uint16_t host_magnet_get(void);
+uint8_t host_led_get_level(void);
+const char * host_uart_get_output(void);
+void host_uart_clear_output(void);
+uint32_t host_uart_get_length(void);
+void host_uart_receive(char tmp_char);
+
+
+#endif /* HOST_H */
+
+/* end of file */
@@ -0,0 +1,429 @@
+/** @file host_stubs.c
+*
+* @brief  Stand-ins for the modules a host build leaves out, plus the host register file and clock.
+*         Every stub is weak, so a test that builds the real module gets the real one.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "host.h"
+#include "host_test.h"
+#include "main.h"
+
+#define HOST_STUB __attribute__((weak))
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static uint32_t host_clock_us = 0;  //Only moves when a test moves it, so runs are repeatable
+static const char * const host_led_anim_names[max_led_anim] = {"off", "breathe", "fadein", "fadeout", "blink"};
+static s_led_anim_params host_led_anim_params = {1000, 100, 22};
+static e_led_anim host_led_anim = led_anim_none;
+static e_led_anim host_led_pod_anims[PWM_PODS];
+static s_debounce host_button_debounce[max_button];
+static e_input_replay_mode host_input_replay_mode = input_replay_mode_off;
+static uint8_t host_capture_running = 0;
+static uint16_t host_magnet = MAGNET_MAG_OFF;
+static uint8_t host_led_level = LED_LEVEL_OFF;
+static char host_uart_output[HOST_UART_OUTPUT_LENGTH];
+static uint32_t host_uart_length = 0;
+static char host_uart_rx[UART1_RX_BUFFER_SIZE];  //Same ring as uart.c, filled by host_uart_receive
+static uint8_t host_uart_rx_head = 0;
+static uint8_t host_uart_rx_tail = 0;
+
+
+/*
+****************************************************
+**************** Host Register File ****************
+****************************************************
+*/
+GPIO_TypeDef host_gpioa;
+GPIO_TypeDef host_gpiob;
+GPIO_TypeDef host_gpioc;
+RCC_TypeDef host_rcc;
+TIM_TypeDef host_tim1;
+TIM_TypeDef host_tim5;
+TIM_TypeDef host_tim6;
+TIM_TypeDef host_tim9;
+TIM_TypeDef host_tim11;
+USART_TypeDef host_usart1;
+DMA_TypeDef host_dma1;
+DMA_Stream_TypeDef host_dma1_stream2;
+DMA_Stream_TypeDef host_dma1_stream4;
+EXTI_TypeDef host_exti;
+SYSCFG_TypeDef host_syscfg;
+DWT_Type host_dwt;
+CoreDebug_Type host_core_debug;
+SCB_Type host_scb;
+
+unsigned host_test_failures = 0;  //Counted by the host_test.h checks
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Moves the simulated clock to a time
+* @param[in] tmp_now_us New value of system_clock_get_us()
+* @return NONE
+*/
+void
+host_clock_set_us(uint32_t tmp_now_us)
+{
+   host_clock_us = tmp_now_us;
+}
+
+
+/*!
+* @brief Moves the simulated clock forward
+* @param[in] tmp_delta_us Microseconds to add
+* @return NONE
+*/
+void
+host_clock_advance_us(uint32_t tmp_delta_us)
+{
+   host_clock_us += tmp_delta_us;
+}
+
+
+/*!
+* @brief Get what the magnet was last set to
+* @param[in] NONE
+* @return Magnitude last passed to magnet_set_mag
+*/
+uint16_t
+host_magnet_get(void)
+{
+   return(host_magnet);
+}
+
+
+/*!
+* @brief Get what the LED was last set to
+* @param[in] NONE
+* @return Level last passed to led_set_level
+*/
+uint8_t
+host_led_get_level(void)
+{
+   return(host_led_level);
+}
+
+
+/*!
+* @brief Get everything printed with uart1_printf since the last clear
+* @param[in] NONE
+* @return Null terminated text
+*/
+const char *
+host_uart_get_output(void)
+{
+   return(host_uart_output);
+}
+
+
+/*!
+* @brief Forgets what was printed with uart1_printf
+* @param[in] NONE
+* @return NONE
+*/
+void
+host_uart_clear_output(void)
+{
+   host_uart_length = 0;
+   host_uart_output[0] = '\0';
+}
+
+
+/*!
+* @brief Get how much has been printed since the last clear
+* @param[in] NONE
+* @return Length of host_uart_get_output()
+*/
+uint32_t
+host_uart_get_length(void)
+{
+   return(host_uart_length);
+}
+
+
+/*!
+* @brief Receives a byte on the simulated USART1, the way USART1_IRQHandler does
+* @param[in] tmp_char Byte typed on the console
+* @return NONE
+*/
+void
+host_uart_receive(char tmp_char)
+{
+   if(input_replay_capture(input_replay_source_uart, (uint8_t)tmp_char, 0))
+   {
+      uart1_inject_byte(tmp_char);
+      scheduler_signal(scheduler_task_console);
+   }
+}
+
+
+/*
+****************************************************
+************** system_clock.c Stubs ****************
+****************************************************
+*/
+HOST_STUB uint32_t system_clock_get_us(void) { return(host_clock_us); }
+HOST_STUB uint32_t system_clock_get_ms(void) { return(host_clock_us / 1000UL); }
+HOST_STUB uint32_t input_replay_get_time_us(void) { return(system_clock_get_us()); }
+
+
+/*
+****************************************************
+*********** base_gpio_drivers.c Stubs **************
+****************************************************
+*/
+HOST_STUB void gpio_clear(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number) { p_gpio_tmp->ODR &= ~(1UL << pin_number); }
+HOST_STUB void gpio_set(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number) { p_gpio_tmp->ODR |= (1UL << pin_number); }
+HOST_STUB uint8_t gpio_read_pin(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number) { return((p_gpio_tmp->IDR >> pin_number) & 1UL); }
+HOST_STUB void gpio_gen_input_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number) {}
+HOST_STUB void gpio_clk_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number) {}
+HOST_STUB void gpio_func_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number, uint8_t pin_func) {}
+HOST_STUB void gpio_pupd_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number, uint8_t pin_pupd) {}
+HOST_STUB void gpio_af_init(GPIO_TypeDef * p_gpio_tmp, uint8_t pin_number, uint8_t pin_af) {}
+
+
+/*
+****************************************************
+****************** delay.c Stubs *******************
+****************************************************
+*/
+HOST_STUB uint8_t delay_call_in_us(uint32_t tmp_us, delay_callback p_callback, void * p_context) { return(1); }
+HOST_STUB void delay_cancel(delay_callback p_callback, void * p_context) {}
+
+
+/*
+****************************************************
+****************** led.c Stubs *********************
+****************************************************
+*/
+HOST_STUB void led_set_level(uint8_t tmp_level) { host_led_level = tmp_level; }
+HOST_STUB void led_set_mag(uint16_t tmp_mag) {}
+HOST_STUB e_led_anim led_anim_get(void) { return(host_led_anim); }
+HOST_STUB const char * led_anim_get_name(e_led_anim tmp_anim) { return(host_led_anim_names[tmp_anim]); }
+HOST_STUB const s_led_anim_params * led_anim_get_params(void) { return(&host_led_anim_params); }
+HOST_STUB e_led_anim led_pod_anim_get(uint8_t tmp_pod) { return(host_led_pod_anims[tmp_pod]); }
+HOST_STUB void led_pod_set_level(uint8_t tmp_pod, uint8_t tmp_level) { host_led_pod_anims[tmp_pod] = led_anim_none; }
+
+HOST_STUB void
+led_anim_start(e_led_anim tmp_anim, const s_led_anim_params * p_params)
+{
+   host_led_anim = tmp_anim;
+   host_led_anim_params = *p_params;
+}
+
+HOST_STUB void
+led_pod_anim_start(uint8_t tmp_pod, e_led_anim tmp_anim, const s_led_anim_params * p_params)
+{
+   host_led_pod_anims[tmp_pod] = tmp_anim;
+}
+
+
+/*
+****************************************************
+********* uart.c and electromagnet.c Stubs *********
+****************************************************
+*/
+HOST_STUB void magnet_set_mag(uint16_t tmp_magnitude) { host_magnet = tmp_magnitude; }
+
+HOST_STUB void
+uart1_printf(char print_statement[])
+{
+   while(('\0' != *print_statement) && ((HOST_UART_OUTPUT_LENGTH - 1U) > host_uart_length))
+   {
+      host_uart_output[host_uart_length++] = *print_statement++;
+   }
+
+   host_uart_output[host_uart_length] = '\0';
+}
+
+HOST_STUB void
+uart1_send_byte(char tmp_byte)
+{
+   char tmp_string[2] = {tmp_byte, '\0'};
+
+   uart1_printf(tmp_string);
+}
+
+HOST_STUB uint8_t uart1_is_readable(void) { return((host_uart_rx_head != host_uart_rx_tail) ? 1 : 0); }
+
+HOST_STUB char
+uart1_receive_byte(void)
+{
+   char tmp_char = 0;
+
+   if(uart1_is_readable())
+   {
+      tmp_char = host_uart_rx[host_uart_rx_tail];
+      host_uart_rx_tail = (host_uart_rx_tail + 1U) & (UART1_RX_BUFFER_SIZE - 1U);
+   }
+
+   return(tmp_char);
+}
+
+HOST_STUB void
+uart1_inject_byte(char tmp_char)
+{
+   uint8_t tmp_next = (host_uart_rx_head + 1U) & (UART1_RX_BUFFER_SIZE - 1U);
+
+   if(tmp_next != host_uart_rx_tail)
+   {
+      host_uart_rx[host_uart_rx_head] = tmp_char;
+      host_uart_rx_head = tmp_next;
+   }
+}
+
+
+/*
+****************************************************
+********* states.c and buttons.c Stubs *************
+****************************************************
+*/
+HOST_STUB void states_print_state(void) {}
+HOST_STUB void states_mag_tick(void) {}
+HOST_STUB uint8_t button_manual_status(void) { return(gpio_read_pin(GPIOC, 3)); }
+HOST_STUB const s_debounce * button_get_debounce(e_button tmp_button) { return(&host_button_debounce[tmp_button]); }
+
+HOST_STUB void
+button_set_debounce_us(uint32_t tmp_window_us)
+{
+   uint32_t i = 0;
+
+   for(i = 0; i < max_button; i++)
+   {
+      debounce_set_window(&host_button_debounce[i], tmp_window_us);
+   }
+}
+
+HOST_STUB void
+button_reset_debounce_counts(void)
+{
+   uint32_t i = 0;
+
+   for(i = 0; i < max_button; i++)
+   {
+      debounce_reset_counts(&host_button_debounce[i]);
+   }
+}
+
+
+/*
+****************************************************
+************** input_replay.c Stubs ****************
+****************************************************
+*/
+HOST_STUB uint8_t input_replay_capture(e_input_replay_source tmp_source, uint8_t tmp_data, uint8_t tmp_payload) { return(1); }
+HOST_STUB void input_replay_record(void) { host_input_replay_mode = input_replay_mode_recording; }
+HOST_STUB void input_replay_play(uint8_t tmp_fast) { host_input_replay_mode = input_replay_mode_off; }
+HOST_STUB void input_replay_stop(void) { host_input_replay_mode = input_replay_mode_off; }
+HOST_STUB e_input_replay_mode input_replay_get_mode(void) { return(host_input_replay_mode); }
+HOST_STUB uint32_t input_replay_get_count(void) { return(0); }
+HOST_STUB uint32_t input_replay_get_position(void) { return(0); }
+
+
+/*
+****************************************************
+********** Kernel and Scheduling Stubs *************
+****************************************************
+*/
+HOST_STUB void kernel_sem_init(s_kernel_sem * p_sem, uint32_t tmp_count) { p_sem->count = tmp_count; }
+HOST_STUB void kernel_sem_give(s_kernel_sem * p_sem) { p_sem->count++; }
+HOST_STUB void kernel_sem_wait(s_kernel_sem * p_sem) { p_sem->count -= (0 < p_sem->count) ? 1U : 0U; }
+HOST_STUB void scheduler_signal(e_scheduler_task tmp_task) {}
+HOST_STUB void watchdog_check_in(e_watchdog_client tmp_client) {}
+HOST_STUB void profiler_end(e_profiler_stage tmp_stage, uint32_t tmp_start) {}
+
+HOST_STUB void
+soft_timer_start(s_soft_timer * p_timer, uint32_t tmp_delay_ms, uint32_t tmp_period_ms,
+                 soft_timer_callback p_callback, void * p_context)
+{
+   p_timer->active = 1;
+}
+
+HOST_STUB void soft_timer_stop(s_soft_timer * p_timer) { p_timer->active = 0; }
+
+
+/*
+****************************************************
+********** Statistics and Capture Stubs ************
+****************************************************
+*/
+HOST_STUB const char * scheduler_get_name(e_scheduler_task tmp_task) { return("task"); }
+HOST_STUB uint32_t scheduler_get_run_count(e_scheduler_task tmp_task) { return(0); }
+HOST_STUB uint32_t scheduler_get_wcet(e_scheduler_task tmp_task) { return(0); }
+HOST_STUB uint32_t scheduler_get_sleep_permille(void) { return(0); }
+HOST_STUB void scheduler_get_wake_latency(uint32_t * p_last, uint32_t * p_max) { *p_last = 0; *p_max = 0; }
+HOST_STUB void scheduler_reset_stats(void) {}
+
+HOST_STUB const char * io_stats_get_name(e_io_stats_periph tmp_periph) { return("periph"); }
+HOST_STUB uint32_t io_stats_get_total(e_io_stats_periph tmp_periph) { return(0); }
+HOST_STUB uint32_t io_stats_get_rate(e_io_stats_periph tmp_periph) { return(0); }
+HOST_STUB void io_stats_reset(void) {}
+
+HOST_STUB const char * profiler_get_name(e_profiler_stage tmp_stage) { return("stage"); }
+HOST_STUB uint32_t profiler_get_count(e_profiler_stage tmp_stage) { return(0); }
+HOST_STUB uint32_t profiler_get_min(e_profiler_stage tmp_stage) { return(0); }
+HOST_STUB uint32_t profiler_get_avg(e_profiler_stage tmp_stage) { return(0); }
+HOST_STUB uint32_t profiler_get_max(e_profiler_stage tmp_stage) { return(0); }
+HOST_STUB uint32_t profiler_get_bucket(e_profiler_stage tmp_stage, uint8_t tmp_bucket) { return(0); }
+HOST_STUB void profiler_reset(void) {}
+
+HOST_STUB void trace_dump(void) {}
+HOST_STUB void trace_start(void) {}
+HOST_STUB void trace_stop(void) {}
+HOST_STUB uint32_t trace_get_count(void) { return(0); }
+HOST_STUB uint32_t trace_get_overwritten(void) { return(0); }
+
+HOST_STUB const char * kernel_get_name(e_kernel_thread tmp_thread) { return("thread"); }
+HOST_STUB uint32_t kernel_get_switch_count(void) { return(0); }
+HOST_STUB void kernel_get_switch_cycles(uint32_t * p_min, uint32_t * p_max) { *p_min = 0; *p_max = 0; }
+HOST_STUB void kernel_get_wake_latency(e_kernel_thread tmp_thread, uint32_t * p_min, uint32_t * p_max) { *p_min = 0; *p_max = 0; }
+HOST_STUB uint32_t kernel_get_stack_free(e_kernel_thread tmp_thread) { return(0); }
+HOST_STUB void kernel_reset_stats(void) {}
+
+HOST_STUB void capture_start(void) { host_capture_running = 1; }
+HOST_STUB void capture_stop(void) { host_capture_running = 0; }
+HOST_STUB void capture_reset(void) {}
+HOST_STUB uint8_t capture_is_running(void) { return(host_capture_running); }
+HOST_STUB uint32_t capture_get_mhz(void) { return(0); }
+
+HOST_STUB void
+capture_get_stats(s_capture_stats * p_stats)
+{
+   s_capture_stats tmp_stats = {0};
+
+   *p_stats = tmp_stats;
+}
+
+
+/* end of file */
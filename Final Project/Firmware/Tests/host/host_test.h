@@ -0,0 +1,69 @@
+/** @file host_test.h
+*
+* @brief  Check macros shared by the host unit tests.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef HOST_TEST_H
+#define HOST_TEST_H
+
+#include <stdio.h>
+
+extern unsigned host_test_failures;
+
+//Reports a failed condition with its line and carries on, so one run lists every failure
+#define HOST_CHECK(cond) \
+   do \
+   { \
+      if(!(cond)) \
+      { \
+         printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+         host_test_failures++; \
+      } \
+   } while(0)
+
+#define HOST_CHECK_EQ(actual, expected) \
+   do \
+   { \
+      long long tmp_actual_ = (long long)(actual); \
+      long long tmp_expected_ = (long long)(expected); \
+      if(tmp_actual_ != tmp_expected_) \
+      { \
+         printf("%s:%d: %s is %lld, expected %lld\n", __FILE__, __LINE__, #actual, tmp_actual_, tmp_expected_); \
+         host_test_failures++; \
+      } \
+   } while(0)
+
+//Ends main, the exit status is what make check looks at
+#define HOST_TEST_DONE() \
+   do \
+   { \
+      printf("%s\n", (0 == host_test_failures) ? "pass" : "FAIL"); \
+      return((0 == host_test_failures) ? 0 : 1); \
+   } while(0)
+
+
+#endif /* HOST_TEST_H */
+
+/* end of file */
@@ -0,0 +1 @@
+/* The host stand-in for the device header is all in stm32f4xx.h */
@@ -0,0 +1,220 @@
+/** @file stm32f4xx.h
+*
+* @brief  Host stand-in for the CMSIS device header, used by the Linux test builds only.
+*         Peripherals are plain structs in RAM (see host_stubs.c) and the core intrinsics do nothing,
+*         so firmware modules compile unchanged and their register writes land somewhere harmless.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef STM32F4XX_H
+#define STM32F4XX_H
+
+#include <stdint.h>
+
+#define __IO volatile
+#define __ASM __asm
+#define __NVIC_PRIO_BITS 4U
+
+/*
+****************************************************
+******** Public Types and Structure Definitions *****
+****************************************************
+*/
+
+typedef enum
+{
+   PendSV_IRQn = -2,
+   SysTick_IRQn = -1,
+   EXTI0_IRQn = 6,
+   EXTI1_IRQn = 7,
+   EXTI2_IRQn = 8,
+   EXTI3_IRQn = 9,
+   EXTI4_IRQn = 10,
+   DMA1_Stream2_IRQn = 13,
+   DMA1_Stream5_IRQn = 16,
+   TIM1_BRK_TIM9_IRQn = 24,
+   TIM1_UP_TIM10_IRQn = 25,
+   TIM1_TRG_COM_TIM11_IRQn = 26,
+   USART1_IRQn = 37,
+   TIM5_IRQn = 50,
+   TIM6_DAC_IRQn = 54,
+   DMA2_Stream5_IRQn = 68
+
+} IRQn_Type;
+
+typedef struct { __IO uint32_t MODER, OTYPER, OSPEEDR, PUPDR, IDR, ODR, BSRR, LCKR, AFR[2]; } GPIO_TypeDef;
+typedef struct { __IO uint32_t CR, PLLCFGR, CFGR, CIR, AHB1RSTR, AHB2RSTR, AHB3RSTR, RESERVED0, APB1RSTR, APB2RSTR,
+                 RESERVED1[2], AHB1ENR, AHB2ENR, AHB3ENR, RESERVED2, APB1ENR, APB2ENR, RESERVED3[2], AHB1LPENR,
+                 AHB2LPENR, AHB3LPENR, RESERVED4, APB1LPENR, APB2LPENR, RESERVED5[2], BDCR, CSR; } RCC_TypeDef;
+typedef struct { __IO uint32_t CR1, CR2, SMCR, DIER, SR, EGR, CCMR1, CCMR2, CCER, CNT, PSC, ARR, RCR,
+                 CCR1, CCR2, CCR3, CCR4, BDTR, DCR, DMAR, OR; } TIM_TypeDef;
+typedef struct { __IO uint32_t SR, DR, BRR, CR1, CR2, CR3, GTPR; } USART_TypeDef;
+typedef struct { __IO uint32_t LISR, HISR, LIFCR, HIFCR; } DMA_TypeDef;
+typedef struct { __IO uint32_t CR, NDTR, PAR, M0AR, M1AR, FCR; } DMA_Stream_TypeDef;
+typedef struct { __IO uint32_t IMR, EMR, RTSR, FTSR, SWIER, PR; } EXTI_TypeDef;
+typedef struct { __IO uint32_t MEMRMP, PMC, EXTICR[4]; } SYSCFG_TypeDef;
+typedef struct { __IO uint32_t CTRL, CYCCNT; } DWT_Type;
+typedef struct { __IO uint32_t DHCSR, DCRSR, DCRDR, DEMCR; } CoreDebug_Type;
+typedef struct { __IO uint32_t CPUID, ICSR, VTOR, AIRCR, SCR, CCR; } SCB_Type;
+
+/*
+****************************************************
+*************** Host Register File *****************
+****************************************************
+*/
+extern GPIO_TypeDef host_gpioa;
+extern GPIO_TypeDef host_gpiob;
+extern GPIO_TypeDef host_gpioc;
+extern RCC_TypeDef host_rcc;
+extern TIM_TypeDef host_tim1;
+extern TIM_TypeDef host_tim5;
+extern TIM_TypeDef host_tim6;
+extern TIM_TypeDef host_tim9;
+extern TIM_TypeDef host_tim11;
+extern USART_TypeDef host_usart1;
+extern DMA_TypeDef host_dma1;
+extern DMA_Stream_TypeDef host_dma1_stream2;
+extern DMA_Stream_TypeDef host_dma1_stream4;
+extern EXTI_TypeDef host_exti;
+extern SYSCFG_TypeDef host_syscfg;
+extern DWT_Type host_dwt;
+extern CoreDebug_Type host_core_debug;
+extern SCB_Type host_scb;
+
+#define GPIOA (&host_gpioa)
+#define GPIOB (&host_gpiob)
+#define GPIOC (&host_gpioc)
+#define RCC (&host_rcc)
+#define TIM1 (&host_tim1)
+#define TIM5 (&host_tim5)
+#define TIM6 (&host_tim6)
+#define TIM9 (&host_tim9)
+#define TIM11 (&host_tim11)
+#define USART1 (&host_usart1)
+#define DMA1 (&host_dma1)
+#define DMA1_Stream2 (&host_dma1_stream2)
+#define DMA1_Stream4 (&host_dma1_stream4)
+#define EXTI (&host_exti)
+#define SYSCFG (&host_syscfg)
+#define DWT (&host_dwt)
+#define CoreDebug (&host_core_debug)
+#define SCB (&host_scb)
+
+/*Only the bits the host-built modules touch, at their real positions */
+#define RCC_AHB1ENR_DMA1EN (1UL << 21)
+#define RCC_APB1ENR_TIM5EN (1UL << 3)
+#define RCC_APB1ENR_TIM6EN (1UL << 4)
+#define RCC_APB2ENR_TIM1EN (1UL << 0)
+#define RCC_APB2ENR_SYSCFGEN (1UL << 14)
+#define RCC_APB2ENR_TIM9EN (1UL << 16)
+#define RCC_APB2ENR_TIM11EN (1UL << 18)
+#define TIM_CR1_CEN (1UL << 0)
+#define TIM_CR1_URS (1UL << 2)
+#define TIM_CR1_OPM (1UL << 3)
+#define TIM_CR1_ARPE (1UL << 7)
+#define TIM_CR2_MMS_1 (1UL << 5)
+#define TIM_DIER_UIE (1UL << 0)
+#define TIM_DIER_CC1DE (1UL << 9)
+#define TIM_DIER_CC2DE (1UL << 10)
+#define TIM_EGR_UG (1UL << 0)
+#define TIM_SR_UIF (1UL << 0)
+#define TIM_SR_CC1IF (1UL << 1)
+#define TIM_SR_CC2IF (1UL << 2)
+#define TIM_SR_CC1OF (1UL << 9)
+#define TIM_SR_CC2OF (1UL << 10)
+#define TIM_CCMR1_CC1S_0 (1UL << 0)
+#define TIM_CCMR1_IC1F_Pos 4U
+#define TIM_CCMR1_CC2S_1 (1UL << 9)
+#define TIM_CCMR1_IC2F_Pos 12U
+#define TIM_CCER_CC1E (1UL << 0)
+#define TIM_CCER_CC1P (1UL << 1)
+#define TIM_CCER_CC1NP (1UL << 3)
+#define TIM_CCER_CC2E (1UL << 4)
+#define TIM_CCER_CC2P (1UL << 5)
+#define TIM_CCER_CC2NP (1UL << 7)
+#define DMA_SxCR_EN (1UL << 0)
+#define DMA_SxCR_CIRC (1UL << 8)
+#define DMA_SxCR_MINC (1UL << 10)
+#define DMA_SxCR_PSIZE_1 (1UL << 12)
+#define DMA_SxCR_MSIZE_1 (1UL << 14)
+#define DMA_LIFCR_CFEIF2 (1UL << 16)
+#define DMA_LIFCR_CDMEIF2 (1UL << 18)
+#define DMA_LIFCR_CTEIF2 (1UL << 19)
+#define DMA_LIFCR_CHTIF2 (1UL << 20)
+#define DMA_LIFCR_CTCIF2 (1UL << 21)
+#define DMA_HIFCR_CFEIF4 (1UL << 0)
+#define DMA_HIFCR_CDMEIF4 (1UL << 2)
+#define DMA_HIFCR_CTEIF4 (1UL << 3)
+#define DMA_HIFCR_CHTIF4 (1UL << 4)
+#define DMA_HIFCR_CTCIF4 (1UL << 5)
+#define EXTI_IMR_IM0 (1UL << 0)
+#define EXTI_IMR_IM1 (1UL << 1)
+#define EXTI_IMR_IM2 (1UL << 2)
+#define EXTI_IMR_IM3 (1UL << 3)
+#define EXTI_RTSR_TR0 (1UL << 0)
+#define EXTI_RTSR_TR1 (1UL << 1)
+#define EXTI_RTSR_TR2 (1UL << 2)
+#define EXTI_RTSR_TR3 (1UL << 3)
+#define EXTI_FTSR_TR0 (1UL << 0)
+#define EXTI_FTSR_TR1 (1UL << 1)
+#define EXTI_FTSR_TR2 (1UL << 2)
+#define EXTI_FTSR_TR3 (1UL << 3)
+#define EXTI_PR_PR0 (1UL << 0)
+#define EXTI_PR_PR1 (1UL << 1)
+#define EXTI_PR_PR2 (1UL << 2)
+#define EXTI_PR_PR3 (1UL << 3)
+#define SYSCFG_EXTICR1_EXTI0_PC (2UL << 0)
+#define SYSCFG_EXTICR1_EXTI1_PC (2UL << 4)
+#define SYSCFG_EXTICR1_EXTI2_PC (2UL << 8)
+#define SYSCFG_EXTICR1_EXTI3_PC (2UL << 12)
+#define DWT_CTRL_CYCCNTENA_Msk (1UL << 0)
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define SCB_SCR_SLEEPDEEP_Msk (1UL << 2)
+
+/*
+****************************************************
+************** Core Intrinsics and NVIC ************
+****************************************************
+*/
+
+/*A test that runs a module from two threads relies on __DMB being a real fence */
+static inline void __DMB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __DSB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __ISB(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __WFI(void) {}
+static inline void __disable_irq(void) {}
+static inline void __enable_irq(void) {}
+static inline uint32_t __get_PRIMASK(void) { return(0); }
+static inline void __set_PRIMASK(uint32_t tmp_primask) { (void)tmp_primask; }
+
+static inline void NVIC_EnableIRQ(IRQn_Type tmp_irq) { (void)tmp_irq; }
+static inline void NVIC_DisableIRQ(IRQn_Type tmp_irq) { (void)tmp_irq; }
+static inline void NVIC_SetPriority(IRQn_Type tmp_irq, uint32_t tmp_priority) { (void)tmp_irq; (void)tmp_priority; }
+static inline void NVIC_ClearPendingIRQ(IRQn_Type tmp_irq) { (void)tmp_irq; }
+static inline void NVIC_SetPendingIRQ(IRQn_Type tmp_irq) { (void)tmp_irq; }
+
+
+#endif /* STM32F4XX_H */
+
+/* end of file */
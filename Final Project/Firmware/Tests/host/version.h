@@ -0,0 +1,6 @@
+#ifndef VERSION_H
+#define VERSION_H
+
+#define VERSION_STRING "host build"
+
+#endif /* VERSION_H */
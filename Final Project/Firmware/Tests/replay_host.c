@@ -0,0 +1,411 @@
+/** @file replay_host.c
+*
+* @brief  Records a session of button presses, timer 5 ticks and console lines through the real
+*         buttons.c, states.c and console.c on a simulated clock, then plays it back fast and in
+*         real time and checks both print exactly what the session did.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include <stdio.h>
+#include <string.h>
+#include "main.h"
+#include "event_queue.h"
+#include "console.h"
+#include "host.h"
+#include "host_test.h"
+
+#define REPLAY_HOST_TIM5_MS 50UL        //Magnet step period
+#define REPLAY_HOST_TIM5_PHASE_MS 25UL  //Ticks land between the inputs, which are on round milliseconds
+#define REPLAY_HOST_LOG_LENGTH 24U
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+typedef enum e_replay_host_action_tag
+{
+   replay_host_action_press,    //arg: pin on BUTTONS_PORT
+   replay_host_action_release,
+   replay_host_action_type,     //text: typed one byte per millisecond
+   max_replay_host_action
+
+} e_replay_host_action;
+
+
+typedef struct s_replay_host_input_tag
+{
+   uint32_t at_ms;
+   uint8_t action;      //e_replay_host_action
+   uint8_t arg;
+   const char * p_text;
+
+} s_replay_host_input;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void replay_host_init(void);
+void replay_host_input(const s_replay_host_input * p_input);
+void replay_host_run_to(uint32_t tmp_ms);
+void replay_host_type(uint32_t tmp_ms, const char * p_text);
+uint32_t replay_host_play(const char * p_command, const char * p_expected, uint32_t tmp_length);
+void states_mag_step(void);  //states.c, the magnet thread's work for one tick
+void EXTI0_IRQHandler(void); //buttons.c
+void EXTI1_IRQHandler(void);
+void EXTI2_IRQHandler(void);
+void EXTI3_IRQHandler(void);
+
+
+/*
+****************************************************
+************* Static Const Variables ***************
+****************************************************
+*/
+
+//Saves the settings the session starts from, so states_init can put them back before each playback
+static const s_replay_host_input replay_host_setup[] =
+{
+   { 100, replay_host_action_press,   0, NULL},
+   {1200, replay_host_action_release, 0, NULL},
+   {1300, replay_host_action_type,    0, "replay record\r\n"},
+};
+
+static const s_replay_host_input replay_host_session[] =
+{
+   {1400, replay_host_action_type,    0, "state\r"},
+   {1500, replay_host_action_press,   0, NULL},      //Mode held past the long press, saves the same settings again
+   {2600, replay_host_action_release, 0, NULL},
+   {2700, replay_host_action_press,   0, NULL},      //Mode click, auto
+   {2750, replay_host_action_release, 0, NULL},
+   {3000, replay_host_action_press,   1, NULL},      //Auto click, the next ramp once the double-click window closes
+   {3050, replay_host_action_release, 1, NULL},
+   {3600, replay_host_action_press,   1, NULL},      //Auto double-click, reverses the ramp
+   {3650, replay_host_action_release, 1, NULL},
+   {3700, replay_host_action_press,   1, NULL},
+   {3750, replay_host_action_release, 1, NULL},
+   {3900, replay_host_action_press,   2, NULL},      //LED click, then held through two repeats
+   {3950, replay_host_action_release, 2, NULL},
+   {4000, replay_host_action_press,   2, NULL},
+   {4800, replay_host_action_release, 2, NULL},
+   {4900, replay_host_action_type,    0, "state\r"},
+   {5000, replay_host_action_press,   0, NULL},      //Mode click, manual
+   {5050, replay_host_action_release, 0, NULL},
+   {5100, replay_host_action_press,   3, NULL},
+   {5150, replay_host_action_type,    0, "state\r"},
+   {5200, replay_host_action_release, 3, NULL},
+   {5300, replay_host_action_press,   0, NULL},      //Mode click, back to idle
+   {5350, replay_host_action_release, 0, NULL},
+   {5400, replay_host_action_type,    0, "state\r"},
+};
+
+#define REPLAY_HOST_STOP_MS 5600UL  //"replay stop" is typed here, after the session
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static char replay_host_recorded[HOST_UART_OUTPUT_LENGTH];
+static uint32_t replay_host_now_ms = 0;
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Records the session, then checks a fast and a real-time playback against it
+* @param[in] NONE
+* @return 0 if every check passed
+*/
+int
+main(void)
+{
+   uint32_t tmp_start = 0;
+   uint32_t tmp_length = 0;
+   uint32_t tmp_fast_ms = 0;
+   uint32_t tmp_real_ms = 0;
+
+   replay_host_init();
+
+   for(uint32_t i = 0; i < (sizeof(replay_host_setup) / sizeof(replay_host_setup[0])); i++)
+   {
+      replay_host_input(&replay_host_setup[i]);
+   }
+
+   HOST_CHECK_EQ(input_replay_get_mode(), input_replay_mode_recording);
+
+   //Everything printed from here to "replay stop" is what a playback must print
+   replay_host_run_to(replay_host_session[0].at_ms - 1UL);
+   tmp_start = host_uart_get_length();
+
+   for(uint32_t i = 0; i < (sizeof(replay_host_session) / sizeof(replay_host_session[0])); i++)
+   {
+      replay_host_input(&replay_host_session[i]);
+   }
+
+   replay_host_run_to(REPLAY_HOST_STOP_MS - 1UL);
+   tmp_length = host_uart_get_length() - tmp_start;
+   memcpy(replay_host_recorded, host_uart_get_output() + tmp_start, tmp_length);
+
+   replay_host_type(REPLAY_HOST_STOP_MS, "replay stop\r\n");
+   HOST_CHECK_EQ(input_replay_get_mode(), input_replay_mode_off);
+   HOST_CHECK(INPUT_REPLAY_BUFFER_SIZE > input_replay_get_count());
+
+   //The session has to have done something worth replaying
+   HOST_CHECK(NULL != strstr(replay_host_recorded, "Settings saved"));
+   HOST_CHECK(NULL != strstr(replay_host_recorded, "Auto State"));
+   HOST_CHECK(NULL != strstr(replay_host_recorded, "Manual State"));
+   HOST_CHECK(NULL != strstr(replay_host_recorded, "[L4]"));
+
+   tmp_fast_ms = replay_host_play("replay fast\r", replay_host_recorded, tmp_length);
+   tmp_real_ms = replay_host_play("replay play\r", replay_host_recorded, tmp_length);
+
+   //The recording spans from the session's first input to the stop line
+   HOST_CHECK(tmp_fast_ms < 10UL);
+   HOST_CHECK(tmp_real_ms > (REPLAY_HOST_STOP_MS - replay_host_session[0].at_ms - 100UL));
+
+   printf("%u inputs, %u bytes printed, fast playback %u ms, real time %u ms\n",
+          (unsigned)input_replay_get_count(), (unsigned)tmp_length, (unsigned)tmp_fast_ms, (unsigned)tmp_real_ms);
+
+   HOST_TEST_DONE();
+}
+
+
+/*
+****************************************************
+************** Host Hardware Hooks *****************
+****************************************************
+*/
+
+/*!
+* @brief Logs each magnet write in the console output, so one buffer holds everything in order
+* @param[in] tmp_magnitude Value written
+* @return NONE
+*/
+void
+magnet_set_mag(uint16_t tmp_magnitude)
+{
+   char tmp_log[REPLAY_HOST_LOG_LENGTH];
+
+   snprintf(tmp_log, sizeof(tmp_log), "[M%u]", (unsigned)tmp_magnitude);
+   uart1_printf(tmp_log);
+}
+
+
+/*!
+* @brief Logs each LED level in the console output
+* @param[in] tmp_level Level set
+* @return NONE
+*/
+void
+led_set_level(uint8_t tmp_level)
+{
+   char tmp_log[REPLAY_HOST_LOG_LENGTH];
+
+   snprintf(tmp_log, sizeof(tmp_log), "[L%u]", (unsigned)tmp_level);
+   uart1_printf(tmp_log);
+}
+
+
+/*!
+* @brief The magnet thread outranks the tasks thread, so it runs as soon as the tick gives it
+* @param[in] p_sem Only ever the magnet thread's semaphore here
+* @return NONE
+*/
+void
+kernel_sem_give(s_kernel_sem * p_sem)
+{
+   states_mag_step();
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Brings the modules up the way main does
+* @param[in] NONE
+* @return NONE
+*/
+void
+replay_host_init(void)
+{
+   host_clock_set_us(0);
+   soft_timers_init();
+   scheduler_init();
+   button_mode_init();
+   button_auto_init();
+   button_led_init();
+   button_manual_init();
+   states_init();
+   ConsoleInit();
+}
+
+
+/*!
+* @brief Applies one scripted input at its time
+* @param[in] p_input Input to apply
+* @return NONE
+*/
+void
+replay_host_input(const s_replay_host_input * p_input)
+{
+   static void (* const tmp_exti[])(void) = {EXTI0_IRQHandler, EXTI1_IRQHandler, EXTI2_IRQHandler, EXTI3_IRQHandler};
+
+   if(replay_host_action_type == p_input->action)
+   {
+      replay_host_type(p_input->at_ms, p_input->p_text);
+      return;
+   }
+
+   replay_host_run_to(p_input->at_ms);
+
+   if(replay_host_action_press == p_input->action)
+   {
+      BUTTONS_PORT->IDR |= (1UL << p_input->arg);
+   }
+
+   else
+   {
+      BUTTONS_PORT->IDR &= ~(1UL << p_input->arg);
+   }
+
+   tmp_exti[p_input->arg]();
+
+   while(scheduler_run())
+   {
+   }
+}
+
+
+/*!
+* @brief Runs the firmware millisecond by millisecond, ticking timer 5, up to a time
+* @param[in] tmp_ms Time to stop at, inputs due then are applied after
+* @return NONE
+*/
+void
+replay_host_run_to(uint32_t tmp_ms)
+{
+   while(replay_host_now_ms < tmp_ms)
+   {
+      replay_host_now_ms++;
+      host_clock_set_us(replay_host_now_ms * 1000UL);
+
+      //TIM5_IRQHandler
+      if(REPLAY_HOST_TIM5_PHASE_MS == (replay_host_now_ms % REPLAY_HOST_TIM5_MS))
+      {
+         if(input_replay_capture(input_replay_source_event, event_type_tim5, 0))
+         {
+            states_mag_tick();
+         }
+      }
+
+      while(scheduler_run())
+      {
+      }
+   }
+}
+
+
+/*!
+* @brief Types a line on the console, one byte per millisecond
+* @param[in] tmp_ms When the first byte arrives
+* @param[in] p_text Bytes to type
+* @return NONE
+*/
+void
+replay_host_type(uint32_t tmp_ms, const char * p_text)
+{
+   for(uint32_t i = 0; '\0' != p_text[i]; i++)
+   {
+      replay_host_run_to(tmp_ms + i);
+      host_uart_receive(p_text[i]);
+
+      while(scheduler_run())
+      {
+      }
+   }
+}
+
+
+/*!
+* @brief Puts the session's starting state back, plays the recording and compares what it printed
+* @param[in] p_command Console line that starts the playback, up to its CR
+* @param[in] p_expected What the session printed
+* @param[in] tmp_length Length of p_expected
+* @return Simulated milliseconds the playback took
+* @note The LF a terminal sends after the CR arrives once playback is under way, and must not stop it
+*/
+uint32_t
+replay_host_play(const char * p_command, const char * p_expected, uint32_t tmp_length)
+{
+   uint32_t tmp_start_ms = 0;
+   uint32_t tmp_start = 0;
+   uint32_t tmp_timeout_ms = 0;
+
+   //A warm reset, the settings saved at the start of the session come back
+   states_init();
+   replay_host_run_to(replay_host_now_ms + 100UL);
+
+   replay_host_type(replay_host_now_ms + 1UL, p_command);
+   tmp_start = host_uart_get_length();
+   tmp_start_ms = replay_host_now_ms;
+   tmp_timeout_ms = tmp_start_ms + (2UL * REPLAY_HOST_STOP_MS);
+
+   while((input_replay_mode_off != input_replay_get_mode()) && (replay_host_now_ms < tmp_timeout_ms))
+   {
+      replay_host_run_to(replay_host_now_ms + 1UL);
+
+      if((input_replay_mode_off != input_replay_get_mode()) && ((tmp_start_ms + 2UL) == replay_host_now_ms))
+      {
+         replay_host_type(replay_host_now_ms, "\n");
+      }
+   }
+
+   HOST_CHECK_EQ(input_replay_get_position(), input_replay_get_count());
+   HOST_CHECK_EQ(host_uart_get_length() - tmp_start, tmp_length);
+   HOST_CHECK(0 == memcmp(host_uart_get_output() + tmp_start, p_expected, tmp_length));
+
+   if(host_test_failures)
+   {
+      printf("%s--- recorded\n%.*s\n--- played\n%s\n", p_command, (int)tmp_length, p_expected,
+             host_uart_get_output() + tmp_start);
+   }
+
+   return(replay_host_now_ms - tmp_start_ms);
+}
+
+/* end of file */
@@ -0,0 +1,254 @@
+/** @file test_capture.c
+*
+* @brief  Unit test of the input capture maths. A synthetic 1kHz 30% edge train is written into
+*         rings the way DMA would and paired by capture_pair, across timer 5 wraps, periods with no
+*         fall, stale falls and a ring overrun.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "capture.h"
+#include "timers.h"
+#include "host_test.h"
+
+#define TEST_CAPTURE_MODULUS ((uint64_t)TIMERS_ARR_FOR(TIMERS_APB1_CLOCK_HZ, TIMERS_MAGNET_STEP_HZ, TIMERS_MAX_ARR_32) + 1U)
+#define TEST_CAPTURE_RING_MASK (CAPTURE_RING_SIZE - 1U)
+#define TEST_CAPTURE_PERIOD 100000UL    //1kHz in timer 5 counts
+#define TEST_CAPTURE_JITTER 10UL        //Periods alternate this far either side, so min and max differ
+#define TEST_CAPTURE_PER_POLL 5U        //Periods DMA writes between polls, CAPTURE_POLL_MS at 1kHz
+#define TEST_CAPTURE_NO_FALL 0xFFFFU    //Duty that writes no fall in the period
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void capture_pair(const volatile uint32_t * p_rises, const volatile uint32_t * p_falls,
+                  uint32_t tmp_rise_head, uint32_t tmp_fall_head, uint64_t tmp_modulus);
+
+void test_capture_restart(void);
+void test_capture_fall(uint64_t tmp_at);
+void test_capture_train(uint32_t tmp_periods, uint32_t tmp_period, uint32_t tmp_jitter,
+                        uint16_t tmp_duty, uint8_t tmp_poll);
+void test_capture_poll(void);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static uint32_t test_capture_rises[CAPTURE_RING_SIZE]; //Stand in for the DMA rings
+static uint32_t test_capture_falls[CAPTURE_RING_SIZE];
+static uint32_t test_capture_rise_head = 0;
+static uint32_t test_capture_fall_head = 0;
+static uint64_t test_capture_now = 0;                 //Time of the next rise, unwrapped
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Runs every capture check
+* @param[in] NONE
+* @return 0 if every check passed
+*/
+int
+main(void)
+{
+   s_capture_stats tmp_stats;
+   uint32_t tmp_periods;
+
+   capture_init();
+
+   //Starts while the line is high, the first edge is a fall from before any rise. It's stale once
+   //the second rise is paired. 300 periods wrap timer 5 three times
+   test_capture_restart();
+   test_capture_now = TEST_CAPTURE_MODULUS - (TEST_CAPTURE_PERIOD / 2U);
+   test_capture_fall(test_capture_now - 1000U);
+   test_capture_train(300, TEST_CAPTURE_PERIOD, TEST_CAPTURE_JITTER, 300, 1);
+
+   capture_get_stats(&tmp_stats);
+   HOST_CHECK_EQ(tmp_stats.periods, 299);
+   HOST_CHECK_EQ(tmp_stats.min_period, TEST_CAPTURE_PERIOD - TEST_CAPTURE_JITTER);
+   HOST_CHECK_EQ(tmp_stats.max_period, TEST_CAPTURE_PERIOD + TEST_CAPTURE_JITTER);
+   HOST_CHECK((TEST_CAPTURE_PERIOD - TEST_CAPTURE_JITTER) <= tmp_stats.avg_period);
+   HOST_CHECK((TEST_CAPTURE_PERIOD + TEST_CAPTURE_JITTER) >= tmp_stats.avg_period);
+   HOST_CHECK_EQ(tmp_stats.last_duty, 300);
+   HOST_CHECK_EQ(tmp_stats.avg_duty, 300);
+   HOST_CHECK_EQ(tmp_stats.overruns, 0);
+   HOST_CHECK((999900 <= capture_get_mhz()) && (1000100 >= capture_get_mhz()));
+
+   //Falls that never came leave the duty where it was, the periods still count
+   test_capture_train(3, TEST_CAPTURE_PERIOD, 0, TEST_CAPTURE_NO_FALL, 1);
+   capture_get_stats(&tmp_stats);
+   HOST_CHECK_EQ(tmp_stats.periods, 302);
+   HOST_CHECK_EQ(tmp_stats.last_period, TEST_CAPTURE_PERIOD);
+   HOST_CHECK_EQ(tmp_stats.last_duty, 300);
+
+   //A missing fall followed by good periods in the same poll, the next fall isn't taken for this period
+   test_capture_train(1, 2U * TEST_CAPTURE_PERIOD, 0, TEST_CAPTURE_NO_FALL, 0);
+   test_capture_train(7, 2U * TEST_CAPTURE_PERIOD, 0, 500, 0);
+   test_capture_poll();
+   capture_get_stats(&tmp_stats);
+   HOST_CHECK_EQ(tmp_stats.periods, 310);
+   HOST_CHECK_EQ(tmp_stats.last_period, 2U * TEST_CAPTURE_PERIOD);
+   HOST_CHECK_EQ(tmp_stats.max_period, 2U * TEST_CAPTURE_PERIOD);
+   HOST_CHECK_EQ(tmp_stats.min_period, TEST_CAPTURE_PERIOD - TEST_CAPTURE_JITTER);
+   HOST_CHECK_EQ(tmp_stats.last_duty, 500);
+   HOST_CHECK((300 < tmp_stats.avg_duty) && (500 > tmp_stats.avg_duty));
+
+   //Polls stop while the edges keep coming. The lapped rings are dropped, nothing bogus is recorded
+   //and the train after the resync is measured from its second rise
+   tmp_periods = tmp_stats.periods;
+   test_capture_train(CAPTURE_RING_SIZE - 1U, TEST_CAPTURE_PERIOD, 0, 300, 0);
+   test_capture_poll();
+   capture_get_stats(&tmp_stats);
+   HOST_CHECK_EQ(tmp_stats.overruns, 1);
+   HOST_CHECK_EQ(tmp_stats.periods, tmp_periods);
+
+   test_capture_train(20, TEST_CAPTURE_PERIOD / 2U, 0, 300, 1);
+   capture_get_stats(&tmp_stats);
+   HOST_CHECK_EQ(tmp_stats.periods, tmp_periods + 19U);
+   HOST_CHECK_EQ(tmp_stats.min_period, TEST_CAPTURE_PERIOD / 2U);
+   HOST_CHECK_EQ(tmp_stats.max_period, 2U * TEST_CAPTURE_PERIOD);
+   HOST_CHECK_EQ(tmp_stats.last_duty, 300);
+
+   //A reset seeds the averages from the next period
+   capture_reset();
+   capture_get_stats(&tmp_stats);
+   HOST_CHECK_EQ(tmp_stats.periods, 0);
+   HOST_CHECK_EQ(tmp_stats.overruns, 0);
+   HOST_CHECK_EQ(capture_get_mhz(), 0);
+
+   test_capture_restart();
+   test_capture_train(40, TEST_CAPTURE_PERIOD / 4U, 0, 100, 1);
+   capture_get_stats(&tmp_stats);
+   HOST_CHECK_EQ(tmp_stats.periods, 39);
+   HOST_CHECK_EQ(tmp_stats.min_period, TEST_CAPTURE_PERIOD / 4U);
+   HOST_CHECK_EQ(tmp_stats.max_period, TEST_CAPTURE_PERIOD / 4U);
+   HOST_CHECK_EQ(tmp_stats.avg_period, TEST_CAPTURE_PERIOD / 4U);
+   HOST_CHECK_EQ(tmp_stats.avg_duty, 100);
+   HOST_CHECK_EQ(capture_get_mhz(), 4000000);
+
+   capture_stop();
+   HOST_CHECK(!capture_is_running());
+
+   HOST_TEST_DONE();
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Restarts capturing, DMA starts again at the top of both rings
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_capture_restart(void)
+{
+   capture_stop();
+   capture_start();
+   HOST_CHECK(capture_is_running());
+
+   test_capture_rise_head = 0;
+   test_capture_fall_head = 0;
+}
+
+
+/*!
+* @brief Writes one falling edge capture the way DMA does
+* @param[in] tmp_at Unwrapped time of the edge
+* @return NONE
+*/
+void
+test_capture_fall(uint64_t tmp_at)
+{
+   test_capture_falls[test_capture_fall_head] = (uint32_t)(tmp_at % TEST_CAPTURE_MODULUS);
+   test_capture_fall_head = (test_capture_fall_head + 1U) & TEST_CAPTURE_RING_MASK;
+}
+
+
+/*!
+* @brief Writes a run of periods into the rings
+* @param[in] tmp_periods Periods to write, each starts with its rise
+* @param[in] tmp_period Counts per period
+* @param[in] tmp_jitter Odd periods are this much longer, even ones this much shorter
+* @param[in] tmp_duty High time in permille, or TEST_CAPTURE_NO_FALL
+* @param[in] tmp_poll 1 to poll every TEST_CAPTURE_PER_POLL periods
+* @return NONE
+*/
+void
+test_capture_train(uint32_t tmp_periods, uint32_t tmp_period, uint32_t tmp_jitter,
+                   uint16_t tmp_duty, uint8_t tmp_poll)
+{
+   uint32_t tmp_length;
+
+   for(uint32_t i = 0; i < tmp_periods; i++)
+   {
+      tmp_length = (i & 1U) ? (tmp_period + tmp_jitter) : (tmp_period - tmp_jitter);
+
+      test_capture_rises[test_capture_rise_head] = (uint32_t)(test_capture_now % TEST_CAPTURE_MODULUS);
+      test_capture_rise_head = (test_capture_rise_head + 1U) & TEST_CAPTURE_RING_MASK;
+
+      if(TEST_CAPTURE_NO_FALL != tmp_duty)
+      {
+         test_capture_fall(test_capture_now + (((uint64_t)tmp_length * tmp_duty) / 1000U));
+      }
+
+      test_capture_now += tmp_length;
+
+      if(tmp_poll && (0 == ((i + 1U) % TEST_CAPTURE_PER_POLL)))
+      {
+         test_capture_poll();
+      }
+   }
+
+   if(tmp_poll)
+   {
+      test_capture_poll();
+   }
+}
+
+
+/*!
+* @brief Runs the soft timer's poll on the test rings
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_capture_poll(void)
+{
+   capture_pair(test_capture_rises, test_capture_falls, test_capture_rise_head, test_capture_fall_head,
+                TEST_CAPTURE_MODULUS);
+}
+
+/* end of file */
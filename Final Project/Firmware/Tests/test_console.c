@@ -0,0 +1,213 @@
+/** @file test_console.c
+*
+* @brief  Regression tests for the console parser bugs the fuzz harness guards.
+*         Run under the address and undefined behaviour sanitizers by make check.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include <string.h>
+#include "console.h"
+#include "consoleCommands.h"
+#include "consoleIoMemory.h"
+#include "host_test.h"
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+const char * test_console_type(const char * p_line);
+void test_console_prefix_match(void);
+void test_console_param_past_line(void);
+void test_console_int16_limit(void);
+void test_console_hex_chars(void);
+void test_console_too_long(void);
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Runs every regression test
+* @param[in] NONE
+* @return 0 if they all passed
+*/
+int
+main(void)
+{
+   test_console_prefix_match();
+   test_console_param_past_line();
+   test_console_int16_limit();
+   test_console_hex_chars();
+   test_console_too_long();
+
+   HOST_TEST_DONE();
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Types a line at a fresh console
+* @param[in] p_line Bytes to type, line endings included
+* @return What the console printed
+*/
+const char *
+test_console_type(const char * p_line)
+{
+   ConsoleInit();
+   ConsoleIoMemoryClearOutput();
+   ConsoleIoMemoryFeed((const uint8_t *)p_line, strlen(p_line), CONSOLE_COMMAND_MAX_LENGTH);
+   ConsoleIoMemoryRun();
+
+   return(ConsoleIoMemoryOutput());
+}
+
+
+/*!
+* @brief ConsoleCommandMatch ran any command whose name started with what was typed
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_console_prefix_match(void)
+{
+   HOST_CHECK(NULL != strstr(test_console_type("help\r"), "Lists the commands"));
+   HOST_CHECK(NULL == strstr(test_console_type("he\r"), "Lists the commands"));
+   HOST_CHECK(NULL != strstr(test_console_type("he\r"), "Command not found."));
+   HOST_CHECK(NULL == strstr(test_console_type("helpme\r"), "Lists the commands"));
+   HOST_CHECK(NULL != strstr(test_console_type("ledOn extra\r"), "LED is now on"));
+   HOST_CHECK(NULL == strstr(test_console_type("led\r"), "LED is now"));
+}
+
+
+/*!
+* @brief ConsoleParamFindN counted separators past the end of the line, into the next command
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_console_param_past_line(void)
+{
+   int16_t tmp_value = 0;
+   char tmp_buffer[CONSOLE_COMMAND_MAX_LENGTH] = "anim\rx 500 60\r";
+
+   HOST_CHECK_EQ(ConsoleReceiveParamInt16(tmp_buffer, 1, &tmp_value), COMMAND_PARAMETER_ERROR);
+   HOST_CHECK_EQ(ConsoleReceiveParamInt16(tmp_buffer, 2, &tmp_value), COMMAND_PARAMETER_ERROR);
+
+   //The second line must not be read as parameters of the first
+   HOST_CHECK(NULL != strstr(test_console_type("anim\rbreathe 700 50 10\r"), "period ms: "));
+   HOST_CHECK(NULL == strstr(test_console_type("anim\rx 700 50 10\r"), "period ms: 700"));
+
+   strcpy(tmp_buffer, "pod 3 12\r");
+   HOST_CHECK_EQ(ConsoleReceiveParamInt16(tmp_buffer, 2, &tmp_value), COMMAND_SUCCESS);
+   HOST_CHECK_EQ(tmp_value, 12);
+   HOST_CHECK_EQ(ConsoleReceiveParamInt16(tmp_buffer, 3, &tmp_value), COMMAND_PARAMETER_ERROR);
+}
+
+
+/*!
+* @brief ConsoleReceiveParamInt16 wrote its terminator one past str when a number filled it
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_console_int16_limit(void)
+{
+   int16_t tmp_value = 0;
+   char tmp_buffer[CONSOLE_COMMAND_MAX_LENGTH] = "x -32768\r";
+
+   HOST_CHECK_EQ(ConsoleReceiveParamInt16(tmp_buffer, 1, &tmp_value), COMMAND_SUCCESS);
+   HOST_CHECK_EQ(tmp_value, -32768);
+
+   //Seven characters is one more than an int16 needs, it must be refused and nothing overrun
+   strcpy(tmp_buffer, "x 1234567\r");
+   HOST_CHECK_EQ(ConsoleReceiveParamInt16(tmp_buffer, 1, &tmp_value), COMMAND_PARAMETER_ERROR);
+   strcpy(tmp_buffer, "x 123456789012\r");
+   HOST_CHECK_EQ(ConsoleReceiveParamInt16(tmp_buffer, 1, &tmp_value), COMMAND_PARAMETER_ERROR);
+
+   //A parameter running into the very end of the receive buffer
+   memset(tmp_buffer, '7', sizeof(tmp_buffer));
+   tmp_buffer[sizeof(tmp_buffer) - 4U] = ' ';
+   HOST_CHECK_EQ(ConsoleReceiveParamInt16(tmp_buffer, 1, &tmp_value), COMMAND_SUCCESS);
+   HOST_CHECK_EQ(tmp_value, 777);
+}
+
+
+/*!
+* @brief ConsoleUtilHexCharToInt took any character for a digit, its OR-ed ranges were always true
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_console_hex_chars(void)
+{
+   uint16_t tmp_value = 0;
+   char tmp_buffer[CONSOLE_COMMAND_MAX_LENGTH] = "x 1F\r";
+
+   HOST_CHECK_EQ(ConsoleReceiveParamHexUint16(tmp_buffer, 1, &tmp_value), COMMAND_SUCCESS);
+   HOST_CHECK_EQ(tmp_value, 0x1F);
+   strcpy(tmp_buffer, "x ab09 1\r");
+   HOST_CHECK_EQ(ConsoleReceiveParamHexUint16(tmp_buffer, 1, &tmp_value), COMMAND_SUCCESS);
+   HOST_CHECK_EQ(tmp_value, 0xAB09);
+   strcpy(tmp_buffer, "x 1g\r");
+   HOST_CHECK_EQ(ConsoleReceiveParamHexUint16(tmp_buffer, 1, &tmp_value), COMMAND_PARAMETER_ERROR);
+   strcpy(tmp_buffer, "x G\r");
+   HOST_CHECK_EQ(ConsoleReceiveParamHexUint16(tmp_buffer, 1, &tmp_value), COMMAND_PARAMETER_ERROR);
+   strcpy(tmp_buffer, "x :\r");
+   HOST_CHECK_EQ(ConsoleReceiveParamHexUint16(tmp_buffer, 1, &tmp_value), COMMAND_PARAMETER_ERROR);
+}
+
+
+/*!
+* @brief A line longer than the receive buffer stalled the console for good
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_console_too_long(void)
+{
+   char tmp_input[400];
+   const char * p_output = 0;
+
+   memset(tmp_input, 'x', 300);
+   strcpy(&tmp_input[300], "\rhelp\r");
+   ConsoleInit();
+   ConsoleIoMemoryClearOutput();
+   ConsoleIoMemoryFeed((const uint8_t *)tmp_input, strlen(tmp_input), CONSOLE_COMMAND_MAX_LENGTH);
+   HOST_CHECK(0 < ConsoleIoMemoryRun());
+   p_output = ConsoleIoMemoryOutput();
+
+   HOST_CHECK(NULL != strstr(p_output, "Command too long."));
+   HOST_CHECK(NULL != strstr(p_output, "Lists the commands"));
+}
+
+/* end of file */
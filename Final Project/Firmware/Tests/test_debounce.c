@@ -0,0 +1,287 @@
+/** @file test_debounce.c
+*
+* @brief  Unit test of the debouncers. Synthetic edge trains go through debounce_edge and
+*         debounce_settle, sample trains through the vertical debouncer.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "debounce.h"
+#include "host_test.h"
+
+#define TEST_DEBOUNCE_SETTLE 0xFFU   //Train entry that calls debounce_settle instead of debounce_edge
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+//One edge of a train, or a settle call a window after the last one
+typedef struct s_test_debounce_edge_tag
+{
+   uint32_t at_us;
+   uint8_t level;             //Level read after the edge, or TEST_DEBOUNCE_SETTLE with the level in settle_level
+   uint8_t settle_level;
+   e_debounce_edge expected;
+
+} s_test_debounce_edge;
+
+
+typedef struct s_test_debounce_train_tag
+{
+   const char * p_name;
+   uint8_t start_level;
+   const s_test_debounce_edge * p_edges;
+   uint32_t edge_count;
+   uint32_t accepted;         //Counters once the train is through
+   uint32_t rejected;
+
+} s_test_debounce_train;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void test_debounce_train(const s_test_debounce_train * p_train);
+void test_debounce_window(void);
+void test_debounce_vertical(void);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+
+//A press that bounces for 3ms, held, then a release that bounces for 2ms
+static const s_test_debounce_edge test_debounce_bouncy[] =
+{
+   {1000, 1, 0, debounce_press},
+   {1300, 0, 0, debounce_none},
+   {1700, 1, 0, debounce_none},
+   {2400, 0, 0, debounce_none},
+   {4000, 1, 0, debounce_none},
+   {300000, 0, 0, debounce_release},
+   {300500, 1, 0, debounce_none},
+   {302000, 0, 0, debounce_none},
+   {0, TEST_DEBOUNCE_SETTLE, 0, debounce_none},
+};
+
+//Spikes too short to be read back, every edge reads the level already held
+static const s_test_debounce_edge test_debounce_glitch[] =
+{
+   {50000, 0, 0, debounce_none},
+   {50002, 0, 0, debounce_none},
+   {0, TEST_DEBOUNCE_SETTLE, 0, debounce_none},
+   {900000, 0, 0, debounce_none},
+   {0, TEST_DEBOUNCE_SETTLE, 0, debounce_none},
+};
+
+//A glitch that is read back high passes as a press, settle hands back the release it hid
+static const s_test_debounce_edge test_debounce_lost_release[] =
+{
+   {10000, 1, 0, debounce_press},
+   {15000, 0, 0, debounce_none},
+   {0, TEST_DEBOUNCE_SETTLE, 0, debounce_release},
+   {0, TEST_DEBOUNCE_SETTLE, 0, debounce_none},
+   {500000, 1, 0, debounce_press},
+};
+
+//A quiet edge that repeats the held level, e.g. the other half of a lost pair, isn't a second press
+static const s_test_debounce_edge test_debounce_repeat[] =
+{
+   {0, 1, 0, debounce_press},
+   {100000, 1, 0, debounce_none},
+   {200000, 0, 0, debounce_release},
+   {300000, 0, 0, debounce_none},
+   {400000, 1, 0, debounce_press},
+};
+
+//Timestamps wrap, the elapsed time is still taken modulo 2^32
+static const s_test_debounce_edge test_debounce_wrap[] =
+{
+   {0xFFFFF000UL, 0, 0, debounce_release},
+   {0x00000010UL, 1, 0, debounce_none},
+   {0x00010000UL, 1, 0, debounce_press},
+};
+
+static const s_test_debounce_train test_debounce_trains[] =
+{
+   {"bouncy press", 0, test_debounce_bouncy, sizeof(test_debounce_bouncy) / sizeof(test_debounce_bouncy[0]), 2, 6},
+   {"glitch", 0, test_debounce_glitch, sizeof(test_debounce_glitch) / sizeof(test_debounce_glitch[0]), 0, 3},
+   {"lost release", 0, test_debounce_lost_release, sizeof(test_debounce_lost_release) / sizeof(test_debounce_lost_release[0]), 3, 1},
+   {"repeat", 0, test_debounce_repeat, sizeof(test_debounce_repeat) / sizeof(test_debounce_repeat[0]), 3, 2},
+   {"wrap", 1, test_debounce_wrap, sizeof(test_debounce_wrap) / sizeof(test_debounce_wrap[0]), 2, 1},
+};
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Runs every debounce check
+* @param[in] NONE
+* @return 0 if every check passed
+*/
+int
+main(void)
+{
+   uint32_t tmp_train;
+
+   for(tmp_train = 0; (sizeof(test_debounce_trains) / sizeof(test_debounce_trains[0])) > tmp_train; tmp_train++)
+   {
+      test_debounce_train(&test_debounce_trains[tmp_train]);
+   }
+
+   test_debounce_window();
+   test_debounce_vertical();
+
+   HOST_TEST_DONE();
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Feeds one edge train through a fresh debouncer with the default window
+* @param[in] p_train Train and what each edge should give
+* @return NONE
+*/
+void
+test_debounce_train(const s_test_debounce_train * p_train)
+{
+   s_debounce tmp_debounce;
+   const s_test_debounce_edge * p_edge;
+   e_debounce_edge tmp_edge;
+   uint32_t tmp_index;
+
+   debounce_init(&tmp_debounce, DEBOUNCE_WINDOW_US, p_train->start_level);
+
+   for(tmp_index = 0; p_train->edge_count > tmp_index; tmp_index++)
+   {
+      p_edge = &p_train->p_edges[tmp_index];
+
+      if(TEST_DEBOUNCE_SETTLE == p_edge->level)
+      {
+         tmp_edge = debounce_settle(&tmp_debounce, p_edge->settle_level);
+      }
+      else
+      {
+         tmp_edge = debounce_edge(&tmp_debounce, p_edge->at_us, p_edge->level);
+      }
+
+      if(tmp_edge != p_edge->expected)
+      {
+         printf("%s, edge %u: got %d, expected %d\n", p_train->p_name, (unsigned)tmp_index, (int)tmp_edge, (int)p_edge->expected);
+         host_test_failures++;
+      }
+   }
+
+   HOST_CHECK_EQ(tmp_debounce.accepted, p_train->accepted);
+   HOST_CHECK_EQ(tmp_debounce.rejected, p_train->rejected);
+}
+
+
+/*!
+* @brief Window changes, the clamp and the counter reset
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_debounce_window(void)
+{
+   s_debounce tmp_debounce;
+
+   debounce_init(&tmp_debounce, DEBOUNCE_MAX_WINDOW_US + 1U, 1);
+   HOST_CHECK_EQ(tmp_debounce.window_us, DEBOUNCE_MAX_WINDOW_US);
+   HOST_CHECK_EQ(tmp_debounce.level, 1);
+
+   //The first edge is never held against a window
+   debounce_set_window(&tmp_debounce, 5000);
+   HOST_CHECK_EQ(debounce_edge(&tmp_debounce, 0, 0), debounce_release);
+   HOST_CHECK_EQ(debounce_edge(&tmp_debounce, 4999, 1), debounce_none);
+   HOST_CHECK_EQ(debounce_edge(&tmp_debounce, 9998, 1), debounce_none);
+   HOST_CHECK_EQ(debounce_edge(&tmp_debounce, 14998, 1), debounce_press);
+
+   debounce_reset_counts(&tmp_debounce);
+   HOST_CHECK_EQ(tmp_debounce.accepted, 0);
+   HOST_CHECK_EQ(tmp_debounce.rejected, 0);
+   HOST_CHECK_EQ(tmp_debounce.level, 1);
+}
+
+
+/*!
+* @brief Sample trains through the bit-sliced debouncer
+* @param[in] NONE
+* @return NONE
+* @note Bit 3 changes cleanly, bit 0 bounces on the way in and bit 5 only glitches. Each change
+*       is reported on the 4th sample in a row that disagrees with the debounced level
+*/
+void
+test_debounce_vertical(void)
+{
+   static const uint16_t tmp_samples[] =
+   {
+      0x0001, 0x0000, 0x0009, 0x0028, 0x0009, 0x0009, 0x0009, 0x0009, 0x0001, 0x0000, 0x0000, 0x0000, 0x0000,
+   };
+   static const uint16_t tmp_pressed_at[] =
+   {
+      0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0008, 0x0000, 0x0001, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+   };
+   static const uint16_t tmp_released_at[] =
+   {
+      0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0008, 0x0001,
+   };
+   s_debounce_vertical tmp_vertical;
+   uint16_t tmp_pressed;
+   uint16_t tmp_released;
+   uint32_t tmp_index;
+
+   debounce_vertical_init(&tmp_vertical, 0x0000);
+
+   for(tmp_index = 0; (sizeof(tmp_samples) / sizeof(tmp_samples[0])) > tmp_index; tmp_index++)
+   {
+      debounce_vertical_scan(&tmp_vertical, tmp_samples[tmp_index], &tmp_pressed, &tmp_released);
+
+      if((tmp_pressed != tmp_pressed_at[tmp_index]) || (tmp_released != tmp_released_at[tmp_index]))
+      {
+         printf("vertical, sample %u: pressed 0x%04X released 0x%04X, expected 0x%04X 0x%04X\n", (unsigned)tmp_index,
+                tmp_pressed, tmp_released, tmp_pressed_at[tmp_index], tmp_released_at[tmp_index]);
+         host_test_failures++;
+      }
+   }
+
+   HOST_CHECK_EQ(tmp_vertical.state, 0x0000);
+}
+
+/* end of file */
@@ -0,0 +1,182 @@
+/** @file test_event_queue.c
+*
+* @brief  Stress test of the SPSC event queue. A second thread stands in for the producer ISRs
+*         and pushes bursts while the main thread drains, every event must come out whole and in order.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include <pthread.h>
+#include <time.h>
+#include "event_queue.h"
+#include "host.h"
+#include "host_test.h"
+
+#define TEST_EVENT_QUEUE_EVENTS 200000UL  //Pushed by the producer thread
+#define TEST_EVENT_QUEUE_MAX_BURST 48U    //Longer than the queue, so some bursts overflow it
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void * test_event_queue_isr(void * p_context);
+void test_event_queue_pause(void);
+uint8_t test_event_queue_data(uint32_t tmp_sequence);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static volatile uint8_t test_event_queue_done = 0;
+static uint32_t test_event_queue_pushed = 0;
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Drains the queue while the producer thread fills it
+* @param[in] NONE
+* @return 0 if every check passed
+* @note Each event carries its sequence number as the timestamp, the producer moves the host
+*       clock before each push. Type and data are derived from it so a torn slot is caught.
+*/
+int
+main(void)
+{
+   pthread_t tmp_isr;
+   s_event tmp_event;
+   uint32_t tmp_popped = 0;
+   uint32_t tmp_last = 0;
+   uint8_t tmp_in_order = 1;
+   uint8_t tmp_whole = 1;
+
+   HOST_CHECK(event_queue_is_empty());
+   HOST_CHECK(0 == event_queue_pop(&tmp_event));
+
+   pthread_create(&tmp_isr, NULL, test_event_queue_isr, NULL);
+
+   while(!test_event_queue_done || !event_queue_is_empty())
+   {
+      if(!event_queue_pop(&tmp_event))
+      {
+         continue;
+      }
+
+      tmp_in_order &= ((0 == tmp_popped) || (tmp_event.timestamp > tmp_last)) ? 1 : 0;
+      tmp_whole &= ((tmp_event.type == (tmp_event.timestamp % max_event_type)) &&
+                    (tmp_event.data == test_event_queue_data(tmp_event.timestamp))) ? 1 : 0;
+      tmp_last = tmp_event.timestamp;
+      tmp_popped++;
+
+      //Now and then leave the producer alone long enough to fill the queue
+      if(0 == (tmp_popped % 4096U))
+      {
+         test_event_queue_pause();
+      }
+   }
+
+   pthread_join(tmp_isr, NULL);
+
+   HOST_CHECK(tmp_in_order);
+   HOST_CHECK(tmp_whole);
+   HOST_CHECK_EQ(tmp_popped + event_queue_get_dropped(), TEST_EVENT_QUEUE_EVENTS);
+   HOST_CHECK_EQ(test_event_queue_pushed, tmp_popped);
+   HOST_CHECK(0 < tmp_popped);
+   HOST_CHECK(EVENT_QUEUE_SIZE > event_queue_get_high_water());
+
+   printf("popped %u, dropped %u, high water %u\n", (unsigned)tmp_popped,
+          (unsigned)event_queue_get_dropped(), (unsigned)event_queue_get_high_water());
+
+   HOST_TEST_DONE();
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Producer thread, pushes every event in bursts the way a bouncing button would
+* @param[in] p_context Unused
+* @return NULL
+*/
+void *
+test_event_queue_isr(void * p_context)
+{
+   uint32_t tmp_sequence = 1;
+   uint32_t tmp_burst = 0;
+
+   while(TEST_EVENT_QUEUE_EVENTS >= tmp_sequence)
+   {
+      for(tmp_burst = 1U + (tmp_sequence % TEST_EVENT_QUEUE_MAX_BURST);
+          (0 < tmp_burst) && (TEST_EVENT_QUEUE_EVENTS >= tmp_sequence); tmp_burst--, tmp_sequence++)
+      {
+         host_clock_set_us(tmp_sequence);
+         test_event_queue_pushed += event_queue_push((e_event_type)(tmp_sequence % max_event_type),
+                                                     test_event_queue_data(tmp_sequence));
+      }
+
+      test_event_queue_pause();
+   }
+
+   test_event_queue_done = 1;
+
+   return(NULL);
+}
+
+
+/*!
+* @brief Gives the other thread the CPU, a bare yield doesn't on a single core
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_event_queue_pause(void)
+{
+   struct timespec tmp_pause = {0, 1000};
+
+   nanosleep(&tmp_pause, NULL);
+}
+
+
+/*!
+* @brief Payload that goes with a sequence number
+* @param[in] tmp_sequence Sequence number of the event
+* @return Data byte
+*/
+uint8_t
+test_event_queue_data(uint32_t tmp_sequence)
+{
+   return((uint8_t)((tmp_sequence * 7U) ^ (tmp_sequence >> 8)));
+}
+
+/* end of file */
@@ -0,0 +1,246 @@
+/** @file test_gesture.c
+*
+* @brief  Unit test of the gesture recognizer. Scripted press and release trains run against each
+*         kind of button config on a 1ms poll loop, once from 0 and once across the 32-bit wrap.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include "gesture.h"
+#include "host_test.h"
+
+#define TEST_GESTURE_MAX_STEPS 8U
+#define TEST_GESTURE_MAX_RESULTS 8U
+#define TEST_GESTURE_WRAP_US 0xFFF0BDC0UL  //1s before the microsecond clock wraps
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+typedef struct s_test_gesture_step_tag
+{
+   uint32_t at_ms;
+   e_debounce_edge edge;
+
+} s_test_gesture_step;
+
+
+typedef struct s_test_gesture_result_tag
+{
+   uint32_t at_ms;
+   e_gesture gesture;
+
+} s_test_gesture_result;
+
+
+//Edges go in at their time, gestures have to come out at theirs and no others
+typedef struct s_test_gesture_script_tag
+{
+   const char * p_name;
+   s_gesture_config config;
+   uint32_t end_ms;
+   s_test_gesture_step steps[TEST_GESTURE_MAX_STEPS];
+   s_test_gesture_result results[TEST_GESTURE_MAX_RESULTS];
+
+} s_test_gesture_script;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void test_gesture_script(const s_test_gesture_script * p_script, uint32_t tmp_start_us);
+void test_gesture_late_poll(void);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+
+//Lists end at the first zero entry, so no script has an edge or a gesture at 0ms
+static const s_test_gesture_script test_gesture_scripts[] =
+{
+   {
+      "long press", {1000, 0, 0, 0}, 4000,
+      {{10, debounce_press}, {100, debounce_release}, {2000, debounce_press}, {3500, debounce_release}},
+      {{100, gesture_click}, {3000, gesture_long_press}},
+   },
+   {
+      "double click", {0, 300, 0, 0}, 3000,
+      {{10, debounce_press}, {50, debounce_release}, {150, debounce_press}, {250, debounce_release},
+       {1000, debounce_press}, {1100, debounce_release}, {2000, debounce_press}, {2050, debounce_release}},
+      {{250, gesture_double_click}, {1400, gesture_click}, {2350, gesture_click}},
+   },
+   {
+      "repeat", {0, 0, 500, 200}, 4000,
+      {{1000, debounce_press}, {2000, debounce_release}, {3000, debounce_press}, {3100, debounce_release}},
+      {{1000, gesture_click}, {1500, gesture_repeat}, {1700, gesture_repeat}, {1900, gesture_repeat},
+       {3000, gesture_click}},
+   },
+   {
+      "plain", {0, 0, 0, 0}, 1000,
+      {{10, debounce_press}, {50, debounce_none}, {60, debounce_release}, {500, debounce_press}, {900, debounce_release}},
+      {{10, gesture_click}, {500, gesture_click}},
+   },
+   {
+      "long press and double click", {1000, 300, 0, 0}, 4000,
+      {{10, debounce_press}, {100, debounce_release}, {200, debounce_press}, {300, debounce_release},
+       {1000, debounce_press}, {2100, debounce_release}, {3000, debounce_press}, {3100, debounce_release}},
+      {{300, gesture_double_click}, {2000, gesture_long_press}, {3400, gesture_click}},
+   },
+   {
+      "repeat wins over long press", {1000, 0, 500, 200}, 2000,
+      {{10, debounce_press}, {800, debounce_release}},
+      {{10, gesture_click}, {510, gesture_repeat}, {710, gesture_repeat}},
+   },
+};
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Runs every gesture check
+* @param[in] NONE
+* @return 0 if every check passed
+*/
+int
+main(void)
+{
+   uint32_t tmp_script;
+
+   for(tmp_script = 0; (sizeof(test_gesture_scripts) / sizeof(test_gesture_scripts[0])) > tmp_script; tmp_script++)
+   {
+      test_gesture_script(&test_gesture_scripts[tmp_script], 0);
+      test_gesture_script(&test_gesture_scripts[tmp_script], TEST_GESTURE_WRAP_US);
+   }
+
+   test_gesture_late_poll();
+
+   HOST_TEST_DONE();
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Plays a script on a 1ms loop, polling before each edge the way states.c does
+* @param[in] p_script Script to play
+* @param[in] tmp_start_us Clock reading at 0ms
+* @return NONE
+*/
+void
+test_gesture_script(const s_test_gesture_script * p_script, uint32_t tmp_start_us)
+{
+   s_gesture tmp_gesture;
+   const s_test_gesture_step * p_step = p_script->steps;
+   const s_test_gesture_result * p_result = p_script->results;
+   e_gesture tmp_got;
+   uint32_t tmp_now_us;
+   uint32_t tmp_ms;
+
+   gesture_init(&tmp_gesture, &p_script->config);
+
+   for(tmp_ms = 0; p_script->end_ms >= tmp_ms; tmp_ms++)
+   {
+      tmp_now_us = tmp_start_us + (tmp_ms * 1000UL);
+
+      do
+      {
+         tmp_got = gesture_poll(&tmp_gesture, tmp_now_us);
+
+         if((gesture_none == tmp_got) && (0 != p_step->at_ms) && (tmp_ms == p_step->at_ms))
+         {
+            tmp_got = gesture_edge(&tmp_gesture, p_step->edge, tmp_now_us);
+            p_step++;
+         }
+
+         if(gesture_none == tmp_got)
+         {
+            continue;
+         }
+
+         if((tmp_got != p_result->gesture) || (tmp_ms != p_result->at_ms))
+         {
+            printf("%s from %lu: gesture %d at %lums, expected %d at %lums\n", p_script->p_name,
+                   (unsigned long)tmp_start_us, (int)tmp_got, (unsigned long)tmp_ms, (int)p_result->gesture,
+                   (unsigned long)p_result->at_ms);
+            host_test_failures++;
+         }
+
+         p_result += (gesture_none != p_result->gesture) ? 1 : 0;
+
+      } while(gesture_none != tmp_got);
+   }
+
+   //Every expected gesture came out, and the button is back to waiting for an edge
+   HOST_CHECK_EQ(p_result->gesture, gesture_none);
+   HOST_CHECK(!gesture_get_deadline(&tmp_gesture, &tmp_now_us));
+}
+
+
+/*!
+* @brief A poll that comes late catches up one repeat at a time, on the original beat
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_gesture_late_poll(void)
+{
+   static const s_gesture_config tmp_config = {0, 0, 500, 200};
+   s_gesture tmp_gesture;
+   uint32_t tmp_deadline_us = 1;
+
+   gesture_init(&tmp_gesture, &tmp_config);
+   HOST_CHECK(!gesture_get_deadline(&tmp_gesture, &tmp_deadline_us));
+   HOST_CHECK_EQ(tmp_deadline_us, 1);
+
+   HOST_CHECK_EQ(gesture_edge(&tmp_gesture, debounce_press, 0), gesture_click);
+   HOST_CHECK(gesture_get_deadline(&tmp_gesture, &tmp_deadline_us));
+   HOST_CHECK_EQ(tmp_deadline_us, 500000);
+   HOST_CHECK_EQ(gesture_poll(&tmp_gesture, 499999), gesture_none);
+
+   HOST_CHECK_EQ(gesture_poll(&tmp_gesture, 1000000), gesture_repeat);
+   HOST_CHECK_EQ(gesture_poll(&tmp_gesture, 1000000), gesture_repeat);
+   HOST_CHECK_EQ(gesture_poll(&tmp_gesture, 1000000), gesture_repeat);
+   HOST_CHECK_EQ(gesture_poll(&tmp_gesture, 1000000), gesture_none);
+   HOST_CHECK(gesture_get_deadline(&tmp_gesture, &tmp_deadline_us));
+   HOST_CHECK_EQ(tmp_deadline_us, 1100000);
+
+   HOST_CHECK_EQ(gesture_edge(&tmp_gesture, debounce_release, 1000000), gesture_none);
+   HOST_CHECK_EQ(gesture_poll(&tmp_gesture, 2000000), gesture_none);
+}
+
+/* end of file */
@@ -0,0 +1,269 @@
+/** @file test_hsm.c
+*
+* @brief  Replays event sequences through the HSM engine on a small test machine and checks
+*         the entry, exit, action and do calls each event makes, in order.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include <string.h>
+#include "hsm.h"
+#include "host_test.h"
+
+#define TEST_HSM_LOG_LENGTH 128U
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+//  top_a         top_b (history)          top_c
+//                  |-- b_one (initial)
+//                  |-- b_two
+typedef enum e_test_hsm_state_tag
+{
+   test_hsm_a,
+   test_hsm_b,
+   test_hsm_b_one,
+   test_hsm_b_two,
+   test_hsm_c,
+   max_test_hsm_state
+
+} e_test_hsm_state;
+
+
+typedef enum e_test_hsm_event_tag
+{
+   test_hsm_next,     //a -> b, c -> b
+   test_hsm_toggle,   //b_one <-> b_two
+   test_hsm_out,      //Handled by b for either child, -> c
+   test_hsm_guarded,  //b_two's entry is guarded off, so b handles it internally
+   test_hsm_self,     //b -> b, exits and re-enters b
+   test_hsm_unused,   //Nobody handles it
+   max_test_hsm_event
+
+} e_test_hsm_event;
+
+
+typedef struct s_test_hsm_step_tag
+{
+   uint8_t event;         //max_test_hsm_event and up checks the range test
+   uint8_t handled;       //What hsm_dispatch should return
+   const char * p_log;    //Calls the event should make
+   uint8_t state;         //Leaf afterwards
+
+} s_test_hsm_step;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void test_hsm_log(const char * p_text);
+void test_hsm_a_entry(void);
+void test_hsm_a_exit(void);
+void test_hsm_b_entry(void);
+void test_hsm_b_exit(void);
+void test_hsm_b_do(void);
+void test_hsm_b_one_entry(void);
+void test_hsm_b_one_exit(void);
+void test_hsm_b_two_entry(void);
+void test_hsm_b_two_exit(void);
+void test_hsm_b_two_do(void);
+void test_hsm_c_entry(void);
+void test_hsm_c_exit(void);
+void test_hsm_action(void);
+uint8_t test_hsm_closed(void);
+
+
+/*
+****************************************************
+************* File-Static Variables ****************
+****************************************************
+*/
+static char test_hsm_calls[TEST_HSM_LOG_LENGTH];
+static uint8_t test_hsm_history[max_test_hsm_state];
+
+
+/*
+****************************************************
+************* Static Const Variables ***************
+****************************************************
+*/
+static const s_hsm_state test_hsm_states[max_test_hsm_state] =
+{
+   [test_hsm_a]     = {HSM_NO_STATE, HSM_NO_STATE, 0, test_hsm_a_entry, test_hsm_a_exit, NULL},
+   [test_hsm_b]     = {HSM_NO_STATE, test_hsm_b_one, HSM_FLAG_HISTORY, test_hsm_b_entry, test_hsm_b_exit, test_hsm_b_do},
+   [test_hsm_b_one] = {test_hsm_b, HSM_NO_STATE, 0, test_hsm_b_one_entry, test_hsm_b_one_exit, NULL},
+   [test_hsm_b_two] = {test_hsm_b, HSM_NO_STATE, 0, test_hsm_b_two_entry, test_hsm_b_two_exit, test_hsm_b_two_do},
+   [test_hsm_c]     = {HSM_NO_STATE, HSM_NO_STATE, 0, test_hsm_c_entry, test_hsm_c_exit, NULL},
+};
+
+static const s_hsm_transition test_hsm_table[max_test_hsm_state][max_test_hsm_event] =
+{
+   [test_hsm_a] =
+   {
+      [test_hsm_next] = {hsm_external, test_hsm_b, NULL, test_hsm_action},
+   },
+
+   [test_hsm_b] =
+   {
+      [test_hsm_out] = {hsm_external, test_hsm_c, NULL, NULL},
+      [test_hsm_guarded] = {hsm_internal, HSM_NO_STATE, NULL, test_hsm_action},
+      [test_hsm_self] = {hsm_external, test_hsm_b, NULL, NULL},
+   },
+
+   [test_hsm_b_one] =
+   {
+      [test_hsm_toggle] = {hsm_external, test_hsm_b_two, NULL, NULL},
+      [test_hsm_guarded] = {hsm_external, test_hsm_b_two, test_hsm_closed, NULL},
+   },
+
+   [test_hsm_b_two] =
+   {
+      [test_hsm_toggle] = {hsm_external, test_hsm_b_one, NULL, NULL},
+   },
+
+   [test_hsm_c] =
+   {
+      [test_hsm_next] = {hsm_external, test_hsm_b, NULL, NULL},
+   },
+};
+
+//Entries and exits are name+ and name-, transition actions are "act", do actions are name*
+static const s_test_hsm_step test_hsm_steps[] =
+{
+   {test_hsm_next,        1, "a- act b+ b1+ ", test_hsm_b_one},
+   {test_hsm_guarded,     1, "act ",           test_hsm_b_one},
+   {test_hsm_toggle,      1, "b1- b2+ ",       test_hsm_b_two},
+   {test_hsm_unused,      0, "",               test_hsm_b_two},
+   {max_test_hsm_event,   0, "",               test_hsm_b_two},
+   {test_hsm_out,         1, "b2- b- c+ ",     test_hsm_c},
+   {test_hsm_toggle,      0, "",               test_hsm_c},
+   {test_hsm_next,        1, "c- b+ b2+ ",     test_hsm_b_two},
+   {test_hsm_self,        1, "b2- b- b+ b2+ ", test_hsm_b_two},
+   {test_hsm_toggle,      1, "b2- b1+ ",       test_hsm_b_one},
+   {test_hsm_out,         1, "b1- b- c+ ",     test_hsm_c},
+   {test_hsm_next,        1, "c- b+ b1+ ",     test_hsm_b_one},
+};
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Replays test_hsm_steps and checks the do actions
+* @param[in] NONE
+* @return 0 if every check passed
+*/
+int
+main(void)
+{
+   s_hsm tmp_hsm =
+   {
+      .p_states = test_hsm_states,
+      .p_table = &test_hsm_table[0][0],
+      .p_history = test_hsm_history,
+      .num_states = max_test_hsm_state,
+      .num_events = max_test_hsm_event,
+      .current = test_hsm_a,
+   };
+
+   hsm_init(&tmp_hsm, test_hsm_a);
+   HOST_CHECK(0 == strcmp(test_hsm_calls, "a+ "));
+
+   for(uint32_t i = 0; i < (sizeof(test_hsm_steps) / sizeof(test_hsm_steps[0])); i++)
+   {
+      test_hsm_calls[0] = '\0';
+      HOST_CHECK_EQ(hsm_dispatch(&tmp_hsm, test_hsm_steps[i].event), test_hsm_steps[i].handled);
+
+      if(0 != strcmp(test_hsm_calls, test_hsm_steps[i].p_log))
+      {
+         printf("step %u: calls \"%s\", expected \"%s\"\n", (unsigned)i, test_hsm_calls, test_hsm_steps[i].p_log);
+         host_test_failures++;
+      }
+
+      HOST_CHECK_EQ(hsm_get_state(&tmp_hsm), test_hsm_steps[i].state);
+   }
+
+   //Do actions run outermost first, and the nesting is what hsm_is_in sees
+   test_hsm_calls[0] = '\0';
+   hsm_dispatch(&tmp_hsm, test_hsm_toggle);
+   test_hsm_calls[0] = '\0';
+   hsm_run(&tmp_hsm);
+   HOST_CHECK(0 == strcmp(test_hsm_calls, "b* b2* "));
+   HOST_CHECK(hsm_is_in(&tmp_hsm, test_hsm_b));
+   HOST_CHECK(hsm_is_in(&tmp_hsm, test_hsm_b_two));
+   HOST_CHECK(!hsm_is_in(&tmp_hsm, test_hsm_b_one));
+   HOST_CHECK(!hsm_is_in(&tmp_hsm, test_hsm_a));
+
+   //A fresh init forgets the history
+   test_hsm_calls[0] = '\0';
+   hsm_init(&tmp_hsm, test_hsm_b);
+   HOST_CHECK(0 == strcmp(test_hsm_calls, "b+ b1+ "));
+
+   HOST_TEST_DONE();
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Adds a call to the log
+* @param[in] p_text Call name, a space is added
+* @return NONE
+*/
+void
+test_hsm_log(const char * p_text)
+{
+   strncat(test_hsm_calls, p_text, TEST_HSM_LOG_LENGTH - strlen(test_hsm_calls) - 2U);
+   strcat(test_hsm_calls, " ");
+}
+
+void test_hsm_a_entry(void) { test_hsm_log("a+"); }
+void test_hsm_a_exit(void) { test_hsm_log("a-"); }
+void test_hsm_b_entry(void) { test_hsm_log("b+"); }
+void test_hsm_b_exit(void) { test_hsm_log("b-"); }
+void test_hsm_b_do(void) { test_hsm_log("b*"); }
+void test_hsm_b_one_entry(void) { test_hsm_log("b1+"); }
+void test_hsm_b_one_exit(void) { test_hsm_log("b1-"); }
+void test_hsm_b_two_entry(void) { test_hsm_log("b2+"); }
+void test_hsm_b_two_exit(void) { test_hsm_log("b2-"); }
+void test_hsm_b_two_do(void) { test_hsm_log("b2*"); }
+void test_hsm_c_entry(void) { test_hsm_log("c+"); }
+void test_hsm_c_exit(void) { test_hsm_log("c-"); }
+void test_hsm_action(void) { test_hsm_log("act"); }
+
+//Guard that never passes
+uint8_t test_hsm_closed(void) { return(0); }
+
+/* end of file */
@@ -0,0 +1,284 @@
+/** @file test_states.c
+*
+* @brief  Replays timed button sequences through states.c on the host and checks the state,
+*         the magnet and the LED after each one. Gestures run on the event timestamps, the
+*         magnet thread's step is called directly.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include <string.h>
+#include "main.h"
+#include "event_queue.h"
+#include "host.h"
+#include "host_test.h"
+
+/*
+****************************************************
+***** Private Types and Structure Definitions ******
+****************************************************
+*/
+
+typedef enum e_test_states_action_tag
+{
+   test_states_reset,     //states_init, as after a warm reset
+   test_states_press,     //arg: e_event_type of the button
+   test_states_release,
+   test_states_poll,      //The gesture timer went off
+   test_states_step,      //arg: magnet thread steps to run, then expect the magnet at text
+   test_states_manual,    //arg: manual button level
+   test_states_magnet,    //arg: expected magnet
+   test_states_led,       //arg: expected LED level
+   test_states_state,     //text: expected states_print_state output
+   test_states_printed,   //text: expected in everything printed since the last check
+   max_test_states_action
+
+} e_test_states_action;
+
+
+typedef struct s_test_states_step_tag
+{
+   uint32_t at_ms;
+   uint8_t action;        //e_test_states_action
+   uint16_t arg;
+   const char * p_text;
+
+} s_test_states_step;
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void test_states_run(uint32_t tmp_index, const s_test_states_step * p_step);
+void test_states_mag_service(void);  //states.c, the magnet thread's work for one tick
+
+
+/*
+****************************************************
+************* Static Const Variables ***************
+****************************************************
+*/
+static const s_test_states_step test_states_script[] =
+{
+   {   0, test_states_reset,   0, NULL},
+   {   0, test_states_state,   0, "Idle State"},
+
+   //Mode click enters auto in its first algorithm, the short ramp
+   { 100, test_states_press,   event_type_button_mode, NULL},
+   { 150, test_states_release, event_type_button_mode, NULL},
+   { 150, test_states_state,   0, "Auto State"},
+   { 150, test_states_step,    1, NULL},
+   { 150, test_states_magnet,  544, NULL},
+   { 150, test_states_step,    6, NULL},
+   { 150, test_states_magnet,  3808, NULL},
+   { 150, test_states_step,    2, NULL},     //The last step pushes the terminator, full field
+   { 150, test_states_magnet,  MAGNET_MAG_MAX, NULL},
+
+   //An auto click waits out the double-click window before stepping to the medium ramp
+   { 200, test_states_press,   event_type_button_auto, NULL},
+   { 250, test_states_release, event_type_button_auto, NULL},
+   { 400, test_states_poll,    0, NULL},
+   { 400, test_states_step,    1, NULL},
+   { 400, test_states_magnet,  544, NULL},
+   { 560, test_states_poll,    0, NULL},
+   { 560, test_states_step,    11, NULL},
+   { 560, test_states_magnet,  272, NULL},
+
+   //A double-click reverses the ramp from the step it is on
+   { 700, test_states_press,   event_type_button_auto, NULL},
+   { 750, test_states_release, event_type_button_auto, NULL},
+   { 800, test_states_press,   event_type_button_auto, NULL},
+   { 850, test_states_release, event_type_button_auto, NULL},
+   {1200, test_states_poll,    0, NULL},
+   {1200, test_states_step,    1, NULL},
+   {1200, test_states_magnet,  816, NULL},
+
+   //Holding mode saves the settings, and its release isn't a click
+   {1300, test_states_press,   event_type_button_mode, NULL},
+   {2300, test_states_poll,    0, NULL},
+   {2300, test_states_printed, 0, "Settings saved"},
+   {2400, test_states_release, event_type_button_mode, NULL},
+   {2400, test_states_state,   0, "Auto State"},
+
+   //LED clicks on the press, then repeats while held
+   {2500, test_states_press,   event_type_button_led, NULL},
+   {2550, test_states_release, event_type_button_led, NULL},
+   {2550, test_states_led,     1, NULL},
+   {2600, test_states_press,   event_type_button_led, NULL},
+   {3100, test_states_poll,    0, NULL},
+   {3350, test_states_poll,    0, NULL},
+   {3600, test_states_poll,    0, NULL},
+   {3650, test_states_release, event_type_button_led, NULL},
+   {3650, test_states_led,     5, NULL},
+
+   //Manual hands the magnet to the manual button until it is left
+   {3700, test_states_press,   event_type_button_mode, NULL},
+   {3750, test_states_release, event_type_button_mode, NULL},
+   {3750, test_states_state,   0, "Manual State"},
+   {3750, test_states_magnet,  MAGNET_MAG_OFF, NULL},
+   {3760, test_states_manual,  1, NULL},
+   {3760, test_states_magnet,  MAGNET_MAG_MAX, NULL},
+   {3770, test_states_manual,  0, NULL},
+   {3770, test_states_magnet,  MAGNET_MAG_OFF, NULL},
+   {3800, test_states_press,   event_type_button_mode, NULL},
+   {3850, test_states_release, event_type_button_mode, NULL},
+   {3850, test_states_state,   0, "Idle State"},
+   {3860, test_states_manual,  1, NULL},
+   {3860, test_states_magnet,  MAGNET_MAG_OFF, NULL},
+
+   //Auto resumes in the medium ramp it was left in, still reversed
+   {3900, test_states_press,   event_type_button_mode, NULL},
+   {3950, test_states_release, event_type_button_mode, NULL},
+   {3950, test_states_state,   0, "Auto State"},
+   {3950, test_states_step,    1, NULL},
+   {3950, test_states_magnet,  3808, NULL},
+
+   //After a reset the saved settings come back: medium, reversed, LED as it was when saved
+   {5000, test_states_reset,   0, NULL},
+   {5000, test_states_state,   0, "Idle State"},
+   {5000, test_states_led,     0, NULL},
+   {5100, test_states_press,   event_type_button_mode, NULL},
+   {5150, test_states_release, event_type_button_mode, NULL},
+   {5150, test_states_step,    1, NULL},
+   {5150, test_states_magnet,  3808, NULL},
+   {5150, test_states_step,    1, NULL},
+   {5150, test_states_magnet,  3536, NULL},
+};
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Plays test_states_script
+* @param[in] NONE
+* @return 0 if every check passed
+*/
+int
+main(void)
+{
+   for(uint32_t i = 0; i < (sizeof(test_states_script) / sizeof(test_states_script[0])); i++)
+   {
+      test_states_run(i, &test_states_script[i]);
+   }
+
+   HOST_TEST_DONE();
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Plays one line of the script
+* @param[in] tmp_index Line number, for failure messages
+* @param[in] p_step Line to play
+* @return NONE
+*/
+void
+test_states_run(uint32_t tmp_index, const s_test_states_step * p_step)
+{
+   uint32_t tmp_failures = host_test_failures;
+
+   host_clock_set_us(p_step->at_ms * 1000UL);
+
+   switch(p_step->action)
+   {
+      case test_states_reset:
+         states_init();
+         break;
+
+      case test_states_press:
+      case test_states_release:
+         event_queue_push((e_event_type)p_step->arg,
+                          (test_states_press == p_step->action) ? debounce_press : debounce_release);
+         states_update_main_event();
+         break;
+
+      case test_states_poll:
+         states_update_main_event();
+         break;
+
+      case test_states_step:
+         for(uint16_t i = 0; i < p_step->arg; i++)
+         {
+            test_states_mag_service();
+         }
+         break;
+
+      case test_states_manual:
+         states_manual_edge((uint8_t)p_step->arg);
+         break;
+
+      case test_states_magnet:
+         HOST_CHECK_EQ(host_magnet_get(), p_step->arg);
+         break;
+
+      case test_states_led:
+         HOST_CHECK_EQ(host_led_get_level(), p_step->arg);
+         break;
+
+      case test_states_state:
+         host_uart_clear_output();
+         states_print_state();
+         HOST_CHECK(NULL != strstr(host_uart_get_output(), p_step->p_text));
+         break;
+
+      case test_states_printed:
+         HOST_CHECK(NULL != strstr(host_uart_get_output(), p_step->p_text));
+         host_uart_clear_output();
+         break;
+
+      default:
+         break;
+   }
+
+   if(tmp_failures != host_test_failures)
+   {
+      printf("  at script line %u, %u ms\n", (unsigned)tmp_index, (unsigned)p_step->at_ms);
+   }
+}
+
+
+/*!
+* @brief One pass of the magnet thread's loop, without blocking on the tick
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_states_mag_service(void)
+{
+   extern void states_mag_service(void);
+
+   states_mag_service();
+}
+
+/* end of file */
@@ -0,0 +1,231 @@
+/** @file test_timers.c
+*
+* @brief  Unit test of the PSC/ARR solver. The macros are checked at compile time for the rates
+*         the firmware uses, timers_solve() is swept across the range and the driver runs on the host registers.
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#include <string.h>
+#include "timers.h"
+#include "host.h"
+#include "host_test.h"
+
+#define TEST_TIMERS_CLOCK_HZ 100000000UL
+#define TEST_TIMERS_SWEEP_STEP 1009UL  //Per thousand, grows the rate ~0.9% a step so no pattern lines up
+#define TEST_TIMERS_UNTOUCHED 0xA5A5A5A5UL
+
+//The rates the firmware runs at, worked out by hand
+_Static_assert(0 == TIMERS_PSC_FOR(TIMERS_APB1_CLOCK_HZ, TIMERS_MAGNET_STEP_HZ, TIMERS_MAX_ARR_32), "timer 5 prescaler");
+_Static_assert(9999999 == TIMERS_ARR_FOR(TIMERS_APB1_CLOCK_HZ, TIMERS_MAGNET_STEP_HZ, TIMERS_MAX_ARR_32), "timer 5 reload");
+_Static_assert(0 == TIMERS_PSC_FOR_COUNTS(TIMERS_APB2_CLOCK_HZ, TIMERS_LED_PWM_HZ, TIMERS_LED_PWM_COUNTS), "LED PWM prescaler");
+_Static_assert(84 == TIMERS_ERROR_PPM(TIMERS_APB2_CLOCK_HZ, TIMERS_LED_PWM_HZ, 0, TIMERS_LED_PWM_COUNTS - 1U), "LED PWM error");
+_Static_assert(1 == TIMERS_PSC_FOR(TEST_TIMERS_CLOCK_HZ, 1000, TIMERS_MAX_ARR_16), "1kHz prescaler");
+_Static_assert(49999 == TIMERS_ARR_FOR(TEST_TIMERS_CLOCK_HZ, 1000, TIMERS_MAX_ARR_16), "1kHz reload");
+_Static_assert(TIMERS_CONFIG_OK(TEST_TIMERS_CLOCK_HZ, 3, 508, 65530, TIMERS_MAX_ARR_16), "3Hz fits 16 bits");
+_Static_assert(!TIMERS_CONFIG_OK(TEST_TIMERS_CLOCK_HZ, 1000, 0, 99998, TIMERS_MAX_ARR_16), "reload past 16 bits");
+_Static_assert(!TIMERS_CONFIG_OK(TEST_TIMERS_CLOCK_HZ, 1000, 1, 49948, TIMERS_MAX_ARR_16), "1020ppm off");
+
+
+/*
+****************************************************
+********** Private Function Prototypes *************
+****************************************************
+*/
+void test_timers_sweep(uint32_t tmp_counts, uint32_t tmp_max_arr);
+void test_timers_edges(void);
+void test_timers_driver(void);
+
+
+/*
+****************************************************
+********** Public Function Definitions *************
+****************************************************
+*/
+
+/*!
+* @brief Runs every timer check
+* @param[in] NONE
+* @return 0 if every check passed
+*/
+int
+main(void)
+{
+   test_timers_sweep(TIMERS_COUNTS_ANY, TIMERS_MAX_ARR_16);
+   test_timers_sweep(TIMERS_COUNTS_ANY, TIMERS_MAX_ARR_32);
+   test_timers_sweep(TIMERS_LED_PWM_COUNTS, TIMERS_MAX_ARR_16);
+   test_timers_edges();
+   test_timers_driver();
+
+   HOST_TEST_DONE();
+}
+
+
+/*
+****************************************************
+********** Private Function Definitions ************
+****************************************************
+*/
+
+/*!
+* @brief Solves every rate from 1Hz to half the clock and checks each answer
+* @param[in] tmp_counts Counts per period, or TIMERS_COUNTS_ANY
+* @param[in] tmp_max_arr Largest reload value of the counter
+* @return NONE
+* @note An accepted rate has to fit the registers, be within TIMERS_MAX_ERROR_PPM and, for
+*       TIMERS_COUNTS_ANY, use the smallest prescaler that fits. A rejected one must really be out of reach
+*/
+void
+test_timers_sweep(uint32_t tmp_counts, uint32_t tmp_max_arr)
+{
+   s_timers_config tmp_config;
+   uint64_t tmp_hz;
+   uint64_t tmp_ticks;
+   uint64_t tmp_psc;
+   uint64_t tmp_arr;
+   int64_t tmp_error;
+   uint32_t tmp_solved = 0;
+   uint32_t tmp_rejected = 0;
+   uint32_t tmp_bad = 0;
+
+   for(tmp_hz = 1; (TEST_TIMERS_CLOCK_HZ / 2U) >= tmp_hz; tmp_hz = ((tmp_hz * TEST_TIMERS_SWEEP_STEP) / 1000U) + 1U)
+   {
+      tmp_config.psc = TEST_TIMERS_UNTOUCHED;
+      tmp_config.arr = TEST_TIMERS_UNTOUCHED;
+
+      if(timers_solve(TEST_TIMERS_CLOCK_HZ, (uint32_t)tmp_hz, tmp_counts, tmp_max_arr, &tmp_config))
+      {
+         tmp_solved++;
+         tmp_ticks = TIMERS_TICKS_FOR(TEST_TIMERS_CLOCK_HZ, tmp_hz);
+         tmp_error = TIMERS_ERROR_PPM(TEST_TIMERS_CLOCK_HZ, tmp_hz, tmp_config.psc, tmp_config.arr);
+
+         tmp_bad += ((TIMERS_MAX_PSC < tmp_config.psc) || (tmp_max_arr < tmp_config.arr)) ? 1U : 0U;
+         tmp_bad += ((TIMERS_MAX_ERROR_PPM < tmp_error) || (-TIMERS_MAX_ERROR_PPM > tmp_error)) ? 1U : 0U;
+
+         if(TIMERS_COUNTS_ANY == tmp_counts)
+         {
+            //One less prescaler step wouldn't fit the reload
+            tmp_bad += (((uint64_t)tmp_config.psc * ((uint64_t)tmp_max_arr + 1U)) >= tmp_ticks) ? 1U : 0U;
+         }
+         else
+         {
+            tmp_bad += ((tmp_counts - 1U) != tmp_config.arr) ? 1U : 0U;
+         }
+      }
+      else
+      {
+         tmp_rejected++;
+         tmp_bad += ((TEST_TIMERS_UNTOUCHED != tmp_config.psc) || (TEST_TIMERS_UNTOUCHED != tmp_config.arr)) ? 1U : 0U;
+
+         //The macros' own answer is the best there is, it has to fail the check too
+         tmp_psc = (TIMERS_COUNTS_ANY == tmp_counts) ? TIMERS_PSC_FOR(TEST_TIMERS_CLOCK_HZ, tmp_hz, tmp_max_arr) :
+                   TIMERS_PSC_FOR_COUNTS(TEST_TIMERS_CLOCK_HZ, tmp_hz, tmp_counts);
+         tmp_arr = (TIMERS_COUNTS_ANY == tmp_counts) ? TIMERS_ARR_FOR(TEST_TIMERS_CLOCK_HZ, tmp_hz, tmp_max_arr) :
+                   (tmp_counts - 1U);
+         tmp_bad += TIMERS_CONFIG_OK(TEST_TIMERS_CLOCK_HZ, tmp_hz, tmp_psc, tmp_arr, tmp_max_arr) ? 1U : 0U;
+      }
+   }
+
+   HOST_CHECK_EQ(tmp_bad, 0);
+   HOST_CHECK(0 < tmp_solved);
+
+   printf("counts %u, max ARR 0x%X: %u solved, %u rejected\n", (unsigned)tmp_counts, (unsigned)tmp_max_arr,
+          (unsigned)tmp_solved, (unsigned)tmp_rejected);
+}
+
+
+/*!
+* @brief Rates at and past the limits of the solver
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_timers_edges(void)
+{
+   s_timers_config tmp_config = {0, 0};
+
+   //Two counts per period is as fast as it goes
+   HOST_CHECK(!timers_solve(TEST_TIMERS_CLOCK_HZ, 0, TIMERS_COUNTS_ANY, TIMERS_MAX_ARR_16, &tmp_config));
+   HOST_CHECK(!timers_solve(TEST_TIMERS_CLOCK_HZ, (TEST_TIMERS_CLOCK_HZ / 2U) + 1U, TIMERS_COUNTS_ANY, TIMERS_MAX_ARR_16, &tmp_config));
+   HOST_CHECK(timers_solve(TEST_TIMERS_CLOCK_HZ, TEST_TIMERS_CLOCK_HZ / 2U, TIMERS_COUNTS_ANY, TIMERS_MAX_ARR_16, &tmp_config));
+   HOST_CHECK_EQ(tmp_config.psc, 0);
+   HOST_CHECK_EQ(tmp_config.arr, 1);
+
+   //1Hz needs a prescaler on 16 bits and none on 32
+   HOST_CHECK(timers_solve(TEST_TIMERS_CLOCK_HZ, 1, TIMERS_COUNTS_ANY, TIMERS_MAX_ARR_16, &tmp_config));
+   HOST_CHECK_EQ(tmp_config.psc, 1525);
+   HOST_CHECK_EQ(tmp_config.arr, 65530);
+   HOST_CHECK(timers_solve(TEST_TIMERS_CLOCK_HZ, 1, TIMERS_COUNTS_ANY, TIMERS_MAX_ARR_32, &tmp_config));
+   HOST_CHECK_EQ(tmp_config.psc, 0);
+   HOST_CHECK_EQ(tmp_config.arr, TEST_TIMERS_CLOCK_HZ - 1U);
+
+   //Fixed counts: more than the counter holds, a prescaler past 16 bits, a rate the depth can't reach
+   HOST_CHECK(!timers_solve(TEST_TIMERS_CLOCK_HZ, 1000, TIMERS_MAX_ARR_16 + 2U, TIMERS_MAX_ARR_16, &tmp_config));
+   HOST_CHECK(!timers_solve(TEST_TIMERS_CLOCK_HZ, 1, 2, TIMERS_MAX_ARR_16, &tmp_config));
+   HOST_CHECK(!timers_solve(TEST_TIMERS_CLOCK_HZ, 7000, TIMERS_LED_PWM_COUNTS, TIMERS_MAX_ARR_16, &tmp_config));
+   HOST_CHECK(timers_solve(TEST_TIMERS_CLOCK_HZ, 1526, TIMERS_MAX_ARR_16 + 1U, TIMERS_MAX_ARR_16, &tmp_config));
+   HOST_CHECK_EQ(tmp_config.psc, 0);
+   HOST_CHECK_EQ(tmp_config.arr, TIMERS_MAX_ARR_16);
+}
+
+
+/*!
+* @brief Runs the driver on the host register file
+* @param[in] NONE
+* @return NONE
+*/
+void
+test_timers_driver(void)
+{
+   const s_timers_config tmp_config = {1, 49999};
+   int32_t tmp_error_ppm = -1;
+
+   memset(&host_tim11, 0, sizeof(host_tim11));
+   host_tim11.SR = TIM_SR_UIF;
+
+   timers_init(timers_tim11, &tmp_config);
+   HOST_CHECK(host_rcc.APB2ENR & RCC_APB2ENR_TIM11EN);
+   HOST_CHECK_EQ(host_tim11.CR1, TIM_CR1_URS);
+   HOST_CHECK_EQ(host_tim11.PSC, 1);
+   HOST_CHECK_EQ(host_tim11.ARR, 49999);
+   HOST_CHECK_EQ(host_tim11.EGR, TIM_EGR_UG);
+   HOST_CHECK_EQ(host_tim11.SR, 0);
+   HOST_CHECK_EQ(timers_get_mhz(timers_tim11), 1000000);
+
+   timers_start(timers_tim11);
+   HOST_CHECK(host_tim11.CR1 & TIM_CR1_CEN);
+
+   HOST_CHECK(timers_set_hz(timers_tim11, 400, TIMERS_COUNTS_ANY, &tmp_error_ppm));
+   HOST_CHECK_EQ(timers_get_mhz(timers_tim11), 400000);
+   HOST_CHECK_EQ(host_tim11.PSC, 3);
+   HOST_CHECK_EQ(tmp_error_ppm, 0);
+
+   //A rate it can't reach leaves the timer alone
+   HOST_CHECK(!timers_set_hz(timers_tim11, 7000, TIMERS_LED_PWM_COUNTS, NULL));
+   HOST_CHECK_EQ(timers_get_mhz(timers_tim11), 400000);
+
+   timers_stop(timers_tim11);
+   HOST_CHECK(0 == (host_tim11.CR1 & TIM_CR1_CEN));
+}
+
+/* end of file */
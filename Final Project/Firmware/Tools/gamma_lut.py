@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Generate the LED gamma table header, Includes/led_gamma.h.
+
+The LED levels are stored as PWM compare values so the firmware does no
+maths to set them. Level 0 is off, the last level is fully on, and the
+ones between are spaced evenly in perceived brightness:
+
+    compare = round(2^bits * (level / (levels - 1)) ^ gamma)
+
+Run from the Firmware directory after changing any of the options:
+
+    gamma_lut.py --gamma 2.2 --bits 14 --levels 8 > Includes/led_gamma.h
+
+--bits must match TIMERS_LED_PWM_BITS in timers.h, led.c checks this at
+compile time.
+"""
+
+import argparse
+import sys
+
+HEADER = """/** @file led_gamma.h
+*
+* @brief  Perceptually even LED levels as PWM compare values.
+*         Generated by Tools/gamma_lut.py, do not edit by hand
+* @author Aaron Vorse
+* @date   10/18/2026
+* @contact aaron.vorse@embeddedresume.com
+*
+* @LICENSE:
+*
+*  Licensed to the Apache Software Foundation (ASF) under one
+*  or more contributor license agreements.  See the NOTICE file
+*  distributed with this work for additional information
+*  regarding copyright ownership.  The ASF licenses this file
+*  to you under the Apache License, Version 2.0 (the
+*  "License"); you may not use this file except in compliance
+*  with the License.  You may obtain a copy of the License at
+*
+*    http://www.apache.org/licenses/LICENSE-2.0
+*
+*  Unless required by applicable law or agreed to in writing,
+*  software distributed under the License is distributed on an
+*  "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+*  KIND, either express or implied.  See the License for the
+*  specific language governing permissions and limitations
+*  under the License.
+*/
+
+#ifndef LED_GAMMA_H
+#define LED_GAMMA_H
+"""
+
+FOOTER = """
+#endif /* LED_GAMMA_H */
+
+/* end of file */
+"""
+
+
+def levels(gamma, bits, count):
+    full = 1 << bits
+    return [int(round(full * (level / (count - 1)) ** gamma)) for level in range(count)]
+
+
+def render(gamma, bits, count):
+    values = levels(gamma, bits, count)
+    lines = [HEADER]
+    lines.append("//gamma_lut.py --gamma %g --bits %d --levels %d" % (gamma, bits, count))
+    lines.append("#define LED_GAMMA_X10 %dU" % int(round(gamma * 10)))
+    lines.append("#define LED_GAMMA_BITS %dU" % bits)
+    lines.append("#define LED_GAMMA_LEVELS %dU" % count)
+    lines.append("")
+    lines.append("//Initializer for a const uint16_t[LED_GAMMA_LEVELS], so the table lands in flash")
+    lines.append("#define LED_GAMMA_TABLE \\")
+    lines.append("{ \\")
+    for start in range(0, count, 8):
+        row = ", ".join("%5d" % value for value in values[start:start + 8])
+        tail = "," if start + 8 < count else ""
+        lines.append("   %s%s \\" % (row, tail))
+    lines.append("}")
+    lines.append(FOOTER)
+    return "\n".join(lines)
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("--gamma", type=float, default=2.2)
+    parser.add_argument("--bits", type=int, default=14, help="PWM resolution, 2^bits counts per period")
+    parser.add_argument("--levels", type=int, default=8, help="number of levels including off")
+    args = parser.parse_args(argv[1:])
+
+    # Full on is 2^bits, which still has to fit the uint16_t compare value
+    if not 1 <= args.bits <= 15 or args.levels < 2 or args.gamma <= 0:
+        parser.error("need 1 <= bits <= 15, levels >= 2 and gamma > 0")
+
+    sys.stdout.write(render(args.gamma, args.bits, args.levels))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))
@@ -0,0 +1,133 @@
+#!/usr/bin/env python3
+"""Convert a firmware trace dump into Chrome / Perfetto trace JSON.
+
+Capture the raw serial output of the "trace dump" console command into a
+file (for example with `cat /dev/ttyUSB0 > dump.bin` while sending the
+command from another terminal), then run:
+
+    trace2json.py dump.bin trace.json
+
+and open trace.json in chrome://tracing or https://ui.perfetto.dev.
+
+The dump format is written by trace_dump() in Source/trace.c. The name
+tables below must follow the enums in trace.h, states.c and the console
+command table in consoleCommands.c.
+"""
+
+import json
+import struct
+import sys
+
+MAGIC = b"TRC1"
+HEADER = struct.Struct("<III")   # cpu_hz, count, overwritten
+RECORD = struct.Struct("<IBBH")  # cycles, id, arg8, arg16
+
+TRACE_ID_ISR_ENTER = 0
+TRACE_ID_ISR_EXIT = 1
+TRACE_ID_STATE = 2
+TRACE_ID_COMMAND = 3
+TRACE_ID_DAC = 4
+
+ISR_NAMES = ["TIM5", "EXTI0", "EXTI1", "EXTI2", "USART1", "EXTI3"]
+STATE_NAMES = ["idle", "auto_pulse", "manual", "auto_short", "auto_medium", "auto_long"]
+COMMAND_NAMES = ["help", "ledOn", "ledOff", "state", "tasks", "writes", "prof", "kernel", "replay", "trace", "anim", "pod", "capture", "buttons"]
+
+TID_ISR = 1
+TID_STATE = 2
+TID_CONSOLE = 3
+TID_DAC = 4
+
+
+def name_of(table, index):
+    return table[index] if index < len(table) else str(index)
+
+
+def parse(data):
+    start = data.rfind(MAGIC)
+    if start < 0:
+        raise ValueError("no %r marker found, is this a trace dump?" % MAGIC)
+
+    offset = start + len(MAGIC)
+    cpu_hz, count, overwritten = HEADER.unpack_from(data, offset)
+    offset += HEADER.size
+
+    available = (len(data) - offset) // RECORD.size
+    if available < count:
+        sys.stderr.write("warning: dump truncated, %d of %d records\n" % (available, count))
+        count = available
+
+    records = [RECORD.unpack_from(data, offset + i * RECORD.size) for i in range(count)]
+    return cpu_hz, overwritten, records
+
+
+def convert(cpu_hz, records):
+    events = [
+        {"ph": "M", "pid": 0, "tid": TID_ISR, "name": "thread_name", "args": {"name": "ISRs"}},
+        {"ph": "M", "pid": 0, "tid": TID_STATE, "name": "thread_name", "args": {"name": "state machine"}},
+        {"ph": "M", "pid": 0, "tid": TID_CONSOLE, "name": "thread_name", "args": {"name": "console"}},
+        {"ph": "M", "pid": 0, "tid": TID_DAC, "name": "thread_name", "args": {"name": "DAC"}},
+    ]
+
+    # The cycle counter wraps every 2^32 cycles, records are in time order so
+    # each step forward is taken modulo 2^32
+    first = records[0][0] if records else 0
+    previous = first
+    elapsed = 0
+    last_tim5_us = None
+
+    for cycles, trace_id, arg8, arg16 in records:
+        elapsed += (cycles - previous) & 0xFFFFFFFF
+        previous = cycles
+        ts = elapsed * 1e6 / cpu_hz
+
+        if trace_id in (TRACE_ID_ISR_ENTER, TRACE_ID_ISR_EXIT):
+            isr = name_of(ISR_NAMES, arg8)
+            phase = "B" if trace_id == TRACE_ID_ISR_ENTER else "E"
+            events.append({"ph": phase, "pid": 0, "tid": TID_ISR, "ts": ts, "name": isr})
+            if trace_id == TRACE_ID_ISR_ENTER and arg8 == 0:
+                last_tim5_us = ts
+
+        elif trace_id == TRACE_ID_STATE:
+            events.append({"ph": "i", "s": "t", "pid": 0, "tid": TID_STATE, "ts": ts,
+                           "name": name_of(STATE_NAMES, arg8)})
+
+        elif trace_id == TRACE_ID_COMMAND:
+            events.append({"ph": "i", "s": "t", "pid": 0, "tid": TID_CONSOLE, "ts": ts,
+                           "name": name_of(COMMAND_NAMES, arg8)})
+
+        elif trace_id == TRACE_ID_DAC:
+            args = {"value": arg16}
+            if last_tim5_us is not None:
+                # TIM5 tick to magnet write, the jitter this recorder exists to show
+                args["since_tim5_us"] = round(ts - last_tim5_us, 3)
+            events.append({"ph": "C", "pid": 0, "ts": ts, "name": "dac", "args": {"value": arg16}})
+            events.append({"ph": "i", "s": "t", "pid": 0, "tid": TID_DAC, "ts": ts,
+                           "name": "write", "args": args})
+
+        else:
+            events.append({"ph": "i", "s": "t", "pid": 0, "tid": TID_ISR, "ts": ts,
+                           "name": "unknown id %d" % trace_id})
+
+    return {"traceEvents": events, "displayTimeUnit": "ns"}
+
+
+def main(argv):
+    if len(argv) != 3:
+        sys.stderr.write("usage: %s <dump.bin> <trace.json>\n" % argv[0])
+        return 2
+
+    with open(argv[1], "rb") as dump:
+        cpu_hz, overwritten, records = parse(dump.read())
+
+    if overwritten:
+        sys.stderr.write("note: %d older records were overwritten on the target\n" % overwritten)
+
+    with open(argv[2], "w") as out:
+        json.dump(convert(cpu_hz, records), out, indent=1)
+
+    sys.stdout.write("%d records written to %s\n" % (len(records), argv[2]))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main(sys.argv))